@@ -32,7 +32,7 @@ public class ComfyUI : ModuleRules
 
         if (Target.bBuildEditor)
         {
-            PrivateDependencyModuleNames.AddRange(new string[]{"UnrealEd"});
+            PrivateDependencyModuleNames.AddRange(new string[]{"UnrealEd", "DirectoryWatcher"});
         }
     }
 }
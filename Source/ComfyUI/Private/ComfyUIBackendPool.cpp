@@ -0,0 +1,312 @@
+#include "ComfyUIBackendPool.h"
+#include "ComfyUIClient.h"
+#include "ComfyUISettings.h"
+#include "ComfyUIWebSocketHandler.h"
+#include "Serialization/JsonSerializer.h"
+#include "HAL/PlatformTime.h"
+
+namespace
+{
+    constexpr double ProbeIntervalSeconds = 2.0;
+    constexpr float ProbeTimeoutSeconds = 2.0f;
+
+    // A pin is only needed until the prompt's results have been fetched
+    constexpr int32 MaxPinnedPrompts = 4096;
+
+    FString NormalizeUrl(const FString& Url)
+    {
+        FString Normalized = Url.TrimStartAndEnd();
+        Normalized.RemoveFromEnd(TEXT("/"));
+        return Normalized;
+    }
+
+    TSharedPtr<FJsonObject> ParseObject(const FString& Json)
+    {
+        TSharedPtr<FJsonObject> Root;
+        const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
+        return FJsonSerializer::Deserialize(Reader, Root) ? Root : nullptr;
+    }
+
+    int32 ParseQueueDepth(const FString& Json)
+    {
+        const TSharedPtr<FJsonObject> Root = ParseObject(Json);
+        if (!Root.IsValid())
+            return 0;
+
+        int32 Depth = 0;
+        const TArray<TSharedPtr<FJsonValue>>* Prompts;
+        if (Root->TryGetArrayField(TEXT("queue_running"), Prompts))
+            Depth += Prompts->Num();
+        if (Root->TryGetArrayField(TEXT("queue_pending"), Prompts))
+            Depth += Prompts->Num();
+        return Depth;
+    }
+
+    int64 ParseVramFree(const FString& Json)
+    {
+        const TSharedPtr<FJsonObject> Root = ParseObject(Json);
+        const TArray<TSharedPtr<FJsonValue>>* Devices;
+        if (!Root.IsValid() || !Root->TryGetArrayField(TEXT("devices"), Devices) || Devices->Num() == 0)
+            return 0;
+
+        const TSharedPtr<FJsonObject>* Device;
+        double VramFree = 0.0;
+        if ((*Devices)[0]->TryGetObject(Device))
+            (*Device)->TryGetNumberField(TEXT("vram_free"), VramFree);
+        return (int64)VramFree;
+    }
+}
+
+FComfyUIBackendPool::FComfyUIBackendPool(const TSharedRef<FComfyUIClient>& DefaultClient, const TSharedRef<FComfyUIWebSocketHandler>& DefaultWebSocket)
+{
+    Backends.Add(MakeShared<FComfyUIBackend>(DefaultClient, DefaultWebSocket));
+}
+
+const TArray<TSharedRef<FComfyUIBackend>>& FComfyUIBackendPool::GetBackends()
+{
+    SyncWithSettings();
+    return Backends;
+}
+
+void FComfyUIBackendPool::SelectBackend(FOnSelected OnSelected)
+{
+    SyncWithSettings();
+    if (Backends.Num() == 1)
+    {
+        OnSelected(Backends[0]);
+        return;
+    }
+
+    WaitingForProbe.Add(MoveTemp(OnSelected));
+    if (ProbesInFlight > 0)
+        return;     // served when the running probe lands
+
+    ProbeStaleBackends();
+    if (ProbesInFlight == 0)
+        ServeWaiting();
+}
+
+void FComfyUIBackendPool::SubmitPrompt(const FString& RequestBody, FOnSubmitted OnComplete)
+{
+    TWeakPtr<FComfyUIBackendPool> WeakThis = AsShared();
+    SelectBackend([WeakThis, RequestBody, OnComplete = MoveTemp(OnComplete)](const TSharedRef<FComfyUIBackend>& Backend) mutable
+    {
+        Backend->Client->PostPrompt(RequestBody,
+            [WeakThis, Backend, OnComplete = MoveTemp(OnComplete)](bool bOk, const FString& PromptId, const FString& ResponseJson)
+            {
+                TSharedPtr<FComfyUIBackendPool> Pool = WeakThis.Pin();
+                if (Pool.IsValid() && bOk && !PromptId.IsEmpty())
+                    Pool->PinPrompt(PromptId, Backend);
+
+                OnComplete(bOk, PromptId, ResponseJson, Backend);
+            });
+    });
+}
+
+void FComfyUIBackendPool::PinPrompt(const FString& PromptId, const TSharedRef<FComfyUIBackend>& Backend)
+{
+    if (PinnedPrompts.Contains(PromptId))
+        return;
+
+    PinnedPrompts.Add(PromptId, Backend);
+    PinOrder.Add(PromptId);
+
+    if (PinOrder.Num() > MaxPinnedPrompts)
+    {
+        const int32 NumToDrop = PinOrder.Num() - MaxPinnedPrompts / 2;
+        for (int32 Index = 0; Index < NumToDrop; ++Index)
+            PinnedPrompts.Remove(PinOrder[Index]);
+        PinOrder.RemoveAt(0, NumToDrop);
+    }
+}
+
+TSharedRef<FComfyUIBackend> FComfyUIBackendPool::GetBackendForPrompt(const FString& PromptId) const
+{
+    const TSharedRef<FComfyUIBackend>* Pinned = PinnedPrompts.Find(PromptId);
+    return Pinned ? *Pinned : Backends[0];
+}
+
+void FComfyUIBackendPool::Shutdown()
+{
+#if WITH_EDITOR
+    if (SettingsChangedHandle.IsValid() && UObjectInitialized())
+    {
+        if (UComfyUISettings* Settings = GetMutableDefault<UComfyUISettings>())
+            Settings->OnSettingChanged().Remove(SettingsChangedHandle);
+    }
+    SettingsChangedHandle.Reset();
+#endif
+
+    for (int32 Index = 1; Index < Backends.Num(); ++Index)
+        Backends[Index]->WebSocket->Disconnect();
+
+    // Backends removed from settings may still have been running pinned prompts
+    for (const TPair<FString, TSharedRef<FComfyUIBackend>>& Pin : PinnedPrompts)
+    {
+        if (Pin.Value != Backends[0])
+            Pin.Value->WebSocket->Disconnect();
+    }
+
+    PinnedPrompts.Reset();
+    PinOrder.Reset();
+    WaitingForProbe.Reset();
+}
+
+void FComfyUIBackendPool::SyncWithSettings()
+{
+    const UComfyUISettings* Settings = GetDefault<UComfyUISettings>();
+    const FString DefaultUrl = Backends[0]->Client->GetBaseUrl();
+
+#if WITH_EDITOR
+    // Subscribed on first use for the same reason the client resolves its URL lazily:
+    // the pool is created before the settings object can be touched
+    if (!SettingsChangedHandle.IsValid())
+    {
+        if (UComfyUISettings* MutableSettings = GetMutableDefault<UComfyUISettings>())
+            SettingsChangedHandle = MutableSettings->OnSettingChanged().AddSP(this, &FComfyUIBackendPool::OnSettingsChanged);
+    }
+#endif
+
+    // The default client follows Base URL by itself, but an open socket stays on the old
+    // server until told otherwise. Reopen it on the new one under the same client id.
+    const TSharedRef<FComfyUIWebSocketHandler>& DefaultSocket = Backends[0]->WebSocket;
+    if (DefaultSocket->WantsConnection())
+    {
+        const FString SocketUrl = Backends[0]->Client->GetWebSocketUrl(DefaultSocket->GetClientId());
+        if (SocketUrl != DefaultSocket->GetUrl())
+        {
+            UE_LOG(LogTemp, Log, TEXT("ComfyUI Backends: Base URL is now %s, moving its socket"), *DefaultUrl);
+            DefaultSocket->Connect(SocketUrl);
+            Backends[0]->LastProbeTime = -1.0;
+        }
+    }
+
+    TArray<FString> Urls;
+    if (Settings)
+    {
+        for (const FString& Url : Settings->AdditionalBackendUrls)
+        {
+            const FString Normalized = NormalizeUrl(Url);
+            if (!Normalized.IsEmpty() && Normalized != DefaultUrl)
+                Urls.AddUnique(Normalized);
+        }
+    }
+
+    if (Urls == ConfiguredUrls)
+        return;
+
+    // Backends still listed are kept so their sockets and probe history carry over.
+    // Dropped ones stay alive for as long as a pinned prompt references them.
+    TArray<TSharedRef<FComfyUIBackend>> NewBackends;
+    NewBackends.Add(Backends[0]);
+    for (const FString& Url : Urls)
+    {
+        const TSharedRef<FComfyUIBackend>* Existing = Backends.FindByPredicate(
+            [&Url](const TSharedRef<FComfyUIBackend>& Backend) { return Backend->Client->GetBaseUrl() == Url; });
+
+        if (Existing)
+        {
+            NewBackends.Add(*Existing);
+        }
+        else
+        {
+            TSharedRef<FComfyUIClient> Client = MakeShared<FComfyUIClient>(Url);
+            NewBackends.Add(MakeShared<FComfyUIBackend>(Client, MakeShared<FComfyUIWebSocketHandler>(Client)));
+        }
+    }
+
+    Backends = MoveTemp(NewBackends);
+    ConfiguredUrls = MoveTemp(Urls);
+    UE_LOG(LogTemp, Log, TEXT("ComfyUI Backends: Dispatching across %d server(s)"), Backends.Num());
+}
+
+void FComfyUIBackendPool::OnSettingsChanged(UObject* Settings, FPropertyChangedEvent& PropertyChangedEvent)
+{
+    // The client may not have seen this change yet; invalidating twice is harmless
+    Backends[0]->Client->InvalidateBaseUrl();
+    SyncWithSettings();
+}
+
+void FComfyUIBackendPool::ProbeStaleBackends()
+{
+    const double Now = FPlatformTime::Seconds();
+    TWeakPtr<FComfyUIBackendPool> WeakThis = AsShared();
+
+    for (const TSharedRef<FComfyUIBackend>& Backend : Backends)
+    {
+        if (Backend->LastProbeTime >= 0.0 && Now - Backend->LastProbeTime < ProbeIntervalSeconds)
+            continue;
+
+        Backend->LastProbeTime = Now;
+        Backend->DispatchedSinceProbe = 0;
+        Backend->bReachable = true;
+        ProbesInFlight += 2;
+
+        Backend->Client->GetQueue(
+            [WeakThis, Backend](bool bOk, const FString& Json)
+            {
+                if (bOk)
+                    Backend->QueueDepth = ParseQueueDepth(Json);
+                else
+                    Backend->bReachable = false;
+
+                if (TSharedPtr<FComfyUIBackendPool> Pool = WeakThis.Pin())
+                    Pool->OnProbeFinished();
+            },
+            ProbeTimeoutSeconds);
+
+        Backend->Client->GetSystemStats(
+            [WeakThis, Backend](bool bOk, const FString& Json)
+            {
+                if (bOk)
+                    Backend->VramFree = ParseVramFree(Json);
+                else
+                    Backend->bReachable = false;
+
+                if (TSharedPtr<FComfyUIBackendPool> Pool = WeakThis.Pin())
+                    Pool->OnProbeFinished();
+            },
+            ProbeTimeoutSeconds);
+    }
+}
+
+void FComfyUIBackendPool::OnProbeFinished()
+{
+    if (--ProbesInFlight == 0)
+        ServeWaiting();
+}
+
+void FComfyUIBackendPool::ServeWaiting()
+{
+    TArray<FOnSelected> Waiting = MoveTemp(WaitingForProbe);
+    for (FOnSelected& OnSelected : Waiting)
+    {
+        TSharedRef<FComfyUIBackend> Backend = PickLeastLoaded();
+        ++Backend->DispatchedSinceProbe;
+        OnSelected(Backend);
+    }
+}
+
+TSharedRef<FComfyUIBackend> FComfyUIBackendPool::PickLeastLoaded() const
+{
+    const FComfyUIBackend* Best = nullptr;
+    int32 BestIndex = 0;
+
+    for (int32 Index = 0; Index < Backends.Num(); ++Index)
+    {
+        const FComfyUIBackend& Backend = *Backends[Index];
+        if (!Backend.bReachable)
+            continue;
+
+        const int32 Load = Backend.QueueDepth + Backend.DispatchedSinceProbe;
+        const int32 BestLoad = Best ? Best->QueueDepth + Best->DispatchedSinceProbe : MAX_int32;
+        if (Load < BestLoad || (Load == BestLoad && Backend.VramFree > Best->VramFree))
+        {
+            Best = &Backend;
+            BestIndex = Index;
+        }
+    }
+
+    // Nothing answered: the default server is as good a guess as any
+    return Backends[BestIndex];
+}
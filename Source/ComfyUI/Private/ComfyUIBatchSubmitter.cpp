@@ -0,0 +1,430 @@
+#include "ComfyUIBatchSubmitter.h"
+#include "ComfyUIBackendPool.h"
+#include "ComfyUIBlueprintLibrary.h"
+#include "ComfyUIClient.h"
+#include "ComfyUIModule.h"
+#include "ComfyUIWebSocketHandler.h"
+#include "Dom/JsonObject.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+    // ComfyUI only appends to its queue on /prompt, so a small window is enough to
+    // hide the round trips without flooding the server with parallel validation
+    constexpr int32 MaxPostsInFlight = 4;
+
+    // How often variants the socket can't report are checked on /history
+    constexpr float HistoryPollIntervalSeconds = 2.0f;
+
+    FComfyTemplateValue MakeOverrideValue(const FComfyUIInputOverride& Override)
+    {
+        switch (Override.ValueType)
+        {
+        case EComfyUIInputValueType::Number:
+            return FComfyTemplateValue(Override.NumberValue);
+        case EComfyUIInputValueType::Bool:
+            return FComfyTemplateValue(Override.bBoolValue);
+        default:
+            return FComfyTemplateValue(Override.StringValue);
+        }
+    }
+}
+
+FComfyUIBatchSubmitter::FComfyUIBatchSubmitter(const TSharedPtr<FComfyUIClient>& InClient, const TSharedPtr<FComfyUIWebSocketHandler>& InWebSocketHandler)
+    : Client(InClient)
+    , WebSocketHandler(InWebSocketHandler)
+{
+}
+
+FComfyUIBatchSubmitter::FComfyUIBatchSubmitter(const TSharedRef<FComfyUIBackendPool>& InPool)
+    : Client(InPool->GetDefaultBackend()->Client)
+    , WebSocketHandler(InPool->GetDefaultBackend()->WebSocket)
+    , Pool(InPool)
+{
+}
+
+FComfyUIBatchSubmitter::~FComfyUIBatchSubmitter()
+{
+    StopPolling();
+}
+
+TSharedPtr<FComfyUIBatchSubmitter> FComfyUIBatchSubmitter::Submit(const FString& BaseWorkflowJson, const TArray<FComfyUIBatchVariant>& Variants,
+    const FString& ClientId, const FComfyUIBatchCompleteDelegateNative& OnComplete)
+{
+    FComfyUIModule* Module = FModuleManager::GetModulePtr<FComfyUIModule>(TEXT("ComfyUI"));
+    TSharedPtr<FComfyUIBackendPool> BackendPool = Module ? Module->GetBackendPool() : nullptr;
+    if (!BackendPool.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("ComfyUI Batch: Module not loaded"));
+        OnComplete.ExecuteIfBound(false, TArray<FComfyUIBatchItemResult>());
+        return nullptr;
+    }
+
+    TSharedRef<FComfyUIBatchSubmitter> Batch = MakeShared<FComfyUIBatchSubmitter>(BackendPool.ToSharedRef());
+    if (!Batch->Start(BaseWorkflowJson, Variants, ClientId, OnComplete))
+    {
+        return nullptr;
+    }
+    return Batch;
+}
+
+bool FComfyUIBatchSubmitter::Start(const FString& BaseWorkflowJson, const TArray<FComfyUIBatchVariant>& InVariants,
+    const FString& InClientId, const FComfyUIBatchCompleteDelegateNative& InOnComplete)
+{
+    OnComplete = InOnComplete;
+    ClientId = InClientId;
+
+    Variants = InVariants;
+
+    // Every input any variant overrides becomes a template slot; the graph is
+    // parsed and serialized once here and each variant is then spliced as text
+    TArray<FComfyTemplateSlot> Slots;
+    for (const FComfyUIBatchVariant& Variant : Variants)
+    {
+        for (const FComfyUIInputOverride& Override : Variant.Overrides)
+        {
+            Slots.AddUnique(FComfyTemplateSlot(Override.NodeId, Override.InputName));
+        }
+    }
+
+    if (!Client.IsValid() || !Template.Compile(BaseWorkflowJson, Slots))
+    {
+        UE_LOG(LogTemp, Error, TEXT("ComfyUI Batch: Invalid base workflow JSON"));
+        OnComplete.ExecuteIfBound(false, TArray<FComfyUIBatchItemResult>());
+        OnComplete.Unbind();
+        return false;
+    }
+
+    Results.SetNum(Variants.Num());
+    for (int32 Index = 0; Index < Results.Num(); ++Index)
+    {
+        Results[Index].VariantIndex = Index;
+    }
+    VariantClients.Init(Client, Variants.Num());
+    VariantSockets.Init(WebSocketHandler, Variants.Num());
+    CompletionSeen.Init(false, Variants.Num());
+    VariantFinished.Init(false, Variants.Num());
+    HistoryPollsInFlight.Init(false, Variants.Num());
+
+    StartTime = FPlatformTime::Seconds();
+    LastProgressTime = StartTime;
+    UE_LOG(LogTemp, Warning, TEXT("ComfyUI Batch: Queueing %d variant(s)"), Variants.Num());
+
+    if (Variants.Num() == 0)
+    {
+        OnComplete.ExecuteIfBound(true, Results);
+        OnComplete.Unbind();
+        return true;
+    }
+
+    // Also runs the timeout, so it starts before anything is queued
+    PollTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+        FTickerDelegate::CreateSP(this, &FComfyUIBatchSubmitter::PollHistory), HistoryPollIntervalSeconds);
+
+    PumpPosts();
+    return true;
+}
+
+void FComfyUIBatchSubmitter::PumpPosts()
+{
+    while (PostsInFlight < MaxPostsInFlight && NextVariant < Variants.Num())
+    {
+        const int32 Index = NextVariant++;
+        const FString RequestBody = BuildRequestBody(Variants[Index]);
+
+        ++PostsInFlight;
+        PostVariant(Index, RequestBody);
+    }
+}
+
+void FComfyUIBatchSubmitter::PostVariant(int32 Index, const FString& RequestBody)
+{
+    TSharedRef<FComfyUIBatchSubmitter> Self = AsShared();
+    if (!Pool.IsValid())
+    {
+        Client->PostPrompt(RequestBody,
+            [Self, Index](bool bSuccess, const FString& PromptId, const FString&)
+            {
+                Self->OnPromptQueued(Index, bSuccess, PromptId);
+            });
+        return;
+    }
+
+    Pool->SubmitPrompt(RequestBody,
+        [Self, Index](bool bSuccess, const FString& PromptId, const FString&, const TSharedRef<FComfyUIBackend>& Backend)
+        {
+            Self->VariantClients[Index] = Backend->Client;
+            Self->VariantSockets[Index] = Backend->WebSocket;
+            Self->OnPromptQueued(Index, bSuccess, PromptId);
+        });
+}
+
+FString FComfyUIBatchSubmitter::BuildRequestBody(const FComfyUIBatchVariant& Variant) const
+{
+    // Later overrides of the same input win, as they did when applied to the DOM in order
+    TArray<FComfyTemplateValue, TInlineAllocator<16>> Values;
+    Values.SetNum(Template.GetNumSlots());
+
+    for (const FComfyUIInputOverride& Override : Variant.Overrides)
+    {
+        const int32 SlotIndex = Template.FindSlot(Override.NodeId, Override.InputName);
+        if (SlotIndex == INDEX_NONE)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("ComfyUI Batch: Input %s.%s not found in base workflow, override skipped"),
+                *Override.NodeId, *Override.InputName);
+            continue;
+        }
+        Values[SlotIndex] = MakeOverrideValue(Override);
+    }
+
+    return Template.RenderRequestBody(Values, ClientId);
+}
+
+void FComfyUIBatchSubmitter::OnPromptQueued(int32 Index, bool bSuccess, const FString& PromptId)
+{
+    --PostsInFlight;
+    Results[Index].PromptId = PromptId;
+
+    if (VariantFinished[Index])
+    {
+        // Cancelled or timed out while the POST was out
+        return;
+    }
+    LastProgressTime = FPlatformTime::Seconds();
+
+    const TSharedPtr<FComfyUIWebSocketHandler>& Socket = VariantSockets[Index];
+    if (!bSuccess || PromptId.IsEmpty() || !Socket.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("ComfyUI Batch: Variant %d was not queued"), Index);
+        FinishVariant(Index, false);
+    }
+    else
+    {
+        TSharedRef<FComfyUIBatchSubmitter> Self = AsShared();
+        FComfyUIWorkflowCompleteDelegateNative Watcher;
+        Watcher.BindLambda([Self, Index](bool bPromptSuccess, const FString&)
+        {
+            Self->OnPromptFinished(Index, bPromptSuccess);
+        });
+        Socket->WatchPrompt(PromptId, Watcher);
+
+        // Completion arrives over the socket; the handler reconciles anything that
+        // finished before it connected. A socket someone else opened under another
+        // client id never hears about this prompt, so the poller covers that case.
+        if (!Socket->IsConnected() && Socket->GetClientId().IsEmpty())
+            Socket->Connect(VariantClients[Index]->GetWebSocketUrl(ClientId));
+    }
+
+    PumpPosts();
+}
+
+void FComfyUIBatchSubmitter::OnPromptFinished(int32 Index, bool bSuccess)
+{
+    // The socket and the poller can both report the same prompt
+    if (CompletionSeen[Index])
+        return;
+    CompletionSeen[Index] = true;
+
+    if (VariantSockets[Index].IsValid())
+        VariantSockets[Index]->UnwatchPrompt(Results[Index].PromptId);
+
+    if (!bSuccess)
+    {
+        FinishVariant(Index, false);
+        return;
+    }
+
+    TSharedRef<FComfyUIBatchSubmitter> Self = AsShared();
+    const FString PromptId = Results[Index].PromptId;
+    VariantClients[Index]->GetOutputs(PromptId,
+        [Self, Index](bool bHistoryOk, const TArray<FComfyUIOutputImage>& Images)
+        {
+            if (Self->VariantFinished[Index])
+                return;
+
+            // Preview nodes also list "temp" images; only saved outputs are results
+            for (const FComfyUIOutputImage& Image : Images)
+            {
+                if (Image.Type == TEXT("output"))
+                    Self->Results[Index].Images.Add(Image);
+            }
+
+            Self->FinishVariant(Index, bHistoryOk);
+        });
+}
+
+void FComfyUIBatchSubmitter::FinishVariant(int32 Index, bool bSuccess)
+{
+    if (VariantFinished[Index])
+        return;
+    VariantFinished[Index] = true;
+    LastProgressTime = FPlatformTime::Seconds();
+
+    Results[Index].bSuccess = bSuccess;
+    if (++NumFinished < Variants.Num())
+    {
+        return;
+    }
+
+    StopPolling();
+
+    bool bAllSucceeded = true;
+    const FString OutputFolder = UComfyUIBlueprintLibrary::GetComfyUIOutputFolder();
+    for (int32 ResultIndex = 0; ResultIndex < Results.Num(); ++ResultIndex)
+    {
+        FComfyUIBatchItemResult& Result = Results[ResultIndex];
+        bAllSucceeded &= Result.bSuccess;
+
+        // The local output folder only mirrors the Base URL server; images from other
+        // backends exist only there and are fetched through /view
+        if (!OutputFolder.IsEmpty() && VariantClients[ResultIndex] == Client)
+        {
+            for (const FComfyUIOutputImage& Image : Result.Images)
+            {
+                Result.OutputPaths.Add(Image.Subfolder.IsEmpty()
+                    ? FPaths::Combine(OutputFolder, Image.Filename)
+                    : FPaths::Combine(OutputFolder, Image.Subfolder, Image.Filename));
+            }
+        }
+    }
+
+    UE_LOG(LogTemp, Warning, TEXT("ComfyUI Batch: %d variant(s) finished in %.1fs (%s)"),
+        Variants.Num(), FPlatformTime::Seconds() - StartTime, bAllSucceeded ? TEXT("all succeeded") : TEXT("with failures"));
+
+    FComfyUIBatchCompleteDelegateNative Callback = MoveTemp(OnComplete);
+    OnComplete.Unbind();
+    Callback.ExecuteIfBound(bAllSucceeded, Results);
+}
+
+void FComfyUIBatchSubmitter::Cancel()
+{
+    if (IsFinished())
+        return;
+
+    UE_LOG(LogTemp, Warning, TEXT("ComfyUI Batch: Cancelled with %d of %d variant(s) unfinished"), Variants.Num() - NumFinished, Variants.Num());
+    FailUnfinishedVariants();
+}
+
+void FComfyUIBatchSubmitter::FailUnfinishedVariants()
+{
+    // The completion callback may drop the last outside reference
+    TSharedRef<FComfyUIBatchSubmitter> Self = AsShared();
+
+    // Variants not posted yet are never sent
+    NextVariant = Variants.Num();
+
+    for (int32 Index = 0; Index < Variants.Num(); ++Index)
+    {
+        if (VariantFinished[Index])
+            continue;
+
+        // Drops the watcher's reference to this submitter
+        CompletionSeen[Index] = true;
+        if (VariantSockets[Index].IsValid() && !Results[Index].PromptId.IsEmpty())
+            VariantSockets[Index]->UnwatchPrompt(Results[Index].PromptId);
+
+        FinishVariant(Index, false);
+    }
+}
+
+bool FComfyUIBatchSubmitter::IsReportedBySocket(int32 Index) const
+{
+    const TSharedPtr<FComfyUIWebSocketHandler>& Socket = VariantSockets[Index];
+    return Socket.IsValid()
+        && Socket->IsTrackingPrompt(Results[Index].PromptId)
+        && Socket->GetClientId() == ClientId;
+}
+
+bool FComfyUIBatchSubmitter::PollHistory(float DeltaTime)
+{
+    if (TimeoutSeconds > 0.0f && FPlatformTime::Seconds() - LastProgressTime > TimeoutSeconds)
+    {
+        UE_LOG(LogTemp, Error, TEXT("ComfyUI Batch: No progress for %.0fs, failing %d unfinished variant(s)"),
+            TimeoutSeconds, Variants.Num() - NumFinished);
+        FailUnfinishedVariants();
+        return false;
+    }
+
+    // One /queue per server covers all of its variants
+    TMap<TSharedPtr<FComfyUIClient>, TArray<int32>> ToCheck;
+    for (int32 Index = 0; Index < NextVariant; ++Index)
+    {
+        if (Results[Index].PromptId.IsEmpty() || CompletionSeen[Index] || HistoryPollsInFlight[Index] || IsReportedBySocket(Index))
+            continue;
+
+        HistoryPollsInFlight[Index] = true;
+        ToCheck.FindOrAdd(VariantClients[Index]).Add(Index);
+    }
+
+    TSharedRef<FComfyUIBatchSubmitter> Self = AsShared();
+    for (const TPair<TSharedPtr<FComfyUIClient>, TArray<int32>>& Pair : ToCheck)
+    {
+        Pair.Key->GetQueue(
+            [Self, VariantClient = Pair.Key, Indices = Pair.Value](bool bSuccess, const FString& QueueJson)
+            {
+                Self->ApplyPollQueue(VariantClient, Indices, bSuccess, QueueJson);
+            });
+    }
+
+    // Keep ticking until the batch completes
+    return true;
+}
+
+void FComfyUIBatchSubmitter::ApplyPollQueue(const TSharedPtr<FComfyUIClient>& VariantClient, const TArray<int32>& Indices, bool bSuccess, const FString& QueueJson)
+{
+    TSet<FString> Queued;
+    const bool bParsed = bSuccess && FComfyUIClient::ExtractQueuedPromptIds(QueueJson, Queued);
+
+    TSharedRef<FComfyUIBatchSubmitter> Self = AsShared();
+    for (int32 Index : Indices)
+    {
+        if (!bParsed || CompletionSeen[Index] || Queued.Contains(Results[Index].PromptId))
+        {
+            // Unreachable server or still queued; try again next tick
+            HistoryPollsInFlight[Index] = false;
+            continue;
+        }
+
+        // Asked after /queue, so a prompt that left the queue in between has its entry by now
+        VariantClient->GetHistory(Results[Index].PromptId,
+            [Self, Index](bool bHistoryOk, const TSharedPtr<FJsonObject>& History)
+            {
+                Self->ApplyPollHistory(Index, bHistoryOk, History);
+            });
+    }
+}
+
+void FComfyUIBatchSubmitter::ApplyPollHistory(int32 Index, bool bSuccess, const TSharedPtr<FJsonObject>& History)
+{
+    HistoryPollsInFlight[Index] = false;
+    if (!bSuccess || CompletionSeen[Index])
+        return;
+
+    const FString& PromptId = Results[Index].PromptId;
+    const TSharedPtr<FJsonObject>* Entry;
+    if (!History->TryGetObjectField(PromptId, Entry))
+    {
+        UE_LOG(LogTemp, Error, TEXT("ComfyUI Batch: Variant %d (prompt %s) is neither queued nor in /history, failing it"), Index, *PromptId);
+        OnPromptFinished(Index, false);
+        return;
+    }
+
+    // Servers that predate "status" only write the entry once the prompt has run
+    FString StatusStr = TEXT("success");
+    const TSharedPtr<FJsonObject>* Status;
+    if ((*Entry)->TryGetObjectField(TEXT("status"), Status))
+        (*Status)->TryGetStringField(TEXT("status_str"), StatusStr);
+
+    UE_LOG(LogTemp, Warning, TEXT("ComfyUI Batch: Variant %d finished per /history (%s)"), Index, *StatusStr);
+    OnPromptFinished(Index, StatusStr == TEXT("success"));
+}
+
+void FComfyUIBatchSubmitter::StopPolling()
+{
+    if (PollTickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(PollTickerHandle);
+        PollTickerHandle.Reset();
+    }
+}
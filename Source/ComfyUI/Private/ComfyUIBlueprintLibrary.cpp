@@ -1,24 +1,30 @@
 #include "ComfyUIBlueprintLibrary.h"
+#include "ComfyUIBackendPool.h"
+#include "ComfyUIBatchSubmitter.h"
 #include "ComfyUIModule.h"
+#include "ComfyUIClient.h"
+#include "ComfyUIImageUtils.h"
+#include "ComfyUIOutputIndex.h"
 #include "ComfyUISettings.h"
 #include "ComfyUIWebSocketHandler.h"
-#include "HttpModule.h"
-#include "Interfaces/IHttpRequest.h"
-#include "Interfaces/IHttpResponse.h"
+#include "ComfyUIWorkflowTemplate.h"
 #include "Serialization/JsonSerializer.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
-#include "IImageWrapper.h"
-#include "IImageWrapperModule.h"
 #include "Engine/Texture2D.h"
 #include "TextureResource.h"
 #include "TimerManager.h"
 #include "Engine/Engine.h"
+#include "LatentActions.h"
 #include "Interfaces/IPluginManager.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
 
 #if WITH_EDITOR
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "Factories/TextureFactory.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
 #include "EditorFramework/AssetImportData.h"
 #endif
 
@@ -59,20 +65,31 @@ namespace
         Node->GetObjectField(TEXT("inputs"))->SetArrayField(Key, LinkArray);
     }
 
-    void EnsureWebSocketConnected()
+    TSharedPtr<FComfyUIClient> GetClient()
+    {
+        FComfyUIModule* Module = FModuleManager::GetModulePtr<FComfyUIModule>(TEXT("ComfyUI"));
+        return Module ? Module->GetClient() : nullptr;
+    }
+
+    TSharedPtr<FComfyUIBackendPool> GetBackendPool()
+    {
+        FComfyUIModule* Module = FModuleManager::GetModulePtr<FComfyUIModule>(TEXT("ComfyUI"));
+        return Module ? Module->GetBackendPool() : nullptr;
+    }
+
+    /** Socket of the server PromptId was dispatched to, connected if it wasn't already */
+    TSharedPtr<FComfyUIWebSocketHandler> ConnectWebSocketForPrompt(const FString& PromptId)
     {
-        if (FComfyUIModule* Module = FModuleManager::GetModulePtr<FComfyUIModule>(TEXT("ComfyUI")))
+        TSharedPtr<FComfyUIBackendPool> Pool = GetBackendPool();
+        if (!Pool.IsValid())
+            return nullptr;
+
+        const TSharedRef<FComfyUIBackend> Backend = Pool->GetBackendForPrompt(PromptId);
+        if (!Backend->WebSocket->IsConnected())
         {
-            TSharedPtr<FComfyUIWebSocketHandler> WSHandler = Module->GetWebSocketHandler();
-            if (WSHandler.IsValid() && !WSHandler->IsConnected())
-            {
-                const UComfyUISettings* Settings = GetDefault<UComfyUISettings>();
-                FString BaseUrl = Settings ? Settings->BaseUrl : TEXT("http://127.0.0.1:8188");
-                FString WsUrl = BaseUrl.Replace(TEXT("http://"), TEXT("ws://")).Replace(TEXT("https://"), TEXT("wss://"));
-                WsUrl += TEXT("/ws");
-                WSHandler->Connect(WsUrl);
-            }
+            Backend->WebSocket->Connect(Backend->Client->GetWebSocketUrl());
         }
+        return Backend->WebSocket;
     }
 }
 
@@ -82,6 +99,10 @@ namespace
 
 FString UComfyUIBlueprintLibrary::GetBaseUrl()
 {
+    if (TSharedPtr<FComfyUIClient> Client = GetClient())
+    {
+        return Client->GetBaseUrl();
+    }
     const UComfyUISettings* Settings = GetDefault<UComfyUISettings>();
     return Settings ? Settings->BaseUrl : TEXT("http://127.0.0.1:8188");
 }
@@ -121,16 +142,18 @@ bool UComfyUIBlueprintLibrary::EnsurePortableRunning()
 
 void UComfyUIBlueprintLibrary::CheckComfyUIReady(const FComfyUIResponseDelegate& OnComplete)
 {
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-    Request->SetURL(GetBaseUrl() + TEXT("/system_stats"));
-    Request->SetVerb(TEXT("GET"));
-    Request->OnProcessRequestComplete().BindLambda(
-        [OnComplete](FHttpRequestPtr, FHttpResponsePtr Response, bool bSucceeded)
+    TSharedPtr<FComfyUIClient> Client = GetClient();
+    if (!Client.IsValid())
+    {
+        OnComplete.ExecuteIfBound(false, TEXT("{\"error\":\"module not loaded\"}"));
+        return;
+    }
+
+    Client->GetSystemStats(
+        [OnComplete](bool bOk, const FString& ResponseJson)
         {
-            const bool bOk = bSucceeded && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode());
-            OnComplete.ExecuteIfBound(bOk, bOk ? Response->GetContentAsString() : TEXT("{\"error\":\"not ready\"}"));
+            OnComplete.ExecuteIfBound(bOk, bOk ? ResponseJson : TEXT("{\"error\":\"not ready\"}"));
         });
-    Request->ProcessRequest();
 }
 
 void UComfyUIBlueprintLibrary::WaitForComfyUIReady(float TimeoutSeconds, const FComfyUIResponseDelegate& OnComplete)
@@ -147,13 +170,17 @@ void UComfyUIBlueprintLibrary::PollComfyUIReady(float TimeoutSeconds, float Elap
         return;
     }
 
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-    Request->SetURL(GetBaseUrl() + TEXT("/system_stats"));
-    Request->SetVerb(TEXT("GET"));
-    Request->OnProcessRequestComplete().BindLambda(
-        [TimeoutSeconds, ElapsedTime, OnComplete](FHttpRequestPtr, FHttpResponsePtr Response, bool bSucceeded)
+    TSharedPtr<FComfyUIClient> Client = GetClient();
+    if (!Client.IsValid())
+    {
+        OnComplete.ExecuteIfBound(false, TEXT("{\"error\":\"module not loaded\"}"));
+        return;
+    }
+
+    Client->GetSystemStats(
+        [TimeoutSeconds, ElapsedTime, OnComplete](bool bOk, const FString&)
         {
-            if (bSucceeded && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+            if (bOk)
             {
                 UE_LOG(LogTemp, Warning, TEXT("ComfyUI: Ready!"));
                 OnComplete.ExecuteIfBound(true, TEXT("{\"status\":\"ready\"}"));
@@ -181,7 +208,6 @@ void UComfyUIBlueprintLibrary::PollComfyUIReady(float TimeoutSeconds, float Elap
                 }
             }
         });
-    Request->ProcessRequest();
 }
 
 // ============================================================================
@@ -202,20 +228,34 @@ void UComfyUIBlueprintLibrary::SubmitWorkflowJson(const FString& WorkflowJson, c
 
     FString RequestBody = BuildPromptWrapperJson(PromptObject, Options.ClientId);
 
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-    Request->SetURL(GetBaseUrl() + TEXT("/prompt"));
-    Request->SetVerb(TEXT("POST"));
-    Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
-    Request->SetContentAsString(RequestBody);
+    TSharedPtr<FComfyUIBackendPool> Pool = GetBackendPool();
+    if (!Pool.IsValid())
+    {
+        OnComplete.ExecuteIfBound(false, TEXT("{\"error\":\"module not loaded\"}"));
+        return;
+    }
 
-    Request->OnProcessRequestComplete().BindLambda(
-        [OnComplete](FHttpRequestPtr, FHttpResponsePtr Response, bool bSucceeded)
+    // The prompt id is pinned to the chosen server, so watching it and fetching its outputs follow it there
+    Pool->SubmitPrompt(RequestBody,
+        [OnComplete](bool bOk, const FString&, const FString& ResponseJson, const TSharedRef<FComfyUIBackend>&)
         {
-            const bool bOk = bSucceeded && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode());
-            const FString ResponseText = Response.IsValid() ? Response->GetContentAsString() : TEXT("{\"error\":\"no response\"}");
-            OnComplete.ExecuteIfBound(bOk, ResponseText);
+            OnComplete.ExecuteIfBound(bOk, ResponseJson.IsEmpty() ? TEXT("{\"error\":\"no response\"}") : ResponseJson);
         });
-    Request->ProcessRequest();
+}
+
+void UComfyUIBlueprintLibrary::SubmitWorkflowBatch(const FString& BaseWorkflowJson, const TArray<FComfyUIBatchVariant>& Variants,
+    const FComfyUISubmitOptions& Options, const FComfyUIBatchCompleteDelegate& OnComplete)
+{
+    TryEnsurePortable();
+
+    // Bridge from native delegate to dynamic delegate
+    FComfyUIBatchCompleteDelegateNative NativeDelegate;
+    NativeDelegate.BindLambda([OnComplete](bool bAllSucceeded, const TArray<FComfyUIBatchItemResult>& Results)
+    {
+        OnComplete.ExecuteIfBound(bAllSucceeded, Results);
+    });
+
+    FComfyUIBatchSubmitter::Submit(BaseWorkflowJson, Variants, Options.ClientId, NativeDelegate);
 }
 
 // ============================================================================
@@ -278,7 +318,7 @@ FString UComfyUIBlueprintLibrary::BuildSimpleWorkflowJson(const FComfyUISimpleWo
     auto LatentNode = MakeNode(TEXT("EmptyLatentImage"));
     SetInputNumber(LatentNode, TEXT("width"), Params.Width);
     SetInputNumber(LatentNode, TEXT("height"), Params.Height);
-    SetInputNumber(LatentNode, TEXT("batch_size"), 1);
+    SetInputNumber(LatentNode, TEXT("batch_size"), FMath::Clamp(Params.BatchSize, 1, 64));
     Graph->SetObjectField(FString::FromInt(LatentId), LatentNode);
 
     // KSampler
@@ -372,7 +412,7 @@ FString UComfyUIBlueprintLibrary::BuildFlux2WorkflowJson(const FComfyUIFlux2Work
     auto LatentNode = MakeNode(TEXT("EmptyFlux2LatentImage"));
     SetInputNumber(LatentNode, TEXT("width"), Params.Width);
     SetInputNumber(LatentNode, TEXT("height"), Params.Height);
-    SetInputNumber(LatentNode, TEXT("batch_size"), 1);
+    SetInputNumber(LatentNode, TEXT("batch_size"), FMath::Clamp(Params.BatchSize, 1, 64));
     Graph->SetObjectField(FString::FromInt(LatentId), LatentNode);
 
     /// RandomNoise
@@ -428,336 +468,442 @@ FString UComfyUIBlueprintLibrary::BuildFlux2WorkflowJson(const FComfyUIFlux2Work
     return OutputString;
 }
 
-FString UComfyUIBlueprintLibrary::BuildQwenGenerateWorkflowJson(const FComfyUIQwenGenerateParams& Params)
+// ============================================================================
+// Qwen Workflow Templates
+// ============================================================================
+
+namespace
 {
-    // Load the template as a string and parse it
-    TSharedPtr<FJsonObject> Root = MakeShared<FJsonObject>();
-
-    // --- Node 245: UNETLoader ---
-    TSharedPtr<FJsonObject> Node245 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node245Inputs = MakeShared<FJsonObject>();
-    Node245Inputs->SetStringField(TEXT("unet_name"), Params.UnetName);
-    Node245Inputs->SetStringField(TEXT("weight_dtype"), TEXT("default"));
-    Node245->SetObjectField(TEXT("inputs"), Node245Inputs);
-    Node245->SetStringField(TEXT("class_type"), TEXT("UNETLoader"));
-    Root->SetObjectField(TEXT("245"), Node245);
-
-    // --- Node 246: CLIPLoader ---
-    TSharedPtr<FJsonObject> Node246 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node246Inputs = MakeShared<FJsonObject>();
-    Node246Inputs->SetStringField(TEXT("clip_name"), Params.ClipName);
-    Node246Inputs->SetStringField(TEXT("type"), TEXT("qwen_image"));
-    Node246Inputs->SetStringField(TEXT("device"), TEXT("default"));
-    Node246->SetObjectField(TEXT("inputs"), Node246Inputs);
-    Node246->SetStringField(TEXT("class_type"), TEXT("CLIPLoader"));
-    Root->SetObjectField(TEXT("246"), Node246);
-
-    // --- Node 247: VAELoader ---
-    TSharedPtr<FJsonObject> Node247 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node247Inputs = MakeShared<FJsonObject>();
-    Node247Inputs->SetStringField(TEXT("vae_name"), Params.VaeName);
-    Node247->SetObjectField(TEXT("inputs"), Node247Inputs);
-    Node247->SetStringField(TEXT("class_type"), TEXT("VAELoader"));
-    Root->SetObjectField(TEXT("247"), Node247);
-
-    // --- Node 248: EmptySD3LatentImage ---
-    TSharedPtr<FJsonObject> Node248 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node248Inputs = MakeShared<FJsonObject>();
-    Node248Inputs->SetNumberField(TEXT("width"), Params.Width);
-    Node248Inputs->SetNumberField(TEXT("height"), Params.Height);
-    Node248Inputs->SetNumberField(TEXT("batch_size"), 1);
-    Node248->SetObjectField(TEXT("inputs"), Node248Inputs);
-    Node248->SetStringField(TEXT("class_type"), TEXT("EmptySD3LatentImage"));
-    Root->SetObjectField(TEXT("248"), Node248);
-
-    // --- Node 249: CLIPTextEncode (Positive) ---
-    TSharedPtr<FJsonObject> Node249 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node249Inputs = MakeShared<FJsonObject>();
-    Node249Inputs->SetStringField(TEXT("text"), Params.PositivePrompt);
-    TArray<TSharedPtr<FJsonValue>> Clip249Val;
-    Clip249Val.Add(MakeShared<FJsonValueString>(TEXT("246")));
-    Clip249Val.Add(MakeShared<FJsonValueNumber>(0));
-    Node249Inputs->SetArrayField(TEXT("clip"), Clip249Val);
-    Node249->SetObjectField(TEXT("inputs"), Node249Inputs);
-    Node249->SetStringField(TEXT("class_type"), TEXT("CLIPTextEncode"));
-    Root->SetObjectField(TEXT("249"), Node249);
-
-    // --- Node 250: CLIPTextEncode (Negative) --- empty for Qwen
-    TSharedPtr<FJsonObject> Node250 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node250Inputs = MakeShared<FJsonObject>();
-    Node250Inputs->SetStringField(TEXT("text"), TEXT(""));
-    TArray<TSharedPtr<FJsonValue>> Clip250Val;
-    Clip250Val.Add(MakeShared<FJsonValueString>(TEXT("246")));
-    Clip250Val.Add(MakeShared<FJsonValueNumber>(0));
-    Node250Inputs->SetArrayField(TEXT("clip"), Clip250Val);
-    Node250->SetObjectField(TEXT("inputs"), Node250Inputs);
-    Node250->SetStringField(TEXT("class_type"), TEXT("CLIPTextEncode"));
-    Root->SetObjectField(TEXT("250"), Node250);
-
-    // --- Node 251: PrimitiveInt (Steps) ---
-    TSharedPtr<FJsonObject> Node251 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node251Inputs = MakeShared<FJsonObject>();
-    Node251Inputs->SetNumberField(TEXT("value"), Params.Steps);
-    Node251->SetObjectField(TEXT("inputs"), Node251Inputs);
-    Node251->SetStringField(TEXT("class_type"), TEXT("PrimitiveInt"));
-    Root->SetObjectField(TEXT("251"), Node251);
-
-    // --- Node 252: PrimitiveFloat (CFG) ---
-    TSharedPtr<FJsonObject> Node252 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node252Inputs = MakeShared<FJsonObject>();
-    Node252Inputs->SetNumberField(TEXT("value"), Params.CFGScale);
-    Node252->SetObjectField(TEXT("inputs"), Node252Inputs);
-    Node252->SetStringField(TEXT("class_type"), TEXT("PrimitiveFloat"));
-    Root->SetObjectField(TEXT("252"), Node252);
-
-    // --- Node 260: ModelSamplingAuraFlow (Shift) ---
-    TSharedPtr<FJsonObject> Node260 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node260Inputs = MakeShared<FJsonObject>();
-    Node260Inputs->SetNumberField(TEXT("shift"), Params.Shift);
-    TArray<TSharedPtr<FJsonValue>> Model260Val;
-    Model260Val.Add(MakeShared<FJsonValueString>(TEXT("245")));
-    Model260Val.Add(MakeShared<FJsonValueNumber>(0));
-    Node260Inputs->SetArrayField(TEXT("model"), Model260Val);
-    Node260->SetObjectField(TEXT("inputs"), Node260Inputs);
-    Node260->SetStringField(TEXT("class_type"), TEXT("ModelSamplingAuraFlow"));
-    Root->SetObjectField(TEXT("260"), Node260);
-
-    // --- Node 261: KSampler ---
-    TSharedPtr<FJsonObject> Node261 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node261Inputs = MakeShared<FJsonObject>();
-    int32 ActualSeed = Params.Seed < 0 ? FMath::Rand() : Params.Seed;
-    Node261Inputs->SetNumberField(TEXT("seed"), ActualSeed);
-    TArray<TSharedPtr<FJsonValue>> StepsRef, CfgRef, ModelRef, PosRef, NegRef, LatentRef;
-    StepsRef.Add(MakeShared<FJsonValueString>(TEXT("251"))); StepsRef.Add(MakeShared<FJsonValueNumber>(0));
-    CfgRef.Add(MakeShared<FJsonValueString>(TEXT("252")));   CfgRef.Add(MakeShared<FJsonValueNumber>(0));
-    ModelRef.Add(MakeShared<FJsonValueString>(TEXT("260"))); ModelRef.Add(MakeShared<FJsonValueNumber>(0));
-    PosRef.Add(MakeShared<FJsonValueString>(TEXT("249")));   PosRef.Add(MakeShared<FJsonValueNumber>(0));
-    NegRef.Add(MakeShared<FJsonValueString>(TEXT("250")));   NegRef.Add(MakeShared<FJsonValueNumber>(0));
-    LatentRef.Add(MakeShared<FJsonValueString>(TEXT("248"))); LatentRef.Add(MakeShared<FJsonValueNumber>(0));
-    Node261Inputs->SetArrayField(TEXT("steps"), StepsRef);
-    Node261Inputs->SetArrayField(TEXT("cfg"), CfgRef);
-    Node261Inputs->SetStringField(TEXT("sampler_name"), Params.Sampler);
-    Node261Inputs->SetStringField(TEXT("scheduler"), Params.Scheduler);
-    Node261Inputs->SetNumberField(TEXT("denoise"), 1.0);
-    Node261Inputs->SetArrayField(TEXT("model"), ModelRef);
-    Node261Inputs->SetArrayField(TEXT("positive"), PosRef);
-    Node261Inputs->SetArrayField(TEXT("negative"), NegRef);
-    Node261Inputs->SetArrayField(TEXT("latent_image"), LatentRef);
-    Node261->SetObjectField(TEXT("inputs"), Node261Inputs);
-    Node261->SetStringField(TEXT("class_type"), TEXT("KSampler"));
-    Root->SetObjectField(TEXT("261"), Node261);
-
-    // --- Node 262: VAEDecode ---
-    TSharedPtr<FJsonObject> Node262 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node262Inputs = MakeShared<FJsonObject>();
-    TArray<TSharedPtr<FJsonValue>> Samples262, Vae262;
-    Samples262.Add(MakeShared<FJsonValueString>(TEXT("261"))); Samples262.Add(MakeShared<FJsonValueNumber>(0));
-    Vae262.Add(MakeShared<FJsonValueString>(TEXT("247")));     Vae262.Add(MakeShared<FJsonValueNumber>(0));
-    Node262Inputs->SetArrayField(TEXT("samples"), Samples262);
-    Node262Inputs->SetArrayField(TEXT("vae"), Vae262);
-    Node262->SetObjectField(TEXT("inputs"), Node262Inputs);
-    Node262->SetStringField(TEXT("class_type"), TEXT("VAEDecode"));
-    Root->SetObjectField(TEXT("262"), Node262);
-
-    // --- Node 60: SaveImage ---
-    TSharedPtr<FJsonObject> Node60 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node60Inputs = MakeShared<FJsonObject>();
-    Node60Inputs->SetStringField(TEXT("filename_prefix"), Params.FilenamePrefix);
-    TArray<TSharedPtr<FJsonValue>> Images60;
-    Images60.Add(MakeShared<FJsonValueString>(TEXT("262"))); Images60.Add(MakeShared<FJsonValueNumber>(0));
-    Node60Inputs->SetArrayField(TEXT("images"), Images60);
-    Node60->SetObjectField(TEXT("inputs"), Node60Inputs);
-    Node60->SetStringField(TEXT("class_type"), TEXT("SaveImage"));
-    Root->SetObjectField(TEXT("60"), Node60);
-
-    // Serialize
-    FString OutputJson;
-    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutputJson);
-    FJsonSerializer::Serialize(Root.ToSharedRef(), Writer);
-    return OutputJson;
+    // The Qwen graphs have a fixed shape, so each is built as a DOM once and
+    // compiled into a template; every later call only splices in the parameters
+
+    TSharedRef<FJsonObject> MakeQwenGenerateGraph(const FComfyUIQwenGenerateParams& Params)
+    {
+        TSharedPtr<FJsonObject> Root = MakeShared<FJsonObject>();
+
+        // --- Node 245: UNETLoader ---
+        TSharedPtr<FJsonObject> Node245 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node245Inputs = MakeShared<FJsonObject>();
+        Node245Inputs->SetStringField(TEXT("unet_name"), Params.UnetName);
+        Node245Inputs->SetStringField(TEXT("weight_dtype"), TEXT("default"));
+        Node245->SetObjectField(TEXT("inputs"), Node245Inputs);
+        Node245->SetStringField(TEXT("class_type"), TEXT("UNETLoader"));
+        Root->SetObjectField(TEXT("245"), Node245);
+
+        // --- Node 246: CLIPLoader ---
+        TSharedPtr<FJsonObject> Node246 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node246Inputs = MakeShared<FJsonObject>();
+        Node246Inputs->SetStringField(TEXT("clip_name"), Params.ClipName);
+        Node246Inputs->SetStringField(TEXT("type"), TEXT("qwen_image"));
+        Node246Inputs->SetStringField(TEXT("device"), TEXT("default"));
+        Node246->SetObjectField(TEXT("inputs"), Node246Inputs);
+        Node246->SetStringField(TEXT("class_type"), TEXT("CLIPLoader"));
+        Root->SetObjectField(TEXT("246"), Node246);
+
+        // --- Node 247: VAELoader ---
+        TSharedPtr<FJsonObject> Node247 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node247Inputs = MakeShared<FJsonObject>();
+        Node247Inputs->SetStringField(TEXT("vae_name"), Params.VaeName);
+        Node247->SetObjectField(TEXT("inputs"), Node247Inputs);
+        Node247->SetStringField(TEXT("class_type"), TEXT("VAELoader"));
+        Root->SetObjectField(TEXT("247"), Node247);
+
+        // --- Node 248: EmptySD3LatentImage ---
+        TSharedPtr<FJsonObject> Node248 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node248Inputs = MakeShared<FJsonObject>();
+        Node248Inputs->SetNumberField(TEXT("width"), Params.Width);
+        Node248Inputs->SetNumberField(TEXT("height"), Params.Height);
+        Node248Inputs->SetNumberField(TEXT("batch_size"), FMath::Clamp(Params.BatchSize, 1, 64));
+        Node248->SetObjectField(TEXT("inputs"), Node248Inputs);
+        Node248->SetStringField(TEXT("class_type"), TEXT("EmptySD3LatentImage"));
+        Root->SetObjectField(TEXT("248"), Node248);
+
+        // --- Node 249: CLIPTextEncode (Positive) ---
+        TSharedPtr<FJsonObject> Node249 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node249Inputs = MakeShared<FJsonObject>();
+        Node249Inputs->SetStringField(TEXT("text"), Params.PositivePrompt);
+        TArray<TSharedPtr<FJsonValue>> Clip249Val;
+        Clip249Val.Add(MakeShared<FJsonValueString>(TEXT("246")));
+        Clip249Val.Add(MakeShared<FJsonValueNumber>(0));
+        Node249Inputs->SetArrayField(TEXT("clip"), Clip249Val);
+        Node249->SetObjectField(TEXT("inputs"), Node249Inputs);
+        Node249->SetStringField(TEXT("class_type"), TEXT("CLIPTextEncode"));
+        Root->SetObjectField(TEXT("249"), Node249);
+
+        // --- Node 250: CLIPTextEncode (Negative) --- empty for Qwen
+        TSharedPtr<FJsonObject> Node250 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node250Inputs = MakeShared<FJsonObject>();
+        Node250Inputs->SetStringField(TEXT("text"), TEXT(""));
+        TArray<TSharedPtr<FJsonValue>> Clip250Val;
+        Clip250Val.Add(MakeShared<FJsonValueString>(TEXT("246")));
+        Clip250Val.Add(MakeShared<FJsonValueNumber>(0));
+        Node250Inputs->SetArrayField(TEXT("clip"), Clip250Val);
+        Node250->SetObjectField(TEXT("inputs"), Node250Inputs);
+        Node250->SetStringField(TEXT("class_type"), TEXT("CLIPTextEncode"));
+        Root->SetObjectField(TEXT("250"), Node250);
+
+        // --- Node 251: PrimitiveInt (Steps) ---
+        TSharedPtr<FJsonObject> Node251 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node251Inputs = MakeShared<FJsonObject>();
+        Node251Inputs->SetNumberField(TEXT("value"), Params.Steps);
+        Node251->SetObjectField(TEXT("inputs"), Node251Inputs);
+        Node251->SetStringField(TEXT("class_type"), TEXT("PrimitiveInt"));
+        Root->SetObjectField(TEXT("251"), Node251);
+
+        // --- Node 252: PrimitiveFloat (CFG) ---
+        TSharedPtr<FJsonObject> Node252 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node252Inputs = MakeShared<FJsonObject>();
+        Node252Inputs->SetNumberField(TEXT("value"), Params.CFGScale);
+        Node252->SetObjectField(TEXT("inputs"), Node252Inputs);
+        Node252->SetStringField(TEXT("class_type"), TEXT("PrimitiveFloat"));
+        Root->SetObjectField(TEXT("252"), Node252);
+
+        // --- Node 260: ModelSamplingAuraFlow (Shift) ---
+        TSharedPtr<FJsonObject> Node260 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node260Inputs = MakeShared<FJsonObject>();
+        Node260Inputs->SetNumberField(TEXT("shift"), Params.Shift);
+        TArray<TSharedPtr<FJsonValue>> Model260Val;
+        Model260Val.Add(MakeShared<FJsonValueString>(TEXT("245")));
+        Model260Val.Add(MakeShared<FJsonValueNumber>(0));
+        Node260Inputs->SetArrayField(TEXT("model"), Model260Val);
+        Node260->SetObjectField(TEXT("inputs"), Node260Inputs);
+        Node260->SetStringField(TEXT("class_type"), TEXT("ModelSamplingAuraFlow"));
+        Root->SetObjectField(TEXT("260"), Node260);
+
+        // --- Node 261: KSampler ---
+        TSharedPtr<FJsonObject> Node261 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node261Inputs = MakeShared<FJsonObject>();
+        int32 ActualSeed = Params.Seed < 0 ? FMath::Rand() : Params.Seed;
+        Node261Inputs->SetNumberField(TEXT("seed"), ActualSeed);
+        TArray<TSharedPtr<FJsonValue>> StepsRef, CfgRef, ModelRef, PosRef, NegRef, LatentRef;
+        StepsRef.Add(MakeShared<FJsonValueString>(TEXT("251"))); StepsRef.Add(MakeShared<FJsonValueNumber>(0));
+        CfgRef.Add(MakeShared<FJsonValueString>(TEXT("252")));   CfgRef.Add(MakeShared<FJsonValueNumber>(0));
+        ModelRef.Add(MakeShared<FJsonValueString>(TEXT("260"))); ModelRef.Add(MakeShared<FJsonValueNumber>(0));
+        PosRef.Add(MakeShared<FJsonValueString>(TEXT("249")));   PosRef.Add(MakeShared<FJsonValueNumber>(0));
+        NegRef.Add(MakeShared<FJsonValueString>(TEXT("250")));   NegRef.Add(MakeShared<FJsonValueNumber>(0));
+        LatentRef.Add(MakeShared<FJsonValueString>(TEXT("248"))); LatentRef.Add(MakeShared<FJsonValueNumber>(0));
+        Node261Inputs->SetArrayField(TEXT("steps"), StepsRef);
+        Node261Inputs->SetArrayField(TEXT("cfg"), CfgRef);
+        Node261Inputs->SetStringField(TEXT("sampler_name"), Params.Sampler);
+        Node261Inputs->SetStringField(TEXT("scheduler"), Params.Scheduler);
+        Node261Inputs->SetNumberField(TEXT("denoise"), 1.0);
+        Node261Inputs->SetArrayField(TEXT("model"), ModelRef);
+        Node261Inputs->SetArrayField(TEXT("positive"), PosRef);
+        Node261Inputs->SetArrayField(TEXT("negative"), NegRef);
+        Node261Inputs->SetArrayField(TEXT("latent_image"), LatentRef);
+        Node261->SetObjectField(TEXT("inputs"), Node261Inputs);
+        Node261->SetStringField(TEXT("class_type"), TEXT("KSampler"));
+        Root->SetObjectField(TEXT("261"), Node261);
+
+        // --- Node 262: VAEDecode ---
+        TSharedPtr<FJsonObject> Node262 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node262Inputs = MakeShared<FJsonObject>();
+        TArray<TSharedPtr<FJsonValue>> Samples262, Vae262;
+        Samples262.Add(MakeShared<FJsonValueString>(TEXT("261"))); Samples262.Add(MakeShared<FJsonValueNumber>(0));
+        Vae262.Add(MakeShared<FJsonValueString>(TEXT("247")));     Vae262.Add(MakeShared<FJsonValueNumber>(0));
+        Node262Inputs->SetArrayField(TEXT("samples"), Samples262);
+        Node262Inputs->SetArrayField(TEXT("vae"), Vae262);
+        Node262->SetObjectField(TEXT("inputs"), Node262Inputs);
+        Node262->SetStringField(TEXT("class_type"), TEXT("VAEDecode"));
+        Root->SetObjectField(TEXT("262"), Node262);
+
+        // --- Node 60: SaveImage ---
+        TSharedPtr<FJsonObject> Node60 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node60Inputs = MakeShared<FJsonObject>();
+        Node60Inputs->SetStringField(TEXT("filename_prefix"), Params.FilenamePrefix);
+        TArray<TSharedPtr<FJsonValue>> Images60;
+        Images60.Add(MakeShared<FJsonValueString>(TEXT("262"))); Images60.Add(MakeShared<FJsonValueNumber>(0));
+        Node60Inputs->SetArrayField(TEXT("images"), Images60);
+        Node60->SetObjectField(TEXT("inputs"), Node60Inputs);
+        Node60->SetStringField(TEXT("class_type"), TEXT("SaveImage"));
+        Root->SetObjectField(TEXT("60"), Node60);
+
+        return Root.ToSharedRef();
+    }
+
+    TSharedRef<FJsonObject> MakeQwenEditGraph(const FComfyUIQwenEditParams& Params)
+    {
+        TSharedPtr<FJsonObject> Root = MakeShared<FJsonObject>();
+
+        // --- Node 41: LoadImage (source) ---
+        TSharedPtr<FJsonObject> Node41 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node41Inputs = MakeShared<FJsonObject>();
+        Node41Inputs->SetStringField(TEXT("image"), Params.InputImageFilename);
+        Node41->SetObjectField(TEXT("inputs"), Node41Inputs);
+        Node41->SetStringField(TEXT("class_type"), TEXT("LoadImage"));
+        Root->SetObjectField(TEXT("41"), Node41);
+
+        // --- Node 171: FluxKontextImageScale ---
+        TSharedPtr<FJsonObject> Node171 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node171Inputs = MakeShared<FJsonObject>();
+        TArray<TSharedPtr<FJsonValue>> Image171;
+        Image171.Add(MakeShared<FJsonValueString>(TEXT("41"))); Image171.Add(MakeShared<FJsonValueNumber>(0));
+        Node171Inputs->SetArrayField(TEXT("image"), Image171);
+        Node171->SetObjectField(TEXT("inputs"), Node171Inputs);
+        Node171->SetStringField(TEXT("class_type"), TEXT("FluxKontextImageScale"));
+        Root->SetObjectField(TEXT("171"), Node171);
+
+        // --- Node 172: VAELoader ---
+        TSharedPtr<FJsonObject> Node172 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node172Inputs = MakeShared<FJsonObject>();
+        Node172Inputs->SetStringField(TEXT("vae_name"), Params.VaeName);
+        Node172->SetObjectField(TEXT("inputs"), Node172Inputs);
+        Node172->SetStringField(TEXT("class_type"), TEXT("VAELoader"));
+        Root->SetObjectField(TEXT("172"), Node172);
+
+        // --- Node 173: CLIPLoader ---
+        TSharedPtr<FJsonObject> Node173 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node173Inputs = MakeShared<FJsonObject>();
+        Node173Inputs->SetStringField(TEXT("clip_name"), Params.ClipName);
+        Node173Inputs->SetStringField(TEXT("type"), TEXT("qwen_image"));
+        Node173Inputs->SetStringField(TEXT("device"), TEXT("default"));
+        Node173->SetObjectField(TEXT("inputs"), Node173Inputs);
+        Node173->SetStringField(TEXT("class_type"), TEXT("CLIPLoader"));
+        Root->SetObjectField(TEXT("173"), Node173);
+
+        // --- Node 174: UNETLoader ---
+        TSharedPtr<FJsonObject> Node174 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node174Inputs = MakeShared<FJsonObject>();
+        Node174Inputs->SetStringField(TEXT("unet_name"), Params.UnetName);
+        Node174Inputs->SetStringField(TEXT("weight_dtype"), TEXT("default"));
+        Node174->SetObjectField(TEXT("inputs"), Node174Inputs);
+        Node174->SetStringField(TEXT("class_type"), TEXT("UNETLoader"));
+        Root->SetObjectField(TEXT("174"), Node174);
+
+        // Helper lambdas for node refs
+        auto MakeRef = [](const FString& NodeId, int32 Output) {
+            TArray<TSharedPtr<FJsonValue>> Ref;
+            Ref.Add(MakeShared<FJsonValueString>(NodeId));
+            Ref.Add(MakeShared<FJsonValueNumber>(Output));
+            return Ref;
+            };
+
+        // --- Node 175: TextEncodeQwenImageEditPlus (Positive) ---
+        TSharedPtr<FJsonObject> Node175 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node175Inputs = MakeShared<FJsonObject>();
+        Node175Inputs->SetStringField(TEXT("prompt"), Params.Instruction);
+        Node175Inputs->SetArrayField(TEXT("clip"), MakeRef(TEXT("173"), 0));
+        Node175Inputs->SetArrayField(TEXT("vae"), MakeRef(TEXT("172"), 0));
+        Node175Inputs->SetArrayField(TEXT("image1"), MakeRef(TEXT("171"), 0));
+        Node175->SetObjectField(TEXT("inputs"), Node175Inputs);
+        Node175->SetStringField(TEXT("class_type"), TEXT("TextEncodeQwenImageEditPlus"));
+        Root->SetObjectField(TEXT("175"), Node175);
+
+        // --- Node 176: TextEncodeQwenImageEditPlus (Negative) --- empty prompt
+        TSharedPtr<FJsonObject> Node176 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node176Inputs = MakeShared<FJsonObject>();
+        Node176Inputs->SetStringField(TEXT("prompt"), TEXT(""));
+        Node176Inputs->SetArrayField(TEXT("clip"), MakeRef(TEXT("173"), 0));
+        Node176Inputs->SetArrayField(TEXT("vae"), MakeRef(TEXT("172"), 0));
+        Node176Inputs->SetArrayField(TEXT("image1"), MakeRef(TEXT("171"), 0));
+        Node176->SetObjectField(TEXT("inputs"), Node176Inputs);
+        Node176->SetStringField(TEXT("class_type"), TEXT("TextEncodeQwenImageEditPlus"));
+        Root->SetObjectField(TEXT("176"), Node176);
+
+        // --- Node 177: ModelSamplingAuraFlow (Shift) ---
+        TSharedPtr<FJsonObject> Node177 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node177Inputs = MakeShared<FJsonObject>();
+        Node177Inputs->SetNumberField(TEXT("shift"), Params.Shift);
+        Node177Inputs->SetArrayField(TEXT("model"), MakeRef(TEXT("174"), 0));
+        Node177->SetObjectField(TEXT("inputs"), Node177Inputs);
+        Node177->SetStringField(TEXT("class_type"), TEXT("ModelSamplingAuraFlow"));
+        Root->SetObjectField(TEXT("177"), Node177);
+
+        // --- Node 178: CFGNorm ---
+        TSharedPtr<FJsonObject> Node178 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node178Inputs = MakeShared<FJsonObject>();
+        Node178Inputs->SetNumberField(TEXT("strength"), 1.0);
+        Node178Inputs->SetArrayField(TEXT("model"), MakeRef(TEXT("177"), 0));
+        Node178->SetObjectField(TEXT("inputs"), Node178Inputs);
+        Node178->SetStringField(TEXT("class_type"), TEXT("CFGNorm"));
+        Root->SetObjectField(TEXT("178"), Node178);
+
+        // --- Node 179: FluxKontextMultiReferenceLatentMethod (Positive) ---
+        TSharedPtr<FJsonObject> Node179 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node179Inputs = MakeShared<FJsonObject>();
+        Node179Inputs->SetStringField(TEXT("reference_latents_method"), TEXT("index_timestep_zero"));
+        Node179Inputs->SetArrayField(TEXT("conditioning"), MakeRef(TEXT("175"), 0));
+        Node179->SetObjectField(TEXT("inputs"), Node179Inputs);
+        Node179->SetStringField(TEXT("class_type"), TEXT("FluxKontextMultiReferenceLatentMethod"));
+        Root->SetObjectField(TEXT("179"), Node179);
+
+        // --- Node 180: FluxKontextMultiReferenceLatentMethod (Negative) ---
+        TSharedPtr<FJsonObject> Node180 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node180Inputs = MakeShared<FJsonObject>();
+        Node180Inputs->SetStringField(TEXT("reference_latents_method"), TEXT("index_timestep_zero"));
+        Node180Inputs->SetArrayField(TEXT("conditioning"), MakeRef(TEXT("176"), 0));
+        Node180->SetObjectField(TEXT("inputs"), Node180Inputs);
+        Node180->SetStringField(TEXT("class_type"), TEXT("FluxKontextMultiReferenceLatentMethod"));
+        Root->SetObjectField(TEXT("180"), Node180);
+
+        // --- Node 181: PrimitiveInt (Steps) ---
+        TSharedPtr<FJsonObject> Node181 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node181Inputs = MakeShared<FJsonObject>();
+        Node181Inputs->SetNumberField(TEXT("value"), Params.Steps);
+        Node181->SetObjectField(TEXT("inputs"), Node181Inputs);
+        Node181->SetStringField(TEXT("class_type"), TEXT("PrimitiveInt"));
+        Root->SetObjectField(TEXT("181"), Node181);
+
+        // --- Node 182: PrimitiveFloat (CFG) ---
+        TSharedPtr<FJsonObject> Node182 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node182Inputs = MakeShared<FJsonObject>();
+        Node182Inputs->SetNumberField(TEXT("value"), Params.CFGScale);
+        Node182->SetObjectField(TEXT("inputs"), Node182Inputs);
+        Node182->SetStringField(TEXT("class_type"), TEXT("PrimitiveFloat"));
+        Root->SetObjectField(TEXT("182"), Node182);
+
+        // --- Node 183: KSampler ---
+        TSharedPtr<FJsonObject> Node183 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node183Inputs = MakeShared<FJsonObject>();
+        int32 ActualSeed = Params.Seed < 0 ? FMath::Rand() : Params.Seed;
+        Node183Inputs->SetNumberField(TEXT("seed"), ActualSeed);
+        Node183Inputs->SetArrayField(TEXT("steps"), MakeRef(TEXT("181"), 0));
+        Node183Inputs->SetArrayField(TEXT("cfg"), MakeRef(TEXT("182"), 0));
+        Node183Inputs->SetStringField(TEXT("sampler_name"), Params.Sampler);
+        Node183Inputs->SetStringField(TEXT("scheduler"), Params.Scheduler);
+        Node183Inputs->SetNumberField(TEXT("denoise"), 1.0);
+        Node183Inputs->SetArrayField(TEXT("model"), MakeRef(TEXT("178"), 0));
+        Node183Inputs->SetArrayField(TEXT("positive"), MakeRef(TEXT("179"), 0));
+        Node183Inputs->SetArrayField(TEXT("negative"), MakeRef(TEXT("180"), 0));
+        Node183Inputs->SetArrayField(TEXT("latent_image"), MakeRef(TEXT("186"), 0));
+        Node183->SetObjectField(TEXT("inputs"), Node183Inputs);
+        Node183->SetStringField(TEXT("class_type"), TEXT("KSampler"));
+        Root->SetObjectField(TEXT("183"), Node183);
+
+        // --- Node 184: VAEDecode ---
+        TSharedPtr<FJsonObject> Node184 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node184Inputs = MakeShared<FJsonObject>();
+        Node184Inputs->SetArrayField(TEXT("samples"), MakeRef(TEXT("183"), 0));
+        Node184Inputs->SetArrayField(TEXT("vae"), MakeRef(TEXT("172"), 0));
+        Node184->SetObjectField(TEXT("inputs"), Node184Inputs);
+        Node184->SetStringField(TEXT("class_type"), TEXT("VAEDecode"));
+        Root->SetObjectField(TEXT("184"), Node184);
+
+        // --- Node 186: VAEEncode ---
+        TSharedPtr<FJsonObject> Node186 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node186Inputs = MakeShared<FJsonObject>();
+        Node186Inputs->SetArrayField(TEXT("pixels"), MakeRef(TEXT("171"), 0));
+        Node186->SetObjectField(TEXT("inputs"), Node186Inputs);
+        Node186->SetStringField(TEXT("class_type"), TEXT("VAEEncode"));
+        Root->SetObjectField(TEXT("186"), Node186);
+
+        // --- Node 9: SaveImage ---
+        TSharedPtr<FJsonObject> Node9 = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> Node9Inputs = MakeShared<FJsonObject>();
+        Node9Inputs->SetStringField(TEXT("filename_prefix"), Params.FilenamePrefix);
+        Node9Inputs->SetArrayField(TEXT("images"), MakeRef(TEXT("184"), 0));
+        Node9->SetObjectField(TEXT("inputs"), Node9Inputs);
+        Node9->SetStringField(TEXT("class_type"), TEXT("SaveImage"));
+        Root->SetObjectField(TEXT("9"), Node9);
+
+        return Root.ToSharedRef();
+    }
+
+    enum EQwenGenerateSlot
+    {
+        QG_Unet, QG_Clip, QG_Vae, QG_Width, QG_Height, QG_BatchSize, QG_Prompt,
+        QG_Steps, QG_CFG, QG_Shift, QG_Seed, QG_Sampler, QG_Scheduler, QG_FilenamePrefix,
+        QG_Num
+    };
+
+    const FComfyWorkflowTemplate& GetQwenGenerateTemplate()
+    {
+        static const FComfyWorkflowTemplate Template = []()
+        {
+            TArray<FComfyTemplateSlot> Slots;
+            Slots.SetNum(QG_Num);
+            Slots[QG_Unet]           = { TEXT("245"), TEXT("unet_name") };
+            Slots[QG_Clip]           = { TEXT("246"), TEXT("clip_name") };
+            Slots[QG_Vae]            = { TEXT("247"), TEXT("vae_name") };
+            Slots[QG_Width]          = { TEXT("248"), TEXT("width") };
+            Slots[QG_Height]         = { TEXT("248"), TEXT("height") };
+            Slots[QG_BatchSize]      = { TEXT("248"), TEXT("batch_size") };
+            Slots[QG_Prompt]         = { TEXT("249"), TEXT("text") };
+            Slots[QG_Steps]          = { TEXT("251"), TEXT("value") };
+            Slots[QG_CFG]            = { TEXT("252"), TEXT("value") };
+            Slots[QG_Shift]          = { TEXT("260"), TEXT("shift") };
+            Slots[QG_Seed]           = { TEXT("261"), TEXT("seed") };
+            Slots[QG_Sampler]        = { TEXT("261"), TEXT("sampler_name") };
+            Slots[QG_Scheduler]      = { TEXT("261"), TEXT("scheduler") };
+            Slots[QG_FilenamePrefix] = { TEXT("60"), TEXT("filename_prefix") };
+
+            FComfyWorkflowTemplate Compiled;
+            Compiled.Compile(MakeQwenGenerateGraph(FComfyUIQwenGenerateParams()), Slots);
+            return Compiled;
+        }();
+        return Template;
+    }
+
+    enum EQwenEditSlot
+    {
+        QE_Image, QE_Vae, QE_Clip, QE_Unet, QE_Instruction, QE_Shift, QE_Steps,
+        QE_CFG, QE_Seed, QE_Sampler, QE_Scheduler, QE_FilenamePrefix,
+        QE_Num
+    };
+
+    const FComfyWorkflowTemplate& GetQwenEditTemplate()
+    {
+        static const FComfyWorkflowTemplate Template = []()
+        {
+            TArray<FComfyTemplateSlot> Slots;
+            Slots.SetNum(QE_Num);
+            Slots[QE_Image]          = { TEXT("41"), TEXT("image") };
+            Slots[QE_Vae]            = { TEXT("172"), TEXT("vae_name") };
+            Slots[QE_Clip]           = { TEXT("173"), TEXT("clip_name") };
+            Slots[QE_Unet]           = { TEXT("174"), TEXT("unet_name") };
+            Slots[QE_Instruction]    = { TEXT("175"), TEXT("prompt") };
+            Slots[QE_Shift]          = { TEXT("177"), TEXT("shift") };
+            Slots[QE_Steps]          = { TEXT("181"), TEXT("value") };
+            Slots[QE_CFG]            = { TEXT("182"), TEXT("value") };
+            Slots[QE_Seed]           = { TEXT("183"), TEXT("seed") };
+            Slots[QE_Sampler]        = { TEXT("183"), TEXT("sampler_name") };
+            Slots[QE_Scheduler]      = { TEXT("183"), TEXT("scheduler") };
+            Slots[QE_FilenamePrefix] = { TEXT("9"), TEXT("filename_prefix") };
+
+            FComfyWorkflowTemplate Compiled;
+            Compiled.Compile(MakeQwenEditGraph(FComfyUIQwenEditParams()), Slots);
+            return Compiled;
+        }();
+        return Template;
+    }
 }
 
+FString UComfyUIBlueprintLibrary::BuildQwenGenerateWorkflowJson(const FComfyUIQwenGenerateParams& Params)
+{
+    FComfyTemplateValue Values[QG_Num];
+    Values[QG_Unet]           = Params.UnetName;
+    Values[QG_Clip]           = Params.ClipName;
+    Values[QG_Vae]            = Params.VaeName;
+    Values[QG_Width]          = Params.Width;
+    Values[QG_Height]         = Params.Height;
+    Values[QG_BatchSize]      = FMath::Clamp(Params.BatchSize, 1, 64);
+    Values[QG_Prompt]         = Params.PositivePrompt;
+    Values[QG_Steps]          = Params.Steps;
+    Values[QG_CFG]            = (double)Params.CFGScale;
+    Values[QG_Shift]          = (double)Params.Shift;
+    Values[QG_Seed]           = Params.Seed < 0 ? FMath::Rand() : Params.Seed;
+    Values[QG_Sampler]        = Params.Sampler;
+    Values[QG_Scheduler]      = Params.Scheduler;
+    Values[QG_FilenamePrefix] = Params.FilenamePrefix;
+    return GetQwenGenerateTemplate().Render(Values);
+}
 
 FString UComfyUIBlueprintLibrary::BuildQwenEditWorkflowJson(const FComfyUIQwenEditParams& Params)
 {
-    TSharedPtr<FJsonObject> Root = MakeShared<FJsonObject>();
-
-    // --- Node 41: LoadImage (source) ---
-    TSharedPtr<FJsonObject> Node41 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node41Inputs = MakeShared<FJsonObject>();
-    Node41Inputs->SetStringField(TEXT("image"), Params.InputImageFilename);
-    Node41->SetObjectField(TEXT("inputs"), Node41Inputs);
-    Node41->SetStringField(TEXT("class_type"), TEXT("LoadImage"));
-    Root->SetObjectField(TEXT("41"), Node41);
-
-    // --- Node 171: FluxKontextImageScale ---
-    TSharedPtr<FJsonObject> Node171 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node171Inputs = MakeShared<FJsonObject>();
-    TArray<TSharedPtr<FJsonValue>> Image171;
-    Image171.Add(MakeShared<FJsonValueString>(TEXT("41"))); Image171.Add(MakeShared<FJsonValueNumber>(0));
-    Node171Inputs->SetArrayField(TEXT("image"), Image171);
-    Node171->SetObjectField(TEXT("inputs"), Node171Inputs);
-    Node171->SetStringField(TEXT("class_type"), TEXT("FluxKontextImageScale"));
-    Root->SetObjectField(TEXT("171"), Node171);
-
-    // --- Node 172: VAELoader ---
-    TSharedPtr<FJsonObject> Node172 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node172Inputs = MakeShared<FJsonObject>();
-    Node172Inputs->SetStringField(TEXT("vae_name"), Params.VaeName);
-    Node172->SetObjectField(TEXT("inputs"), Node172Inputs);
-    Node172->SetStringField(TEXT("class_type"), TEXT("VAELoader"));
-    Root->SetObjectField(TEXT("172"), Node172);
-
-    // --- Node 173: CLIPLoader ---
-    TSharedPtr<FJsonObject> Node173 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node173Inputs = MakeShared<FJsonObject>();
-    Node173Inputs->SetStringField(TEXT("clip_name"), Params.ClipName);
-    Node173Inputs->SetStringField(TEXT("type"), TEXT("qwen_image"));
-    Node173Inputs->SetStringField(TEXT("device"), TEXT("default"));
-    Node173->SetObjectField(TEXT("inputs"), Node173Inputs);
-    Node173->SetStringField(TEXT("class_type"), TEXT("CLIPLoader"));
-    Root->SetObjectField(TEXT("173"), Node173);
-
-    // --- Node 174: UNETLoader ---
-    TSharedPtr<FJsonObject> Node174 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node174Inputs = MakeShared<FJsonObject>();
-    Node174Inputs->SetStringField(TEXT("unet_name"), Params.UnetName);
-    Node174Inputs->SetStringField(TEXT("weight_dtype"), TEXT("default"));
-    Node174->SetObjectField(TEXT("inputs"), Node174Inputs);
-    Node174->SetStringField(TEXT("class_type"), TEXT("UNETLoader"));
-    Root->SetObjectField(TEXT("174"), Node174);
-
-    // Helper lambdas for node refs
-    auto MakeRef = [](const FString& NodeId, int32 Output) {
-        TArray<TSharedPtr<FJsonValue>> Ref;
-        Ref.Add(MakeShared<FJsonValueString>(NodeId));
-        Ref.Add(MakeShared<FJsonValueNumber>(Output));
-        return Ref;
-        };
-
-    // --- Node 175: TextEncodeQwenImageEditPlus (Positive) ---
-    TSharedPtr<FJsonObject> Node175 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node175Inputs = MakeShared<FJsonObject>();
-    Node175Inputs->SetStringField(TEXT("prompt"), Params.Instruction);
-    Node175Inputs->SetArrayField(TEXT("clip"), MakeRef(TEXT("173"), 0));
-    Node175Inputs->SetArrayField(TEXT("vae"), MakeRef(TEXT("172"), 0));
-    Node175Inputs->SetArrayField(TEXT("image1"), MakeRef(TEXT("171"), 0));
-    Node175->SetObjectField(TEXT("inputs"), Node175Inputs);
-    Node175->SetStringField(TEXT("class_type"), TEXT("TextEncodeQwenImageEditPlus"));
-    Root->SetObjectField(TEXT("175"), Node175);
-
-    // --- Node 176: TextEncodeQwenImageEditPlus (Negative) --- empty prompt
-    TSharedPtr<FJsonObject> Node176 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node176Inputs = MakeShared<FJsonObject>();
-    Node176Inputs->SetStringField(TEXT("prompt"), TEXT(""));
-    Node176Inputs->SetArrayField(TEXT("clip"), MakeRef(TEXT("173"), 0));
-    Node176Inputs->SetArrayField(TEXT("vae"), MakeRef(TEXT("172"), 0));
-    Node176Inputs->SetArrayField(TEXT("image1"), MakeRef(TEXT("171"), 0));
-    Node176->SetObjectField(TEXT("inputs"), Node176Inputs);
-    Node176->SetStringField(TEXT("class_type"), TEXT("TextEncodeQwenImageEditPlus"));
-    Root->SetObjectField(TEXT("176"), Node176);
-
-    // --- Node 177: ModelSamplingAuraFlow (Shift) ---
-    TSharedPtr<FJsonObject> Node177 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node177Inputs = MakeShared<FJsonObject>();
-    Node177Inputs->SetNumberField(TEXT("shift"), Params.Shift);
-    Node177Inputs->SetArrayField(TEXT("model"), MakeRef(TEXT("174"), 0));
-    Node177->SetObjectField(TEXT("inputs"), Node177Inputs);
-    Node177->SetStringField(TEXT("class_type"), TEXT("ModelSamplingAuraFlow"));
-    Root->SetObjectField(TEXT("177"), Node177);
-
-    // --- Node 178: CFGNorm ---
-    TSharedPtr<FJsonObject> Node178 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node178Inputs = MakeShared<FJsonObject>();
-    Node178Inputs->SetNumberField(TEXT("strength"), 1.0);
-    Node178Inputs->SetArrayField(TEXT("model"), MakeRef(TEXT("177"), 0));
-    Node178->SetObjectField(TEXT("inputs"), Node178Inputs);
-    Node178->SetStringField(TEXT("class_type"), TEXT("CFGNorm"));
-    Root->SetObjectField(TEXT("178"), Node178);
-
-    // --- Node 179: FluxKontextMultiReferenceLatentMethod (Positive) ---
-    TSharedPtr<FJsonObject> Node179 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node179Inputs = MakeShared<FJsonObject>();
-    Node179Inputs->SetStringField(TEXT("reference_latents_method"), TEXT("index_timestep_zero"));
-    Node179Inputs->SetArrayField(TEXT("conditioning"), MakeRef(TEXT("175"), 0));
-    Node179->SetObjectField(TEXT("inputs"), Node179Inputs);
-    Node179->SetStringField(TEXT("class_type"), TEXT("FluxKontextMultiReferenceLatentMethod"));
-    Root->SetObjectField(TEXT("179"), Node179);
-
-    // --- Node 180: FluxKontextMultiReferenceLatentMethod (Negative) ---
-    TSharedPtr<FJsonObject> Node180 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node180Inputs = MakeShared<FJsonObject>();
-    Node180Inputs->SetStringField(TEXT("reference_latents_method"), TEXT("index_timestep_zero"));
-    Node180Inputs->SetArrayField(TEXT("conditioning"), MakeRef(TEXT("176"), 0));
-    Node180->SetObjectField(TEXT("inputs"), Node180Inputs);
-    Node180->SetStringField(TEXT("class_type"), TEXT("FluxKontextMultiReferenceLatentMethod"));
-    Root->SetObjectField(TEXT("180"), Node180);
-
-    // --- Node 181: PrimitiveInt (Steps) ---
-    TSharedPtr<FJsonObject> Node181 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node181Inputs = MakeShared<FJsonObject>();
-    Node181Inputs->SetNumberField(TEXT("value"), Params.Steps);
-    Node181->SetObjectField(TEXT("inputs"), Node181Inputs);
-    Node181->SetStringField(TEXT("class_type"), TEXT("PrimitiveInt"));
-    Root->SetObjectField(TEXT("181"), Node181);
-
-    // --- Node 182: PrimitiveFloat (CFG) ---
-    TSharedPtr<FJsonObject> Node182 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node182Inputs = MakeShared<FJsonObject>();
-    Node182Inputs->SetNumberField(TEXT("value"), Params.CFGScale);
-    Node182->SetObjectField(TEXT("inputs"), Node182Inputs);
-    Node182->SetStringField(TEXT("class_type"), TEXT("PrimitiveFloat"));
-    Root->SetObjectField(TEXT("182"), Node182);
-
-    // --- Node 183: KSampler ---
-    TSharedPtr<FJsonObject> Node183 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node183Inputs = MakeShared<FJsonObject>();
-    int32 ActualSeed = Params.Seed < 0 ? FMath::Rand() : Params.Seed;
-    Node183Inputs->SetNumberField(TEXT("seed"), ActualSeed);
-    Node183Inputs->SetArrayField(TEXT("steps"), MakeRef(TEXT("181"), 0));
-    Node183Inputs->SetArrayField(TEXT("cfg"), MakeRef(TEXT("182"), 0));
-    Node183Inputs->SetStringField(TEXT("sampler_name"), Params.Sampler);
-    Node183Inputs->SetStringField(TEXT("scheduler"), Params.Scheduler);
-    Node183Inputs->SetNumberField(TEXT("denoise"), 1.0);
-    Node183Inputs->SetArrayField(TEXT("model"), MakeRef(TEXT("178"), 0));
-    Node183Inputs->SetArrayField(TEXT("positive"), MakeRef(TEXT("179"), 0));
-    Node183Inputs->SetArrayField(TEXT("negative"), MakeRef(TEXT("180"), 0));
-    Node183Inputs->SetArrayField(TEXT("latent_image"), MakeRef(TEXT("186"), 0));
-    Node183->SetObjectField(TEXT("inputs"), Node183Inputs);
-    Node183->SetStringField(TEXT("class_type"), TEXT("KSampler"));
-    Root->SetObjectField(TEXT("183"), Node183);
-
-    // --- Node 184: VAEDecode ---
-    TSharedPtr<FJsonObject> Node184 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node184Inputs = MakeShared<FJsonObject>();
-    Node184Inputs->SetArrayField(TEXT("samples"), MakeRef(TEXT("183"), 0));
-    Node184Inputs->SetArrayField(TEXT("vae"), MakeRef(TEXT("172"), 0));
-    Node184->SetObjectField(TEXT("inputs"), Node184Inputs);
-    Node184->SetStringField(TEXT("class_type"), TEXT("VAEDecode"));
-    Root->SetObjectField(TEXT("184"), Node184);
-
-    // --- Node 186: VAEEncode ---
-    TSharedPtr<FJsonObject> Node186 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node186Inputs = MakeShared<FJsonObject>();
-    Node186Inputs->SetArrayField(TEXT("pixels"), MakeRef(TEXT("171"), 0));
-    Node186->SetObjectField(TEXT("inputs"), Node186Inputs);
-    Node186->SetStringField(TEXT("class_type"), TEXT("VAEEncode"));
-    Root->SetObjectField(TEXT("186"), Node186);
-
-    // --- Node 9: SaveImage ---
-    TSharedPtr<FJsonObject> Node9 = MakeShared<FJsonObject>();
-    TSharedPtr<FJsonObject> Node9Inputs = MakeShared<FJsonObject>();
-    Node9Inputs->SetStringField(TEXT("filename_prefix"), Params.FilenamePrefix);
-    Node9Inputs->SetArrayField(TEXT("images"), MakeRef(TEXT("184"), 0));
-    Node9->SetObjectField(TEXT("inputs"), Node9Inputs);
-    Node9->SetStringField(TEXT("class_type"), TEXT("SaveImage"));
-    Root->SetObjectField(TEXT("9"), Node9);
-
-    // Serialize
-    FString OutputJson;
-    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutputJson);
-    FJsonSerializer::Serialize(Root.ToSharedRef(), Writer);
-    return OutputJson;
+    FComfyTemplateValue Values[QE_Num];
+    Values[QE_Image]          = Params.InputImageFilename;
+    Values[QE_Vae]            = Params.VaeName;
+    Values[QE_Clip]           = Params.ClipName;
+    Values[QE_Unet]           = Params.UnetName;
+    Values[QE_Instruction]    = Params.Instruction;
+    Values[QE_Shift]          = (double)Params.Shift;
+    Values[QE_Steps]          = Params.Steps;
+    Values[QE_CFG]            = (double)Params.CFGScale;
+    Values[QE_Seed]           = Params.Seed < 0 ? FMath::Rand() : Params.Seed;
+    Values[QE_Sampler]        = Params.Sampler;
+    Values[QE_Scheduler]      = Params.Scheduler;
+    Values[QE_FilenamePrefix] = Params.FilenamePrefix;
+    return GetQwenEditTemplate().Render(Values);
 }
 
 // ============================================================================
@@ -803,49 +949,78 @@ FString UComfyUIBlueprintLibrary::GetComfyUIOutputFolder()
 
 UTexture2D* UComfyUIBlueprintLibrary::LoadImageFromFile(const FString& FilePath)
 {
-    TArray<uint8> RawFileData;
+    TArray64<uint8> RawFileData;
     if (!FFileHelper::LoadFileToArray(RawFileData, *FilePath))
     {
         UE_LOG(LogTemp, Error, TEXT("ComfyUI: Failed to load file: %s"), *FilePath);
         return nullptr;
     }
 
-    IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+    ComfyUIImage::PreloadImageWrapperModule();
 
-    EImageFormat Format = EImageFormat::PNG;
-    if (FilePath.EndsWith(TEXT(".jpg")) || FilePath.EndsWith(TEXT(".jpeg")))
-    {
-        Format = EImageFormat::JPEG;
-    }
-
-    TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(Format);
-    if (!ImageWrapper.IsValid() || !ImageWrapper->SetCompressed(RawFileData.GetData(), RawFileData.Num()))
+    FComfyUIDecodedImage Image;
+    if (!ComfyUIImage::DecodeToBGRA(RawFileData.GetData(), RawFileData.Num(), Image))
     {
         UE_LOG(LogTemp, Error, TEXT("ComfyUI: Failed to decompress image: %s"), *FilePath);
         return nullptr;
     }
 
-    TArray<uint8> UncompressedBGRA;
-    if (!ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, UncompressedBGRA))
+    // Free the compressed bytes before the texture allocation
+    RawFileData.Empty();
+    return ComfyUIImage::CreateTransientTexture(MoveTemp(Image));
+}
+
+namespace
+{
+    /** Waits for a worker decode, then creates the texture and resumes the Blueprint in the same tick */
+    class FComfyUILoadImageAction : public FPendingLatentAction
     {
-        return nullptr;
-    }
+    public:
+        FComfyUILoadImageAction(const FString& FilePath, UTexture2D*& InOutTexture, const FLatentActionInfo& LatentInfo)
+            : Decoded(ComfyUIImage::DecodeFileAsync(FilePath))
+            , OutTexture(InOutTexture)
+            , ExecutionFunction(LatentInfo.ExecutionFunction)
+            , OutputLink(LatentInfo.Linkage)
+            , CallbackTarget(LatentInfo.CallbackTarget)
+        {
+        }
 
-    const int32 Width = ImageWrapper->GetWidth();
-    const int32 Height = ImageWrapper->GetHeight();
+        virtual void UpdateOperation(FLatentResponse& Response) override
+        {
+            if (!Decoded.IsReady())
+            {
+                return;
+            }
 
-    UTexture2D* Texture = UTexture2D::CreateTransient(Width, Height, PF_B8G8R8A8);
-    if (!Texture)
+            // Created and handed to the Blueprint before returning, so GC never sees it unreferenced
+            FComfyUIDecodedImage Image = Decoded.Consume();
+            OutTexture = ComfyUIImage::CreateTransientTexture(MoveTemp(Image));
+            Response.FinishAndTriggerIf(true, ExecutionFunction, OutputLink, CallbackTarget);
+        }
+
+    private:
+        TFuture<FComfyUIDecodedImage> Decoded;
+        UTexture2D*& OutTexture;
+        FName ExecutionFunction;
+        int32 OutputLink;
+        FWeakObjectPtr CallbackTarget;
+    };
+}
+
+void UComfyUIBlueprintLibrary::LoadImageFromFileAsync(UObject* WorldContextObject, const FString& FilePath, UTexture2D*& Texture, FLatentActionInfo LatentInfo)
+{
+    UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+    if (!World)
     {
-        return nullptr;
+        return;
     }
 
-    void* TextureData = Texture->GetPlatformData()->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
-    FMemory::Memcpy(TextureData, UncompressedBGRA.GetData(), UncompressedBGRA.Num());
-    Texture->GetPlatformData()->Mips[0].BulkData.Unlock();
-    Texture->UpdateResource();
-
-    return Texture;
+    FLatentActionManager& LatentManager = World->GetLatentActionManager();
+    if (LatentManager.FindExistingAction<FComfyUILoadImageAction>(LatentInfo.CallbackTarget, LatentInfo.UUID) == nullptr)
+    {
+        LatentManager.AddNewAction(LatentInfo.CallbackTarget, LatentInfo.UUID,
+            new FComfyUILoadImageAction(FilePath, Texture, LatentInfo));
+    }
 }
 
 FString UComfyUIBlueprintLibrary::GetLatestOutputImage(const FString& FilenamePrefix)
@@ -863,84 +1038,265 @@ FString UComfyUIBlueprintLibrary::GetLatestOutputImage(const FString& FilenamePr
         return TEXT("");
     }
 
-    TArray<FString> Files;
-    IFileManager::Get().FindFiles(Files, *FPaths::Combine(OutputFolder, TEXT("*.png")), true, false);
+    FComfyUIModule* Module = FModuleManager::GetModulePtr<FComfyUIModule>(TEXT("ComfyUI"));
+    TSharedPtr<FComfyUIOutputIndex> OutputIndex = Module ? Module->GetOutputIndex() : nullptr;
+    if (!OutputIndex.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("ComfyUI: Module not loaded"));
+        return TEXT("");
+    }
 
-    UE_LOG(LogTemp, Warning, TEXT("ComfyUI: Found %d PNG files in output folder"), Files.Num());
-    UE_LOG(LogTemp, Warning, TEXT("ComfyUI: Looking for prefix: '%s'"), *FilenamePrefix);
+    OutputIndex->SetFolder(OutputFolder);
+    const FString LatestFile = OutputIndex->FindLatest(FilenamePrefix);
 
-    FString LatestFile;
-    FDateTime LatestTime = FDateTime::MinValue();
+    if (LatestFile.IsEmpty())
+    {
+        UE_LOG(LogTemp, Error, TEXT("ComfyUI: No matching files found!"));
+    }
+    else
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ComfyUI: Latest file: %s"), *LatestFile);
+    }
 
-    for (const FString& File : Files)
+    return LatestFile;
+}
+
+void UComfyUIBlueprintLibrary::GetOutputsForPrompt(const FString& PromptId, const FComfyUIOutputsDelegate& OnComplete)
+{
+    TSharedPtr<FComfyUIBackendPool> Pool = GetBackendPool();
+    if (!Pool.IsValid())
     {
-        UE_LOG(LogTemp, Log, TEXT("ComfyUI: Checking file: %s"), *File);
-        
-        if (!FilenamePrefix.IsEmpty() && !File.StartsWith(FilenamePrefix))
+        OnComplete.ExecuteIfBound(false, TArray<FComfyUIOutputImage>());
+        return;
+    }
+
+    Pool->GetBackendForPrompt(PromptId)->Client->GetOutputs(PromptId, [OnComplete](bool bSuccess, const TArray<FComfyUIOutputImage>& Outputs)
+    {
+        OnComplete.ExecuteIfBound(bSuccess, Outputs);
+    });
+}
+
+namespace
+{
+#if WITH_EDITOR
+    /** Runs UTextureFactory on file bytes already in memory. The caller announces the asset. */
+    UTexture2D* ImportWithFactory(const FString& SourceFilePath, const FString& DestAssetPath, const uint8* DataBegin, const uint8* DataEnd)
+    {
+        UTextureFactory* Factory = NewObject<UTextureFactory>();
+        Factory->AddToRoot();
+
+        UTexture2D* Texture = Cast<UTexture2D>(
+            Factory->FactoryCreateBinary(
+                UTexture2D::StaticClass(),
+                CreatePackage(*DestAssetPath),
+                FName(*FPaths::GetBaseFilename(DestAssetPath)),
+                RF_Public | RF_Standalone,
+                nullptr,
+                *FPaths::GetExtension(SourceFilePath),
+                DataBegin,
+                DataEnd,
+                GWarn
+            )
+        );
+
+        Factory->RemoveFromRoot();
+
+        if (Texture)
+            Texture->MarkPackageDirty();
+        return Texture;
+    }
+
+    /**
+     * A file decoded into the source layout UTextureFactory picks for it: 8-bit colour as
+     * sRGB BGRA8, 16-bit colour as linear RGBA16, greyscale as G8/G16. Formats the factory
+     * treats specially (HDR, EXR, TGA, ...) are not decoded; FileData is kept for it instead.
+     */
+    struct FComfyUIImportImage
+    {
+        int32 Width = 0;
+        int32 Height = 0;
+        ETextureSourceFormat Format = TSF_Invalid;
+        bool bSRGB = true;
+        bool bHasAlpha = false;
+        TArray64<uint8> Pixels;
+        TArray64<uint8> FileData;
+    };
+
+    template <typename ChannelType>
+    bool HasTranslucentPixel(const TArray64<uint8>& Pixels, ChannelType Opaque)
+    {
+        // Alpha is the fourth channel in both BGRA8 and RGBA16
+        const ChannelType* Channels = reinterpret_cast<const ChannelType*>(Pixels.GetData());
+        const int64 NumChannels = Pixels.Num() / sizeof(ChannelType);
+        for (int64 Index = 3; Index < NumChannels; Index += 4)
         {
-            UE_LOG(LogTemp, Log, TEXT("ComfyUI: Skipping (prefix mismatch): %s"), *File);
-            continue;
+            if (Channels[Index] != Opaque)
+                return true;
         }
+        return false;
+    }
 
-        FString FullPath = FPaths::Combine(OutputFolder, File);
-        FDateTime ModTime = IFileManager::Get().GetTimeStamp(*FullPath);
-        
-        UE_LOG(LogTemp, Log, TEXT("ComfyUI: File time: %s - %s"), *File, *ModTime.ToString());
-        
-        if (ModTime > LatestTime)
+    /** Worker-thread half of an import. Needs the ImageWrapper module loaded. */
+    void DecodeForImport(TArray64<uint8>&& FileData, FComfyUIImportImage& OutImage)
+    {
+        IImageWrapperModule& ImageWrapperModule = FModuleManager::GetModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+        const EImageFormat Format = ImageWrapperModule.DetectImageFormat(FileData.GetData(), FileData.Num());
+
+        TSharedPtr<IImageWrapper> ImageWrapper;
+        if (Format == EImageFormat::PNG || Format == EImageFormat::JPEG || Format == EImageFormat::BMP)
+            ImageWrapper = ImageWrapperModule.CreateImageWrapper(Format);
+
+        if (ImageWrapper.IsValid() && ImageWrapper->SetCompressed(FileData.GetData(), FileData.Num()))
         {
-            LatestTime = ModTime;
-            LatestFile = FullPath;
+            const int32 BitDepth = ImageWrapper->GetBitDepth();
+            bool bDecoded = false;
+
+            if (BitDepth != 8 && BitDepth != 16)
+            {
+                // Left to the factory below
+            }
+            else if (ImageWrapper->GetFormat() == ERGBFormat::Gray)
+            {
+                OutImage.Format = BitDepth == 16 ? TSF_G16 : TSF_G8;
+                bDecoded = ImageWrapper->GetRaw(ERGBFormat::Gray, BitDepth, OutImage.Pixels);
+            }
+            else if (BitDepth == 16)
+            {
+                OutImage.Format = TSF_RGBA16;
+                bDecoded = ImageWrapper->GetRaw(ERGBFormat::RGBA, 16, OutImage.Pixels);
+                OutImage.bHasAlpha = bDecoded && HasTranslucentPixel<uint16>(OutImage.Pixels, MAX_uint16);
+            }
+            else
+            {
+                OutImage.Format = TSF_BGRA8;
+                bDecoded = ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, OutImage.Pixels);
+                OutImage.bHasAlpha = bDecoded && HasTranslucentPixel<uint8>(OutImage.Pixels, MAX_uint8);
+            }
+
+            if (bDecoded)
+            {
+                OutImage.Width = ImageWrapper->GetWidth();
+                OutImage.Height = ImageWrapper->GetHeight();
+                OutImage.bSRGB = BitDepth < 16;
+                return;
+            }
         }
+
+        OutImage = FComfyUIImportImage();
+        OutImage.FileData = MoveTemp(FileData);
     }
 
-    if (LatestFile.IsEmpty())
+    UTexture2D* CreateTextureAsset(const FString& SourceFilePath, const FString& DestAssetPath, const FComfyUIImportImage& Image)
     {
-        UE_LOG(LogTemp, Error, TEXT("ComfyUI: No matching files found!"));
+        if (Image.Format == TSF_Invalid)
+        {
+            const uint8* DataPtr = Image.FileData.GetData();
+            return ImportWithFactory(SourceFilePath, DestAssetPath, DataPtr, DataPtr + Image.FileData.Num());
+        }
+
+        UPackage* Package = CreatePackage(*DestAssetPath);
+        if (!Package)
+        {
+            UE_LOG(LogTemp, Error, TEXT("ComfyUI: Failed to create package: %s"), *DestAssetPath);
+            return nullptr;
+        }
+
+        UTexture2D* Texture = NewObject<UTexture2D>(Package, FName(*FPaths::GetBaseFilename(DestAssetPath)), RF_Public | RF_Standalone);
+        Texture->Source.Init(Image.Width, Image.Height, 1, 1, Image.Format, Image.Pixels.GetData());
+
+        // What the factory would have set for the same file, including its configured defaults
+        const UTextureFactory* FactoryDefaults = GetDefault<UTextureFactory>();
+        Texture->SRGB = Image.bSRGB;
+        Texture->CompressionNoAlpha = FactoryDefaults->NoAlpha || !Image.bHasAlpha;
+        Texture->CompressionSettings = FactoryDefaults->CompressionSettings;
+        Texture->LODGroup = FactoryDefaults->LODGroup;
+        Texture->MipGenSettings = FactoryDefaults->MipGenSettings;
+        Texture->AssetImportData->Update(SourceFilePath);
+
+        // Compression isn't done here: PostEditChange queues the platform data build with
+        // the texture compiling manager, which compresses on worker threads
+        Texture->PostEditChange();
+        Texture->MarkPackageDirty();
+        return Texture;
     }
-    else
+
+    // Files decoded per step of a batch import. Decoded pixels are the large part (an 8K
+    // panorama is over 100 MB), so only this many, plus the step being turned into
+    // textures, are held at once.
+    constexpr int32 ImportBatchChunkSize = 4;
+
+    struct FComfyUIBatchImport
     {
-        UE_LOG(LogTemp, Warning, TEXT("ComfyUI: Latest file: %s"), *LatestFile);
-    }
+        TArray<FString> SourceFilePaths;
+        TArray<FString> DestAssetPaths;
+        TArray<UTexture2D*> Textures;
+        TFunction<void(const TArray<UTexture2D*>&)> OnComplete;
+    };
+
+    /** Decodes files [First, First + ImportBatchChunkSize) on the thread pool, then creates their textures */
+    void ImportBatchChunk(const TSharedRef<FComfyUIBatchImport, ESPMode::ThreadSafe>& Batch, int32 First)
+    {
+        const int32 Count = FMath::Min(ImportBatchChunkSize, Batch->SourceFilePaths.Num() - First);
 
-    return LatestFile;
+        Async(EAsyncExecution::ThreadPool, [Batch, First, Count]()
+        {
+            TArray<FComfyUIImportImage> Images;
+            Images.SetNum(Count);
+
+            ParallelFor(Count, [&](int32 Offset)
+            {
+                TArray64<uint8> FileData;
+                if (FFileHelper::LoadFileToArray(FileData, *Batch->SourceFilePaths[First + Offset]))
+                    DecodeForImport(MoveTemp(FileData), Images[Offset]);
+            });
+
+            AsyncTask(ENamedThreads::GameThread, [Batch, First, Images = MoveTemp(Images)]() mutable
+            {
+                // The next step decodes while this one becomes textures
+                const int32 Next = First + Images.Num();
+                if (Next < Batch->SourceFilePaths.Num())
+                    ImportBatchChunk(Batch, Next);
+
+                for (int32 Offset = 0; Offset < Images.Num(); ++Offset)
+                {
+                    const int32 Index = First + Offset;
+                    if (Images[Offset].Pixels.Num() == 0 && Images[Offset].FileData.Num() == 0)
+                    {
+                        UE_LOG(LogTemp, Error, TEXT("ComfyUI: Failed to read %s for import"), *Batch->SourceFilePaths[Index]);
+                        continue;
+                    }
+                    Batch->Textures[Index] = CreateTextureAsset(Batch->SourceFilePaths[Index], Batch->DestAssetPaths[Index], Images[Offset]);
+                    Images[Offset] = FComfyUIImportImage();
+                }
+
+                if (Next < Batch->SourceFilePaths.Num())
+                    return;
+
+                // Announce everything at once so content browser refreshes happen in one burst
+                for (UTexture2D* Texture : Batch->Textures)
+                {
+                    if (Texture)
+                        FAssetRegistryModule::AssetCreated(Texture);
+                }
+
+                Batch->OnComplete(Batch->Textures);
+            });
+        });
+    }
+#endif
 }
 
 UTexture2D* UComfyUIBlueprintLibrary::ImportImageAsAsset(const FString& SourceFilePath, const FString& DestAssetPath)
 {
 #if WITH_EDITOR
-    UTextureFactory* Factory = NewObject<UTextureFactory>();
-    Factory->AddToRoot();
-
     TArray<uint8> RawData;
     if (!FFileHelper::LoadFileToArray(RawData, *SourceFilePath))
-    {
-        Factory->RemoveFromRoot();
         return nullptr;
-    }
 
     const uint8* DataPtr = RawData.GetData();
-    UTexture2D* Texture = Cast<UTexture2D>(
-        Factory->FactoryCreateBinary(
-            UTexture2D::StaticClass(),
-            CreatePackage(*DestAssetPath),
-            FName(*FPaths::GetBaseFilename(DestAssetPath)),
-            RF_Public | RF_Standalone,
-            nullptr,
-            *FPaths::GetExtension(SourceFilePath),
-            DataPtr,
-            DataPtr + RawData.Num(),
-            GWarn
-        )
-    );
-
-    Factory->RemoveFromRoot();
-
+    UTexture2D* Texture = ImportWithFactory(SourceFilePath, DestAssetPath, DataPtr, DataPtr + RawData.Num());
     if (Texture)
-    {
         FAssetRegistryModule::AssetCreated(Texture);
-        Texture->MarkPackageDirty();
-    }
 
     return Texture;
 #else
@@ -948,12 +1304,143 @@ UTexture2D* UComfyUIBlueprintLibrary::ImportImageAsAsset(const FString& SourceFi
 #endif
 }
 
+namespace
+{
+    class FComfyUIImportImagesAction : public FPendingLatentAction
+    {
+    public:
+        FComfyUIImportImagesAction(const TArray<FString>& SourceFilePaths, const TArray<FString>& DestAssetPaths,
+            TArray<UTexture2D*>& InOutTextures, const FLatentActionInfo& LatentInfo)
+            : State(MakeShared<FState>())
+            , OutTextures(InOutTextures)
+            , ExecutionFunction(LatentInfo.ExecutionFunction)
+            , OutputLink(LatentInfo.Linkage)
+            , CallbackTarget(LatentInfo.CallbackTarget)
+        {
+            UComfyUIBlueprintLibrary::ImportImagesAsAssets(SourceFilePaths, DestAssetPaths,
+                [WeakState = TWeakPtr<FState>(State)](const TArray<UTexture2D*>& Textures)
+                {
+                    if (TSharedPtr<FState> Pinned = WeakState.Pin())
+                    {
+                        Pinned->Textures = Textures;
+                        Pinned->bDone = true;
+                    }
+                });
+        }
+
+        virtual void UpdateOperation(FLatentResponse& Response) override
+        {
+            if (State->bDone)
+            {
+                OutTextures = State->Textures;
+            }
+            Response.FinishAndTriggerIf(State->bDone, ExecutionFunction, OutputLink, CallbackTarget);
+        }
+
+    private:
+        struct FState
+        {
+            bool bDone = false;
+            TArray<UTexture2D*> Textures;
+        };
+
+        TSharedRef<FState> State;
+        TArray<UTexture2D*>& OutTextures;
+        FName ExecutionFunction;
+        int32 OutputLink;
+        FWeakObjectPtr CallbackTarget;
+    };
+}
+
+void UComfyUIBlueprintLibrary::ImportImagesAsAssets(const TArray<FString>& SourceFilePaths, const TArray<FString>& DestAssetPaths,
+    TFunction<void(const TArray<UTexture2D*>&)> OnComplete)
+{
+    TArray<UTexture2D*> Textures;
+    Textures.SetNumZeroed(SourceFilePaths.Num());
+
+    if (SourceFilePaths.Num() == 0 || SourceFilePaths.Num() != DestAssetPaths.Num())
+    {
+        if (SourceFilePaths.Num() != DestAssetPaths.Num())
+            UE_LOG(LogTemp, Error, TEXT("ComfyUI: ImportImagesAsAssets needs one destination per source"));
+        OnComplete(Textures);
+        return;
+    }
+
+    ComfyUIImage::PreloadImageWrapperModule();
+
+#if WITH_EDITOR
+
+    // Chunked so peak memory is two chunks of pixels however large the batch is
+    TSharedRef<FComfyUIBatchImport, ESPMode::ThreadSafe> Batch = MakeShared<FComfyUIBatchImport, ESPMode::ThreadSafe>();
+    Batch->SourceFilePaths = SourceFilePaths;
+    Batch->DestAssetPaths = DestAssetPaths;
+    Batch->Textures = MoveTemp(Textures);
+    Batch->OnComplete = MoveTemp(OnComplete);
+    ImportBatchChunk(Batch, 0);
+#else
+    // No asset tools outside the editor, so like ImportImageAsAsset this hands back
+    // transient textures. They stay rooted until the whole batch is done so earlier
+    // ones survive garbage collection while later ones decode.
+    struct FPendingLoads
+    {
+        TArray<UTexture2D*> Textures;
+        int32 Remaining = 0;
+        TFunction<void(const TArray<UTexture2D*>&)> OnComplete;
+    };
+    TSharedRef<FPendingLoads> Pending = MakeShared<FPendingLoads>();
+    Pending->Textures = MoveTemp(Textures);
+    Pending->Remaining = SourceFilePaths.Num();
+    Pending->OnComplete = MoveTemp(OnComplete);
+
+    for (int32 Index = 0; Index < SourceFilePaths.Num(); ++Index)
+    {
+        ComfyUIImage::LoadImageFromFileAsync(SourceFilePaths[Index]).Then([Pending, Index](TFuture<UTexture2D*> Loaded)
+        {
+            // Fulfilled on the game thread
+            if (UTexture2D* Texture = Loaded.Get())
+            {
+                Texture->AddToRoot();
+                Pending->Textures[Index] = Texture;
+            }
+
+            if (--Pending->Remaining == 0)
+            {
+                for (UTexture2D* Texture : Pending->Textures)
+                {
+                    if (Texture)
+                        Texture->RemoveFromRoot();
+                }
+                Pending->OnComplete(Pending->Textures);
+            }
+        });
+    }
+#endif
+}
+
+void UComfyUIBlueprintLibrary::ImportImagesAsAssetsAsync(UObject* WorldContextObject, const TArray<FString>& SourceFilePaths, const TArray<FString>& DestAssetPaths,
+    TArray<UTexture2D*>& Textures, FLatentActionInfo LatentInfo)
+{
+    UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+    if (!World)
+    {
+        return;
+    }
+
+    FLatentActionManager& LatentManager = World->GetLatentActionManager();
+    if (LatentManager.FindExistingAction<FComfyUIImportImagesAction>(LatentInfo.CallbackTarget, LatentInfo.UUID) == nullptr)
+    {
+        LatentManager.AddNewAction(LatentInfo.CallbackTarget, LatentInfo.UUID,
+            new FComfyUIImportImagesAction(SourceFilePaths, DestAssetPaths, Textures, LatentInfo));
+    }
+}
+
 FString UComfyUIBlueprintLibrary::GenerateUniqueAssetName(const FString& BasePath, const FString& BaseName)
 {
     FString AssetPath = FPaths::Combine(BasePath, BaseName);
     int32 Counter = 0;
 
-    while (FPackageName::DoesPackageExist(AssetPath))
+    // Packages created this session but not saved yet exist only in memory
+    while (FPackageName::DoesPackageExist(AssetPath) || FindPackage(nullptr, *AssetPath))
     {
         Counter++;
         AssetPath = FPaths::Combine(BasePath, FString::Printf(TEXT("%s_%03d"), *BaseName, Counter));
@@ -968,20 +1455,124 @@ FString UComfyUIBlueprintLibrary::GenerateUniqueAssetName(const FString& BasePat
 
 void UComfyUIBlueprintLibrary::WatchWorkflowCompletion(const FString& PromptId, const FComfyUIWorkflowCompleteDelegate& OnComplete)
 {
-    EnsureWebSocketConnected();
+    if (TSharedPtr<FComfyUIWebSocketHandler> WSHandler = ConnectWebSocketForPrompt(PromptId))
+    {
+        // Bridge from native delegate to dynamic delegate
+        FComfyUIWorkflowCompleteDelegateNative NativeDelegate;
+        NativeDelegate.BindLambda([OnComplete](bool bSuccess, const FString& InPromptId)
+        {
+            OnComplete.ExecuteIfBound(bSuccess, InPromptId);
+        });
+        WSHandler->WatchPrompt(PromptId, NativeDelegate);
+    }
+}
 
-    if (FComfyUIModule* Module = FModuleManager::GetModulePtr<FComfyUIModule>(TEXT("ComfyUI")))
+namespace
+{
+    /** Delegate handles of one WatchWorkflowProgress call, removed together */
+    struct FProgressBindings
+    {
+        TWeakPtr<FComfyUIWebSocketHandler> Handler;
+        FDelegateHandle Progress, Executing, Executed, Cached, Queue, Finished;
+    };
+
+    /** Live WatchWorkflowProgress bindings by prompt id. Game thread only. */
+    TMap<FString, TArray<TSharedRef<FProgressBindings>>> ActiveProgressWatches;
+
+    void UnbindProgressWatches(const FString& PromptId)
     {
-        TSharedPtr<FComfyUIWebSocketHandler> WSHandler = Module->GetWebSocketHandler();
-        if (WSHandler.IsValid())
+        TArray<TSharedRef<FProgressBindings>> Watches;
+        if (!ActiveProgressWatches.RemoveAndCopyValue(PromptId, Watches))
+            return;
+
+        for (const TSharedRef<FProgressBindings>& Bindings : Watches)
         {
-            // Bridge from native delegate to dynamic delegate
-            FComfyUIWorkflowCompleteDelegateNative NativeDelegate;
-            NativeDelegate.BindLambda([OnComplete](bool bSuccess, const FString& InPromptId)
-            {
-                OnComplete.ExecuteIfBound(bSuccess, InPromptId);
-            });
-            WSHandler->WatchPrompt(PromptId, NativeDelegate);
+            TSharedPtr<FComfyUIWebSocketHandler> Handler = Bindings->Handler.Pin();
+            if (!Handler.IsValid())
+                continue;
+
+            Handler->OnProgress.Remove(Bindings->Progress);
+            Handler->OnNodeExecuting.Remove(Bindings->Executing);
+            Handler->OnNodeExecuted.Remove(Bindings->Executed);
+            Handler->OnNodesCached.Remove(Bindings->Cached);
+            Handler->OnQueueStatus.Remove(Bindings->Queue);
+            Handler->OnPromptFinished.Remove(Bindings->Finished);
+            Handler->UnobservePrompt(PromptId);
         }
     }
 }
+
+void UComfyUIBlueprintLibrary::WatchWorkflowProgress(const FString& PromptId, const FComfyUIProgressDelegate& OnProgress,
+    const FComfyUINodeEventDelegate& OnNodeEvent, const FComfyUIQueueStatusDelegate& OnQueueStatus)
+{
+    TSharedPtr<FComfyUIWebSocketHandler> WSHandler = ConnectWebSocketForPrompt(PromptId);
+    if (!WSHandler.IsValid())
+        return;
+
+    // OnPromptFinished won't fire again to unbind anything
+    if (WSHandler->HasPromptFinished(PromptId))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ComfyUI: Prompt %s already finished, no progress to watch"), *PromptId);
+        return;
+    }
+
+    // Without this the handler drops the prompt's messages unparsed
+    WSHandler->ObservePrompt(PromptId);
+
+    TSharedRef<FProgressBindings> Bindings = MakeShared<FProgressBindings>();
+    Bindings->Handler = WSHandler;
+    ActiveProgressWatches.FindOrAdd(PromptId).Add(Bindings);
+
+    Bindings->Progress = WSHandler->OnProgress.AddLambda(
+        [PromptId, OnProgress](const FString& InPromptId, const FString& NodeId, int32 Value, int32 Max)
+        {
+            if (InPromptId == PromptId)
+                OnProgress.ExecuteIfBound(InPromptId, NodeId, Value, Max);
+        });
+
+    Bindings->Executing = WSHandler->OnNodeExecuting.AddLambda(
+        [PromptId, OnNodeEvent](const FString& InPromptId, const FString& NodeId)
+        {
+            if (InPromptId == PromptId)
+                OnNodeEvent.ExecuteIfBound(InPromptId, NodeId, EComfyUINodeEvent::Executing);
+        });
+
+    Bindings->Executed = WSHandler->OnNodeExecuted.AddLambda(
+        [PromptId, OnNodeEvent](const FString& InPromptId, const FString& NodeId, const TSharedPtr<FJsonObject>&)
+        {
+            if (InPromptId == PromptId)
+                OnNodeEvent.ExecuteIfBound(InPromptId, NodeId, EComfyUINodeEvent::Executed);
+        });
+
+    Bindings->Cached = WSHandler->OnNodesCached.AddLambda(
+        [PromptId, OnNodeEvent](const FString& InPromptId, const TArray<FString>& NodeIds)
+        {
+            if (InPromptId != PromptId)
+                return;
+            for (const FString& NodeId : NodeIds)
+                OnNodeEvent.ExecuteIfBound(InPromptId, NodeId, EComfyUINodeEvent::Cached);
+        });
+
+    Bindings->Queue = WSHandler->OnQueueStatus.AddLambda(
+        [OnQueueStatus](int32 QueueRemaining)
+        {
+            OnQueueStatus.ExecuteIfBound(QueueRemaining);
+        });
+
+    Bindings->Finished = WSHandler->OnPromptFinished.AddLambda(
+        [PromptId](const FString& InPromptId, bool)
+        {
+            // Unbinding destroys this lambda, so only the broadcast's argument is used
+            if (InPromptId == PromptId)
+                UnbindProgressWatches(InPromptId);
+        });
+
+    // Report the current queue length right away instead of waiting for the next change
+    if (WSHandler->GetQueueRemaining() >= 0)
+        OnQueueStatus.ExecuteIfBound(WSHandler->GetQueueRemaining());
+}
+
+void UComfyUIBlueprintLibrary::StopWatchingWorkflowProgress(const FString& PromptId)
+{
+    UnbindProgressWatches(PromptId);
+}
@@ -0,0 +1,633 @@
+#include "ComfyUIClient.h"
+#include "ComfyUISettings.h"
+#include "ComfyUIMultipartBody.h"
+#include "ComfyUIUploadCache.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpResponse.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "Hash/xxhash.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/Async.h"
+#include "HAL/PlatformTime.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace
+{
+    const TCHAR* DefaultBaseUrl = TEXT("http://127.0.0.1:8188");
+
+    constexpr int32 MaxCachedPromptOutputs = 512;
+
+    /** XXH64 of a file, read in fixed chunks so large plates never sit in memory whole */
+    bool HashFile(const FString& FilePath, uint64& OutHash, int64& OutSize)
+    {
+        TUniquePtr<IFileHandle> File(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*FilePath));
+        if (!File.IsValid())
+            return false;
+
+        TArray<uint8> Chunk;
+        Chunk.SetNumUninitialized(1024 * 1024);
+
+        OutSize = File->Size();
+        FXxHash64Builder Builder;
+        for (int64 Remaining = OutSize; Remaining > 0;)
+        {
+            const int64 Count = FMath::Min<int64>(Remaining, Chunk.Num());
+            if (!File->Read(Chunk.GetData(), Count))
+                return false;
+            Builder.Update(Chunk.GetData(), Count);
+            Remaining -= Count;
+        }
+        OutHash = Builder.Finalize().Hash;
+        return true;
+    }
+}
+
+FComfyUIClient::FComfyUIClient(const FString& FixedBaseUrl)
+{
+    if (!FixedBaseUrl.IsEmpty())
+    {
+        CachedBaseUrl = FixedBaseUrl;
+        CachedBaseUrl.RemoveFromEnd(TEXT("/"));
+        bBaseUrlResolved = true;
+        bFixedBaseUrl = true;
+    }
+}
+
+FComfyUIClient::~FComfyUIClient()
+{
+#if WITH_EDITOR
+    // Settings CDO may already be gone during engine shutdown
+    if (SettingsChangedHandle.IsValid() && UObjectInitialized())
+    {
+        if (UComfyUISettings* Settings = GetMutableDefault<UComfyUISettings>())
+        {
+            Settings->OnSettingChanged().Remove(SettingsChangedHandle);
+        }
+    }
+#endif
+}
+
+// ============================================================================
+// Base URL
+// ============================================================================
+
+const FString& FComfyUIClient::GetBaseUrl()
+{
+    if (!bBaseUrlResolved)
+    {
+        // Resolved lazily: the runtime module starts at PostConfigInit, before
+        // the settings CDO can safely be touched
+        const UComfyUISettings* Settings = GetDefault<UComfyUISettings>();
+        CachedBaseUrl = (Settings && !Settings->BaseUrl.IsEmpty()) ? Settings->BaseUrl : DefaultBaseUrl;
+        CachedBaseUrl.RemoveFromEnd(TEXT("/"));
+        bBaseUrlResolved = true;
+
+#if WITH_EDITOR
+        if (!SettingsChangedHandle.IsValid())
+        {
+            if (UComfyUISettings* MutableSettings = GetMutableDefault<UComfyUISettings>())
+            {
+                SettingsChangedHandle = MutableSettings->OnSettingChanged().AddRaw(this, &FComfyUIClient::OnSettingsChanged);
+            }
+        }
+#endif
+        UE_LOG(LogTemp, Log, TEXT("ComfyUI Client: Using base URL %s"), *CachedBaseUrl);
+    }
+    return CachedBaseUrl;
+}
+
+FString FComfyUIClient::GetWebSocketUrl(const FString& ClientId)
+{
+    FString WsUrl = GetBaseUrl()
+        .Replace(TEXT("http://"), TEXT("ws://"))
+        .Replace(TEXT("https://"), TEXT("wss://"))
+        + TEXT("/ws");
+
+    if (!ClientId.IsEmpty())
+    {
+        WsUrl += TEXT("?clientId=") + ClientId;
+    }
+    return WsUrl;
+}
+
+void FComfyUIClient::InvalidateBaseUrl()
+{
+    if (bFixedBaseUrl)
+        return;
+
+    bBaseUrlResolved = false;
+    CachedBaseUrl.Reset();
+}
+
+void FComfyUIClient::OnSettingsChanged(UObject* Settings, FPropertyChangedEvent& PropertyChangedEvent)
+{
+    InvalidateBaseUrl();
+}
+
+// ============================================================================
+// Request plumbing
+// ============================================================================
+
+TSharedRef<IHttpRequest, ESPMode::ThreadSafe> FComfyUIClient::CreateRequest(const FString& Verb, const FString& Path)
+{
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+    Request->SetURL(GetBaseUrl() + Path);
+    Request->SetVerb(Verb);
+    return Request;
+}
+
+void FComfyUIClient::Dispatch(const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>& Request, const FString& Endpoint,
+    TFunction<void(bool, FHttpResponsePtr)> OnComplete)
+{
+    const double StartTime = FPlatformTime::Seconds();
+    TWeakPtr<FComfyUIClient> WeakClient = AsShared();
+
+    Request->OnProcessRequestComplete().BindLambda(
+        [WeakClient, Endpoint, StartTime, OnComplete = MoveTemp(OnComplete)](FHttpRequestPtr, FHttpResponsePtr Response, bool bSucceeded)
+        {
+            const bool bOk = bSucceeded && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode());
+
+            if (TSharedPtr<FComfyUIClient> Client = WeakClient.Pin())
+            {
+                const double Elapsed = FPlatformTime::Seconds() - StartTime;
+                FEndpointStats& Stats = Client->EndpointStats.FindOrAdd(Endpoint);
+                Stats.NumRequests++;
+                Stats.NumFailures += bOk ? 0 : 1;
+                Stats.TotalSeconds += Elapsed;
+                Stats.MaxSeconds = FMath::Max(Stats.MaxSeconds, Elapsed);
+            }
+
+            OnComplete(bOk, Response);
+        });
+
+    Request->ProcessRequest();
+}
+
+void FComfyUIClient::LogStats() const
+{
+    for (const TPair<FString, FEndpointStats>& Pair : EndpointStats)
+    {
+        const FEndpointStats& Stats = Pair.Value;
+        const double AvgMs = Stats.NumRequests > 0 ? (Stats.TotalSeconds / Stats.NumRequests) * 1000.0 : 0.0;
+        UE_LOG(LogTemp, Log, TEXT("ComfyUI Client: %s - %d requests, %d failed, avg %.1f ms, max %.1f ms"),
+            *Pair.Key, Stats.NumRequests, Stats.NumFailures, AvgMs, Stats.MaxSeconds * 1000.0);
+    }
+}
+
+// ============================================================================
+// Endpoints
+// ============================================================================
+
+void FComfyUIClient::GetSystemStats(FOnJsonResponse OnComplete, float TimeoutSeconds)
+{
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = CreateRequest(TEXT("GET"), TEXT("/system_stats"));
+    if (TimeoutSeconds > 0.0f)
+    {
+        Request->SetTimeout(TimeoutSeconds);
+    }
+
+    Dispatch(Request, TEXT("/system_stats"),
+        [OnComplete = MoveTemp(OnComplete)](bool bOk, FHttpResponsePtr Response)
+        {
+            OnComplete(bOk, Response.IsValid() ? Response->GetContentAsString() : FString());
+        });
+}
+
+void FComfyUIClient::GetQueue(FOnJsonResponse OnComplete, float TimeoutSeconds)
+{
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = CreateRequest(TEXT("GET"), TEXT("/queue"));
+    if (TimeoutSeconds > 0.0f)
+    {
+        Request->SetTimeout(TimeoutSeconds);
+    }
+
+    Dispatch(Request, TEXT("/queue"),
+        [OnComplete = MoveTemp(OnComplete)](bool bOk, FHttpResponsePtr Response)
+        {
+            OnComplete(bOk, Response.IsValid() ? Response->GetContentAsString() : FString());
+        });
+}
+
+void FComfyUIClient::PostPrompt(const FString& RequestBody, FOnPromptQueued OnComplete)
+{
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = CreateRequest(TEXT("POST"), TEXT("/prompt"));
+    Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+    Request->SetContentAsString(RequestBody);
+
+    Dispatch(Request, TEXT("/prompt"),
+        [OnComplete = MoveTemp(OnComplete)](bool bOk, FHttpResponsePtr Response)
+        {
+            const FString ResponseText = Response.IsValid() ? Response->GetContentAsString() : FString();
+
+            FString PromptId;
+            if (bOk)
+            {
+                TSharedPtr<FJsonObject> JsonResponse;
+                const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseText);
+                if (FJsonSerializer::Deserialize(Reader, JsonResponse) && JsonResponse.IsValid())
+                {
+                    JsonResponse->TryGetStringField(TEXT("prompt_id"), PromptId);
+                }
+            }
+
+            OnComplete(bOk, PromptId, ResponseText);
+        });
+}
+
+void FComfyUIClient::GetHistory(const FString& PromptId, FOnHistory OnComplete)
+{
+    DispatchHistory(CreateRequest(TEXT("GET"), TEXT("/history/") + PromptId), MoveTemp(OnComplete));
+}
+
+void FComfyUIClient::GetHistoryBatch(int32 MaxItems, FOnHistory OnComplete)
+{
+    DispatchHistory(CreateRequest(TEXT("GET"), FString::Printf(TEXT("/history?max_items=%d"), FMath::Max(1, MaxItems))), MoveTemp(OnComplete));
+}
+
+void FComfyUIClient::GetOutputs(const FString& PromptId, FOnOutputs OnComplete)
+{
+    if (const TArray<FComfyUIOutputImage>* Cached = OutputCache.Find(PromptId))
+    {
+        OnComplete(true, *Cached);
+        return;
+    }
+
+    if (TArray<FOnOutputs>* Waiting = PendingOutputs.Find(PromptId))
+    {
+        Waiting->Add(MoveTemp(OnComplete));
+        return;
+    }
+    PendingOutputs.Add(PromptId).Add(MoveTemp(OnComplete));
+
+    TWeakPtr<FComfyUIClient> WeakThis = AsShared();
+    GetHistory(PromptId, [WeakThis, PromptId](bool bOk, const TSharedPtr<FJsonObject>& History)
+    {
+        TSharedPtr<FComfyUIClient> Self = WeakThis.Pin();
+        if (!Self.IsValid())
+            return;
+
+        TArray<FOnOutputs> Callbacks;
+        Self->PendingOutputs.RemoveAndCopyValue(PromptId, Callbacks);
+
+        // A prompt that is still queued or running has no history entry yet; don't cache that
+        const bool bFinished = bOk && History->HasField(PromptId);
+        TArray<FComfyUIOutputImage> Outputs;
+        if (bFinished)
+        {
+            ExtractOutputImages(History, PromptId, Outputs);
+
+            // Prompt ids are never reused, so entries can't go stale; just keep the map bounded
+            if (Self->OutputCache.Num() >= MaxCachedPromptOutputs)
+                Self->OutputCache.Reset();
+            Self->OutputCache.Add(PromptId, Outputs);
+        }
+
+        for (const FOnOutputs& Callback : Callbacks)
+        {
+            Callback(bFinished, Outputs);
+        }
+    });
+}
+
+void FComfyUIClient::DispatchHistory(const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>& Request, FOnHistory OnComplete)
+{
+    Dispatch(Request, TEXT("/history"),
+        [OnComplete = MoveTemp(OnComplete)](bool bOk, FHttpResponsePtr Response)
+        {
+            TSharedPtr<FJsonObject> History;
+            if (bOk)
+            {
+                const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
+                if (!FJsonSerializer::Deserialize(Reader, History) || !History.IsValid())
+                {
+                    History.Reset();
+                }
+            }
+
+            OnComplete(History.IsValid(), History);
+        });
+}
+
+void FComfyUIClient::ExtractOutputImages(const TSharedPtr<FJsonObject>& History, const FString& PromptId, TArray<FComfyUIOutputImage>& OutImages)
+{
+    const TSharedPtr<FJsonObject>* PromptHistory;
+    const TSharedPtr<FJsonObject>* Outputs;
+    if (!History.IsValid()
+        || !History->TryGetObjectField(PromptId, PromptHistory)
+        || !(*PromptHistory)->TryGetObjectField(TEXT("outputs"), Outputs))
+    {
+        return;
+    }
+
+    for (const TPair<FString, TSharedPtr<FJsonValue>>& NodePair : (*Outputs)->Values)
+    {
+        const TSharedPtr<FJsonObject>* NodeOutput;
+        const TArray<TSharedPtr<FJsonValue>>* Images;
+        if (!NodePair.Value->TryGetObject(NodeOutput) || !(*NodeOutput)->TryGetArrayField(TEXT("images"), Images))
+            continue;
+
+        for (const TSharedPtr<FJsonValue>& ImageValue : *Images)
+        {
+            const TSharedPtr<FJsonObject>* ImageObject;
+            if (!ImageValue->TryGetObject(ImageObject))
+                continue;
+
+            FComfyUIOutputImage& Image = OutImages.AddDefaulted_GetRef();
+            (*ImageObject)->TryGetStringField(TEXT("filename"), Image.Filename);
+            (*ImageObject)->TryGetStringField(TEXT("subfolder"), Image.Subfolder);
+            (*ImageObject)->TryGetStringField(TEXT("type"), Image.Type);
+        }
+    }
+}
+
+bool FComfyUIClient::ExtractQueuedPromptIds(const FString& QueueJson, TSet<FString>& OutPromptIds)
+{
+    TSharedPtr<FJsonObject> Queue;
+    const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(QueueJson);
+    if (!FJsonSerializer::Deserialize(Reader, Queue) || !Queue.IsValid())
+    {
+        return false;
+    }
+
+    // {"queue_running": [[number, prompt_id, prompt, extra, outputs], ...], "queue_pending": [...]}
+    for (const TCHAR* Field : { TEXT("queue_running"), TEXT("queue_pending") })
+    {
+        const TArray<TSharedPtr<FJsonValue>>* Items;
+        if (!Queue->TryGetArrayField(Field, Items))
+            continue;
+
+        for (const TSharedPtr<FJsonValue>& Item : *Items)
+        {
+            const TArray<TSharedPtr<FJsonValue>>* Fields;
+            FString PromptId;
+            if (Item->TryGetArray(Fields) && Fields->Num() > 1 && (*Fields)[1]->TryGetString(PromptId))
+                OutPromptIds.Add(PromptId);
+        }
+    }
+    return true;
+}
+
+FString FComfyUIClient::MakeViewPath(const FString& Filename, const FString& Subfolder, const FString& Type)
+{
+    FString Path = TEXT("/view?filename=") + FGenericPlatformHttp::UrlEncode(Filename);
+    if (!Subfolder.IsEmpty())
+    {
+        Path += TEXT("&subfolder=") + FGenericPlatformHttp::UrlEncode(Subfolder);
+    }
+    Path += TEXT("&type=") + (Type.IsEmpty() ? FString(TEXT("output")) : Type);
+    return Path;
+}
+
+void FComfyUIClient::GetView(const FString& Filename, const FString& Subfolder, const FString& Type, FOnImageData OnComplete)
+{
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = CreateRequest(TEXT("GET"), MakeViewPath(Filename, Subfolder, Type));
+
+    Dispatch(Request, TEXT("/view"),
+        [OnComplete = MoveTemp(OnComplete), Filename](bool bOk, FHttpResponsePtr Response)
+        {
+            if (!bOk)
+            {
+                UE_LOG(LogTemp, Error, TEXT("ComfyUI Client: /view failed for %s"), *Filename);
+                OnComplete(false, TArray<uint8>());
+                return;
+            }
+            OnComplete(true, Response->GetContent());
+        });
+}
+
+void FComfyUIClient::DownloadView(const FString& Filename, const FString& Subfolder, const FString& Type, const FString& DestPath,
+    FOnDownloaded OnComplete, FOnProgress OnProgress)
+{
+    const FString PartPath = DestPath + TEXT(".part");
+    IFileManager& FileManager = IFileManager::Get();
+    FileManager.Delete(*PartPath, false, true, true);
+
+    // The file writer's own buffer bounds memory use; the HTTP module writes each
+    // chunk into it as it arrives instead of accumulating the response body
+    TSharedPtr<FArchive> PartFile(FileManager.CreateFileWriter(*PartPath));
+    if (!PartFile.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("ComfyUI Client: Failed to open %s for download"), *PartPath);
+        OnComplete(false, FString());
+        return;
+    }
+
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = CreateRequest(TEXT("GET"), MakeViewPath(Filename, Subfolder, Type));
+    if (!Request->SetResponseBodyReceiveStream(PartFile.ToSharedRef()))
+    {
+        UE_LOG(LogTemp, Error, TEXT("ComfyUI Client: Streaming not supported for /view request"));
+        PartFile->Close();
+        FileManager.Delete(*PartPath, false, true, true);
+        OnComplete(false, FString());
+        return;
+    }
+
+    if (OnProgress)
+    {
+        Request->OnRequestProgress64().BindLambda(
+            [OnProgress](FHttpRequestPtr InRequest, uint64 /*BytesSent*/, uint64 BytesReceived)
+            {
+                const FHttpResponsePtr Response = InRequest.IsValid() ? InRequest->GetResponse() : nullptr;
+                const int64 TotalBytes = Response.IsValid() ? FMath::Max<int64>(Response->GetContentLength(), 0) : 0;
+                OnProgress((int64)BytesReceived, TotalBytes);
+            });
+    }
+
+    Dispatch(Request, TEXT("/view"),
+        [OnComplete = MoveTemp(OnComplete), PartFile, PartPath, DestPath, Filename](bool bOk, FHttpResponsePtr Response)
+        {
+            const bool bWritten = PartFile->Close() && !PartFile->IsError();
+
+            IFileManager& FileManager = IFileManager::Get();
+            if (!bOk || !bWritten || !FileManager.Move(*DestPath, *PartPath, true, true))
+            {
+                UE_LOG(LogTemp, Error, TEXT("ComfyUI Client: Streamed /view failed for %s"), *Filename);
+                FileManager.Delete(*PartPath, false, true, true);
+                OnComplete(false, FString());
+                return;
+            }
+            OnComplete(true, DestPath);
+        });
+}
+
+void FComfyUIClient::UploadImage(const FString& LocalFilePath, FOnUploaded OnComplete, const FComfyUIUploadOptions& Options)
+{
+    // Explicit placement or overwrites always go to the server; the cache only knows plain input/ uploads
+    if (!Options.Subfolder.IsEmpty() || Options.bOverwrite)
+    {
+        PostUpload(LocalFilePath, 0, 0, Options, MoveTemp(OnComplete));
+        return;
+    }
+
+    TWeakPtr<FComfyUIClient> WeakClient = AsShared();
+
+    // Hashing a multi-MB plate on the game thread would hitch the editor
+    Async(EAsyncExecution::ThreadPool,
+        [WeakClient, LocalFilePath, Options, OnComplete = MoveTemp(OnComplete)]() mutable
+        {
+            uint64 Hash = 0;
+            int64 Size = 0;
+            const bool bRead = HashFile(LocalFilePath, Hash, Size);
+
+            AsyncTask(ENamedThreads::GameThread,
+                [WeakClient, LocalFilePath, Options, bRead, Hash, Size, OnComplete = MoveTemp(OnComplete)]() mutable
+                {
+                    TSharedPtr<FComfyUIClient> Client = WeakClient.Pin();
+                    if (!Client.IsValid() || !bRead)
+                    {
+                        UE_LOG(LogTemp, Error, TEXT("ComfyUI Client: Failed to read file for upload: %s"), *LocalFilePath);
+                        OnComplete(false, FString());
+                        return;
+                    }
+                    Client->UploadHashed(LocalFilePath, Hash, Size, Options, MoveTemp(OnComplete));
+                });
+        });
+}
+
+void FComfyUIClient::UploadImages(const TArray<FString>& LocalFilePaths, FOnUploadedAll OnComplete, const FComfyUIUploadOptions& Options)
+{
+    struct FUploadState
+    {
+        TArray<FString> StoredFilenames;
+        int32 Remaining = 0;
+        bool bAllSucceeded = true;
+        FOnUploadedAll OnComplete;
+    };
+    TSharedRef<FUploadState> State = MakeShared<FUploadState>();
+    State->StoredFilenames.SetNum(LocalFilePaths.Num());
+    State->Remaining = LocalFilePaths.Num();
+    State->OnComplete = MoveTemp(OnComplete);
+
+    if (LocalFilePaths.Num() == 0)
+    {
+        State->OnComplete(true, State->StoredFilenames);
+        return;
+    }
+
+    for (int32 Index = 0; Index < LocalFilePaths.Num(); ++Index)
+    {
+        UploadImage(LocalFilePaths[Index],
+            [State, Index](bool bSuccess, const FString& StoredFilename)
+            {
+                State->StoredFilenames[Index] = StoredFilename;
+                State->bAllSucceeded &= bSuccess;
+                if (--State->Remaining == 0)
+                    State->OnComplete(State->bAllSucceeded, State->StoredFilenames);
+            },
+            Options);
+    }
+}
+
+void FComfyUIClient::UploadHashed(const FString& LocalFilePath, uint64 Hash, int64 Size, const FComfyUIUploadOptions& Options, FOnUploaded OnComplete)
+{
+    // The Base URL can change while the request is out; the cache entry belongs to this one
+    const FString ServerUrl = GetBaseUrl();
+    const FComfyUIUploadCache::FEntry* Cached = FComfyUIUploadCache::Get().Find(ServerUrl, Hash);
+    if (!Cached || Cached->Size != Size)
+    {
+        PostUpload(LocalFilePath, Hash, Size, Options, MoveTemp(OnComplete));
+        return;
+    }
+
+    // The server may have been wiped or its input folder cleaned since, and a later upload
+    // may have taken the name. HEAD costs no body; its length must still be ours.
+    const FString StoredFilename = Cached->StoredFilename;
+    FString ViewSubfolder, ViewFilename;
+    if (!StoredFilename.Split(TEXT("/"), &ViewSubfolder, &ViewFilename, ESearchCase::CaseSensitive, ESearchDir::FromEnd))
+        ViewFilename = StoredFilename;
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = CreateRequest(TEXT("HEAD"), MakeViewPath(ViewFilename, ViewSubfolder, TEXT("input")));
+    TWeakPtr<FComfyUIClient> WeakClient = AsShared();
+
+    Dispatch(Request, TEXT("/view"),
+        [WeakClient, ServerUrl, LocalFilePath, Hash, Size, Options, StoredFilename, OnComplete = MoveTemp(OnComplete)](bool bOk, FHttpResponsePtr Response) mutable
+        {
+            const FString ContentLength = bOk && Response.IsValid() ? Response->GetHeader(TEXT("Content-Length")) : FString();
+            if (!ContentLength.IsEmpty() && FCString::Atoi64(*ContentLength) == Size)
+            {
+                UE_LOG(LogTemp, Log, TEXT("ComfyUI Client: %s already on server as %s, skipping upload"), *LocalFilePath, *StoredFilename);
+                OnComplete(true, StoredFilename);
+                return;
+            }
+
+            TSharedPtr<FComfyUIClient> Client = WeakClient.Pin();
+            if (!Client.IsValid())
+            {
+                OnComplete(false, FString());
+                return;
+            }
+            if (bOk)
+                UE_LOG(LogTemp, Log, TEXT("ComfyUI Client: Server's %s is no longer %s, uploading again"), *StoredFilename, *LocalFilePath);
+            FComfyUIUploadCache::Get().Remove(ServerUrl, Hash);
+            Client->PostUpload(LocalFilePath, Hash, Size, Options, MoveTemp(OnComplete));
+        });
+}
+
+void FComfyUIClient::PostUpload(const FString& LocalFilePath, uint64 Hash, int64 Size, const FComfyUIUploadOptions& Options, FOnUploaded OnComplete)
+{
+    const FString Filename = FPaths::GetCleanFilename(LocalFilePath);
+
+    // Only the multipart headers live in memory; the file is read as the request sends it
+    TSharedRef<FComfyUIMultipartBody, ESPMode::ThreadSafe> Body = MakeShared<FComfyUIMultipartBody, ESPMode::ThreadSafe>();
+    if (!Body->AddFile(TEXT("image"), LocalFilePath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("ComfyUI Client: Failed to read file for upload: %s"), *LocalFilePath);
+        OnComplete(false, FString());
+        return;
+    }
+    if (!Options.Subfolder.IsEmpty())
+    {
+        Body->AddField(TEXT("subfolder"), Options.Subfolder);
+    }
+    if (Options.bOverwrite)
+    {
+        Body->AddField(TEXT("overwrite"), TEXT("true"));
+    }
+    Body->Finish();
+
+    const FString ServerUrl = GetBaseUrl();
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = CreateRequest(TEXT("POST"), TEXT("/upload/image"));
+    Request->SetHeader(TEXT("Content-Type"), Body->GetContentType());
+    if (!Request->SetContentFromStream(Body))
+    {
+        UE_LOG(LogTemp, Error, TEXT("ComfyUI Client: Failed to stream upload body for %s"), *Filename);
+        OnComplete(false, FString());
+        return;
+    }
+
+    Dispatch(Request, TEXT("/upload/image"),
+        [OnComplete = MoveTemp(OnComplete), ServerUrl, Filename, Hash, Size](bool bOk, FHttpResponsePtr Response)
+        {
+            if (!bOk)
+            {
+                UE_LOG(LogTemp, Error, TEXT("ComfyUI Client: Upload failed for %s"), *Filename);
+                OnComplete(false, FString());
+                return;
+            }
+
+            // Response contains the name and subfolder ComfyUI stored it under. LoadImage
+            // resolves "subfolder/name" against the input folder, as the web UI sends it.
+            FString StoredFilename = Filename;
+            TSharedPtr<FJsonObject> JsonResponse;
+            const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
+            if (FJsonSerializer::Deserialize(Reader, JsonResponse) && JsonResponse.IsValid())
+            {
+                FString Name;
+                if (JsonResponse->TryGetStringField(TEXT("name"), Name))
+                    StoredFilename = Name;
+
+                FString Subfolder;
+                if (JsonResponse->TryGetStringField(TEXT("subfolder"), Subfolder) && !Subfolder.IsEmpty())
+                    StoredFilename = Subfolder + TEXT("/") + StoredFilename;
+            }
+
+            // Recorded under the server the upload went to, even if the Base URL has moved on
+            if (Hash != 0)
+                FComfyUIUploadCache::Get().Add(ServerUrl, Hash, StoredFilename, Size);
+
+            OnComplete(true, StoredFilename);
+        });
+}
@@ -0,0 +1,302 @@
+#include "ComfyUIHDRUtils.h"
+#include "ComfyUIImageUtils.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+namespace
+{
+    struct FTransferLUT
+    {
+        float Values[256];
+
+        explicit FTransferLUT(bool bSRGB)
+        {
+            for (int32 Index = 0; Index < 256; ++Index)
+            {
+                const float Encoded = Index / 255.0f;
+                if (!bSRGB)
+                    Values[Index] = FMath::Pow(Encoded, 2.2f);
+                else if (Encoded <= 0.04045f)
+                    Values[Index] = Encoded / 12.92f;
+                else
+                    Values[Index] = FMath::Pow((Encoded + 0.055f) / 1.055f, 2.4f);
+            }
+        }
+    };
+
+    const float* GetTransferLUT(EComfyUIHDROperator Operator)
+    {
+        static const FTransferLUT Gamma22(false);
+        static const FTransferLUT SRGB(true);
+        return Operator == EComfyUIHDROperator::LegacyBoost ? Gamma22.Values : SRGB.Values;
+    }
+
+    // Per-pixel scale as a function of the linear luminance, replicated across lanes.
+    // Luminance is always in [0,1] here since the inputs come from 8-bit values.
+    template<EComfyUIHDROperator Operator>
+    FORCEINLINE VectorRegister4Float ComputeScale(const VectorRegister4Float& Luminance, const FComfyUIHDRParams& Params)
+    {
+        const VectorRegister4Float One = VectorOne();
+
+        if constexpr (Operator == EComfyUIHDROperator::LegacyBoost)
+        {
+            // 1 + L^2 * 8
+            return VectorMultiplyAdd(VectorMultiply(Luminance, Luminance), VectorSetFloat1(8.0f), One);
+        }
+        else if constexpr (Operator == EComfyUIHDROperator::InverseReinhard)
+        {
+            // Inverse of Ld = L / (1 + L * (1 - 1/Max)) scaled back onto the color: the
+            // ratio L/Ld is 1 / (1 - Ld * (1 - 1/Max)), which is 1 at black and Max at white
+            const VectorRegister4Float Knee = VectorSetFloat1(1.0f - 1.0f / FMath::Max(Params.MaxLuminance, 1.0f));
+            return VectorReciprocalAccurate(VectorNegateMultiplyAdd(Luminance, Knee, One));
+        }
+        else
+        {
+            return One;
+        }
+    }
+
+    template<EComfyUIHDROperator Operator>
+    void ConvertRows(const FComfyUIDecodedImage& Source, FComfyUIHDRImage& OutImage, const FComfyUIHDRParams& Params)
+    {
+        const int32 Width = Source.Width;
+        const float* LUT = GetTransferLUT(Operator);
+        const float Exposure = FMath::Pow(2.0f, Params.ExposureEV);
+        const uint8* SrcPixels = Source.Pixels.GetData();
+        FLinearColor* DstPixels = OutImage.Pixels.GetData();
+
+        ParallelFor(Source.Height, [=, &Params](int32 Y)
+        {
+            const VectorRegister4Float LumaWeights = MakeVectorRegisterFloat(0.2126f, 0.7152f, 0.0722f, 0.0f);
+            const VectorRegister4Float ExposureScale = VectorSetFloat1(Exposure);
+
+            const uint8* Src = SrcPixels + (int64)Y * Width * 4;
+            FLinearColor* Dst = DstPixels + (int64)Y * Width;
+
+            for (int32 X = 0; X < Width; ++X, Src += 4)
+            {
+                // BGRA byte order in, RGBA out
+                const VectorRegister4Float Linear = MakeVectorRegisterFloat(LUT[Src[2]], LUT[Src[1]], LUT[Src[0]], 1.0f);
+                const VectorRegister4Float Scale = VectorMultiply(ComputeScale<Operator>(VectorDot3(Linear, LumaWeights), Params), ExposureScale);
+
+                VectorStore(VectorSet_W1(VectorMultiply(Linear, Scale)), &Dst[X].R);
+            }
+        });
+    }
+
+    FORCEINLINE FLinearColor ToLinear(const FLinearColor& Color) { return Color; }
+    FORCEINLINE FLinearColor ToLinear(const FFloat16Color& Color) { return Color.GetFloats(); }
+
+    // Maps a face-space direction to world space; see the texture build's TransformSideToWorldSpace
+    FVector3f CubeFaceToWorld(int32 Face, const FVector3f& Direction)
+    {
+        const float X = Direction.X, Y = Direction.Y, Z = Direction.Z;
+        FVector3f World;
+        switch (Face)
+        {
+        case 0:  World = FVector3f(+Z, -Y, -X); break;
+        case 1:  World = FVector3f(-Z, -Y, +X); break;
+        case 2:  World = FVector3f(+X, +Z, +Y); break;
+        case 3:  World = FVector3f(+X, -Z, -Y); break;
+        case 4:  World = FVector3f(+X, -Y, +Z); break;
+        default: World = FVector3f(-X, -Y, -Z); break;
+        }
+        // Unreal is Z-up: swap Y and Z
+        return FVector3f(World.X, World.Z, World.Y);
+    }
+
+    FLinearColor SampleEquirectBilinear(const FComfyUIHDRImage& Image, float U, float V)
+    {
+        const float PixelX = U * Image.Width - 0.5f;
+        const float PixelY = FMath::Clamp(V * Image.Height - 0.5f, 0.0f, (float)(Image.Height - 1));
+
+        const int32 X0 = FMath::FloorToInt32(PixelX);
+        const int32 Y0 = FMath::FloorToInt32(PixelY);
+        const float FracX = PixelX - X0;
+        const float FracY = PixelY - Y0;
+
+        // Longitude wraps around the seam, latitude clamps at the poles
+        const int32 WrappedX0 = (X0 % Image.Width + Image.Width) % Image.Width;
+        const int32 WrappedX1 = (WrappedX0 + 1) % Image.Width;
+        const int32 Y1 = FMath::Min(Y0 + 1, Image.Height - 1);
+
+        const FLinearColor* Row0 = Image.Pixels.GetData() + (int64)Y0 * Image.Width;
+        const FLinearColor* Row1 = Image.Pixels.GetData() + (int64)Y1 * Image.Width;
+
+        const FLinearColor Top = FMath::Lerp(Row0[WrappedX0], Row0[WrappedX1], FracX);
+        const FLinearColor Bottom = FMath::Lerp(Row1[WrappedX0], Row1[WrappedX1], FracX);
+        return FMath::Lerp(Top, Bottom, FracY);
+    }
+
+    template<typename PixelType>
+    void BakeCubeFacesImpl(const FComfyUIHDRImage& Equirect, int32 FaceSize, TConstArrayView<PixelType*> MipData)
+    {
+        if (!Equirect.IsValid() || MipData.Num() == 0)
+            return;
+
+        // Mip 0: one job per face row across all six faces
+        {
+            PixelType* Faces = MipData[0];
+            const float InvFaceSize = 1.0f / FaceSize;
+
+            ParallelFor(6 * FaceSize, [&](int32 FaceRow)
+            {
+                const int32 Face = FaceRow / FaceSize;
+                const int32 Y = FaceRow % FaceSize;
+                PixelType* Dst = Faces + ((int64)Face * FaceSize + Y) * FaceSize;
+
+                for (int32 X = 0; X < FaceSize; ++X)
+                {
+                    const FVector3f FaceDirection((X + 0.5f) * InvFaceSize * 2.0f - 1.0f, (Y + 0.5f) * InvFaceSize * 2.0f - 1.0f, 1.0f);
+                    const FVector3f Direction = CubeFaceToWorld(Face, FaceDirection.GetUnsafeNormal());
+
+                    const float U = (FMath::Atan2(Direction.Y, Direction.X) + UE_PI) / (2.0f * UE_PI);
+                    const float V = FMath::Acos(FMath::Clamp(Direction.Z, -1.0f, 1.0f)) / UE_PI;
+
+                    FLinearColor Color = SampleEquirectBilinear(Equirect, U, V);
+                    Color.A = 1.0f;
+                    Dst[X] = PixelType(Color);
+                }
+            });
+        }
+
+        // Each further mip averages 2x2 texels of the one above, face by face
+        for (int32 Mip = 1; Mip < MipData.Num(); ++Mip)
+        {
+            const int32 SrcSize = FMath::Max(FaceSize >> (Mip - 1), 1);
+            const int32 DstSize = FMath::Max(FaceSize >> Mip, 1);
+            const PixelType* SrcFaces = MipData[Mip - 1];
+            PixelType* DstFaces = MipData[Mip];
+
+            ParallelFor(6 * DstSize, [&](int32 FaceRow)
+            {
+                const int32 Face = FaceRow / DstSize;
+                const int32 Y = FaceRow % DstSize;
+                const PixelType* Src0 = SrcFaces + ((int64)Face * SrcSize + FMath::Min(Y * 2, SrcSize - 1)) * SrcSize;
+                const PixelType* Src1 = SrcFaces + ((int64)Face * SrcSize + FMath::Min(Y * 2 + 1, SrcSize - 1)) * SrcSize;
+                PixelType* Dst = DstFaces + ((int64)Face * DstSize + Y) * DstSize;
+
+                for (int32 X = 0; X < DstSize; ++X)
+                {
+                    const int32 SrcX0 = FMath::Min(X * 2, SrcSize - 1);
+                    const int32 SrcX1 = FMath::Min(X * 2 + 1, SrcSize - 1);
+                    const FLinearColor Sum = ToLinear(Src0[SrcX0]) + ToLinear(Src0[SrcX1]) + ToLinear(Src1[SrcX0]) + ToLinear(Src1[SrcX1]);
+                    Dst[X] = PixelType(Sum * 0.25f);
+                }
+            });
+        }
+    }
+
+    // ComfyUI.BenchmarkHDR [Width] [Height] [Iterations]
+    void BenchmarkOperators(const TArray<FString>& Args)
+    {
+        const int32 Width = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 8192;
+        const int32 Height = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 4096;
+        const int32 Iterations = Args.Num() > 2 ? FMath::Max(1, FCString::Atoi(*Args[2])) : 5;
+
+        // Noise rather than a flat color so the LUT lookups aren't trivially cached
+        FComfyUIDecodedImage Source;
+        Source.Width = Width;
+        Source.Height = Height;
+        Source.Pixels.SetNumUninitialized((int64)Width * Height * 4);
+        FRandomStream Random(Width ^ Height);
+        for (uint8& Byte : Source.Pixels)
+        {
+            Byte = (uint8)Random.RandHelper(256);
+        }
+
+        const double Megapixels = (double)Width * Height / 1.0e6;
+        const UEnum* OperatorEnum = StaticEnum<EComfyUIHDROperator>();
+
+        FComfyUIHDRImage Output;
+        for (int32 OperatorIndex = 0; OperatorIndex < OperatorEnum->NumEnums() - 1; ++OperatorIndex)
+        {
+            FComfyUIHDRParams Params;
+            Params.Operator = (EComfyUIHDROperator)OperatorEnum->GetValueByIndex(OperatorIndex);
+
+            // One untimed pass to warm up the thread pool and fault in the output pages
+            ComfyUIHDR::ConvertLDRToHDR(Source, Output, Params);
+
+            const double Start = FPlatformTime::Seconds();
+            for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+            {
+                ComfyUIHDR::ConvertLDRToHDR(Source, Output, Params);
+            }
+            const double Milliseconds = (FPlatformTime::Seconds() - Start) * 1000.0 / Iterations;
+
+            UE_LOG(LogTemp, Display, TEXT("ComfyUI HDR: %-16s %dx%d  %8.2f ms  %6.3f ms/MP"),
+                *OperatorEnum->GetNameStringByIndex(OperatorIndex), Width, Height, Milliseconds, Milliseconds / Megapixels);
+        }
+    }
+
+    FAutoConsoleCommand BenchmarkHDRCommand(
+        TEXT("ComfyUI.BenchmarkHDR"),
+        TEXT("Times every HDR expansion operator on a synthetic image. Args: [Width=8192] [Height=4096] [Iterations=5]"),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkOperators));
+}
+
+bool ComfyUIHDR::ConvertLDRToHDR(const FComfyUIDecodedImage& Source, FComfyUIHDRImage& OutImage, const FComfyUIHDRParams& Params)
+{
+    if (!Source.IsValid())
+    {
+        return false;
+    }
+
+    OutImage.Width = Source.Width;
+    OutImage.Height = Source.Height;
+    OutImage.Pixels.SetNumUninitialized((int64)Source.Width * Source.Height);
+
+    // Dispatch once so the per-pixel loop has no branch on the operator
+    switch (Params.Operator)
+    {
+    case EComfyUIHDROperator::SRGB:
+        ConvertRows<EComfyUIHDROperator::SRGB>(Source, OutImage, Params);
+        break;
+    case EComfyUIHDROperator::InverseReinhard:
+        ConvertRows<EComfyUIHDROperator::InverseReinhard>(Source, OutImage, Params);
+        break;
+    default:
+        ConvertRows<EComfyUIHDROperator::LegacyBoost>(Source, OutImage, Params);
+        break;
+    }
+
+    return true;
+}
+
+int32 ComfyUIHDR::GetCubeFaceSize(const FComfyUIHDRImage& Equirect, int32 RequestedSize)
+{
+    const int32 Size = RequestedSize > 0 ? RequestedSize : Equirect.Width / 4;
+    return (int32)FMath::Clamp<uint32>(FMath::RoundUpToPowerOfTwo((uint32)FMath::Max(Size, 1)), 32, 4096);
+}
+
+int32 ComfyUIHDR::GetCubeMipCount(int32 FaceSize)
+{
+    return FMath::FloorLog2((uint32)FMath::Max(FaceSize, 1)) + 1;
+}
+
+void ComfyUIHDR::BakeCubeFaces(const FComfyUIHDRImage& Equirect, int32 FaceSize, TConstArrayView<FLinearColor*> MipData)
+{
+    BakeCubeFacesImpl(Equirect, FaceSize, MipData);
+}
+
+void ComfyUIHDR::BakeCubeFaces(const FComfyUIHDRImage& Equirect, int32 FaceSize, TConstArrayView<FFloat16Color*> MipData)
+{
+    BakeCubeFacesImpl(Equirect, FaceSize, MipData);
+}
+
+void ComfyUIHDR::ConvertToHalf(const FComfyUIHDRImage& Image, FFloat16Color* OutPixels)
+{
+    const int32 Width = Image.Width;
+    const FLinearColor* SrcPixels = Image.Pixels.GetData();
+
+    ParallelFor(Image.Height, [=](int32 Y)
+    {
+        const FLinearColor* Src = SrcPixels + (int64)Y * Width;
+        FFloat16Color* Dst = OutPixels + (int64)Y * Width;
+        for (int32 X = 0; X < Width; ++X)
+        {
+            Dst[X] = FFloat16Color(Src[X]);
+        }
+    });
+}
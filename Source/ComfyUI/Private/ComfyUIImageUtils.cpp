@@ -0,0 +1,164 @@
+#include "ComfyUIImageUtils.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Engine/Texture2D.h"
+#include "TextureResource.h"
+#include "Modules/ModuleManager.h"
+#include "Misc/FileHelper.h"
+#include "Async/Async.h"
+
+void ComfyUIImage::PreloadImageWrapperModule()
+{
+    check(IsInGameThread());
+    FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+}
+
+bool ComfyUIImage::DecodeToBGRA(const void* CompressedData, int64 CompressedSize, FComfyUIDecodedImage& OutImage)
+{
+    IImageWrapperModule* ImageWrapperModule = FModuleManager::GetModulePtr<IImageWrapperModule>(FName("ImageWrapper"));
+    if (!ImageWrapperModule || !CompressedData || CompressedSize <= 0)
+    {
+        return false;
+    }
+
+    const EImageFormat Format = ImageWrapperModule->DetectImageFormat(CompressedData, CompressedSize);
+    if (Format == EImageFormat::Invalid)
+    {
+        return false;
+    }
+
+    TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule->CreateImageWrapper(Format);
+    if (!ImageWrapper.IsValid() || !ImageWrapper->SetCompressed(CompressedData, CompressedSize))
+    {
+        return false;
+    }
+
+    if (!ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, OutImage.Pixels))
+    {
+        return false;
+    }
+
+    OutImage.Width = ImageWrapper->GetWidth();
+    OutImage.Height = ImageWrapper->GetHeight();
+    return OutImage.IsValid();
+}
+
+UTexture2D* ComfyUIImage::CreateTransientTexture(FComfyUIDecodedImage&& Image)
+{
+    check(IsInGameThread());
+
+    if (!Image.IsValid())
+    {
+        return nullptr;
+    }
+
+    UTexture2D* Texture = UTexture2D::CreateTransient(Image.Width, Image.Height, PF_B8G8R8A8);
+    if (!Texture)
+    {
+        return nullptr;
+    }
+
+    // The decoder can only hand back its own array, so this copy is the one left.
+    // The decoded buffer is released straight after it instead of living on in a
+    // render command next to the mip.
+    FByteBulkData& BulkData = Texture->GetPlatformData()->Mips[0].BulkData;
+    FMemory::Memcpy(BulkData.Lock(LOCK_READ_WRITE), Image.Pixels.GetData(), Image.Pixels.Num());
+    BulkData.Unlock();
+    Image.Pixels.Empty();
+
+    // Single use lets the render resource take the mip allocation as its initial
+    // data instead of copying it, and frees it once the upload is done
+    BulkData.SetBulkDataFlags(BULKDATA_SingleUse);
+    Texture->UpdateResource();
+
+    return Texture;
+}
+
+UTexture2D* ComfyUIImage::UpdateOrCreateTransientTexture(UTexture2D* Existing, FComfyUIDecodedImage&& Image)
+{
+    check(IsInGameThread());
+
+    if (!Image.IsValid())
+    {
+        return Existing;
+    }
+
+    const bool bCanReuse = Existing
+        && Existing->GetSizeX() == Image.Width
+        && Existing->GetSizeY() == Image.Height
+        && Existing->GetPixelFormat() == PF_B8G8R8A8
+        && Existing->GetResource() != nullptr;
+
+    // A single-use mip is freed by the first upload, so once its resource is released
+    // nothing can bring the pixels back. Falling through to a fresh texture recovers,
+    // but would hide the caller that broke CreateTransientTexture's contract. A
+    // re-created resource goes black the same way but can't be told apart from here.
+    if (Existing && Existing->GetPlatformData() && Existing->GetPlatformData()->Mips.Num() > 0)
+    {
+        const bool bSingleUse = (Existing->GetPlatformData()->Mips[0].BulkData.GetBulkDataFlags() & BULKDATA_SingleUse) != 0;
+        ensureMsgf(!bSingleUse || Existing->GetResource() != nullptr,
+            TEXT("ComfyUI Image: Transient texture %s lost its render resource and no longer holds any pixels"),
+            *Existing->GetName());
+    }
+
+    if (!bCanReuse)
+    {
+        UTexture2D* Texture = CreateTransientTexture(MoveTemp(Image));
+        return Texture ? Texture : Existing;
+    }
+
+    // Region and pixel buffer must outlive the render command; the cleanup
+    // function runs on the render thread once the upload is done
+    FUpdateTextureRegion2D* Region = new FUpdateTextureRegion2D(0, 0, 0, 0, Image.Width, Image.Height);
+    TArray64<uint8>* Pixels = new TArray64<uint8>(MoveTemp(Image.Pixels));
+
+    Existing->UpdateTextureRegions(0, 1, Region, Image.Width * 4, 4, Pixels->GetData(),
+        [Pixels](uint8*, const FUpdateTextureRegion2D* InRegions)
+        {
+            delete Pixels;
+            delete InRegions;
+        });
+
+    return Existing;
+}
+
+TFuture<FComfyUIDecodedImage> ComfyUIImage::DecodeFileAsync(const FString& FilePath)
+{
+    PreloadImageWrapperModule();
+
+    return Async(EAsyncExecution::ThreadPool, [FilePath]()
+    {
+        FComfyUIDecodedImage Image;
+
+        TArray64<uint8> RawFileData;
+        if (!FFileHelper::LoadFileToArray(RawFileData, *FilePath))
+        {
+            UE_LOG(LogTemp, Error, TEXT("ComfyUI: Failed to load file: %s"), *FilePath);
+            return Image;
+        }
+
+        if (!DecodeToBGRA(RawFileData.GetData(), RawFileData.Num(), Image))
+        {
+            UE_LOG(LogTemp, Error, TEXT("ComfyUI: Failed to decompress image: %s"), *FilePath);
+            Image = FComfyUIDecodedImage();
+        }
+        return Image;
+    });
+}
+
+TFuture<UTexture2D*> ComfyUIImage::LoadImageFromFileAsync(const FString& FilePath)
+{
+    TSharedRef<TPromise<UTexture2D*>> Promise = MakeShared<TPromise<UTexture2D*>>();
+    TFuture<UTexture2D*> Result = Promise->GetFuture();
+
+    DecodeFileAsync(FilePath).Then([Promise](TFuture<FComfyUIDecodedImage> Decoded)
+    {
+        // Only the texture creation and upload happen on the game thread
+        AsyncTask(ENamedThreads::GameThread, [Promise, Image = Decoded.Consume()]() mutable
+        {
+            Promise->SetValue(CreateTransientTexture(MoveTemp(Image)));
+        });
+    });
+
+    return Result;
+}
@@ -1,9 +1,15 @@
 #include "ComfyUIModule.h"
+#include "ComfyUIBackendPool.h"
+#include "ComfyUIBlueprintLibrary.h"
+#include "ComfyUIClient.h"
+#include "ComfyUIOutputIndex.h"
 #include "ComfyUISettings.h"
+#include "ComfyUIUploadCache.h"
 #include "ComfyUIWebSocketHandler.h"
 #include "HAL/PlatformProcess.h"
 #include "Misc/Paths.h"
 #include "Interfaces/IPluginManager.h"
+#include "Misc/CoreDelegates.h"
 
 #if WITH_EDITOR
 #include "ISettingsModule.h"
@@ -13,12 +19,31 @@ void FComfyUIModule::StartupModule()
 {
     UE_LOG(LogTemp, Warning, TEXT("ComfyUI: Module started"));
 
-    // Create WebSocket handler
-    WebSocketHandler = MakeShared<FComfyUIWebSocketHandler>();
+    // Create shared HTTP client and WebSocket handler
+    TSharedRef<FComfyUIClient> DefaultClient = MakeShared<FComfyUIClient>();
+    TSharedRef<FComfyUIWebSocketHandler> DefaultWebSocket = MakeShared<FComfyUIWebSocketHandler>(DefaultClient);
+    Client = DefaultClient;
+    WebSocketHandler = DefaultWebSocket;
+    BackendPool = MakeShared<FComfyUIBackendPool>(DefaultClient, DefaultWebSocket);
+    OutputIndex = MakeShared<FComfyUIOutputIndex>();
+
+    // Settings can't be read this early in startup; if the engine is already up, prime now
+    if (GIsRunning)
+        PrimeOutputIndex();
+    else
+        FCoreDelegates::OnPostEngineInit.AddRaw(this, &FComfyUIModule::PrimeOutputIndex);
 }
 
 void FComfyUIModule::ShutdownModule()
 {
+    FCoreDelegates::OnPostEngineInit.RemoveAll(this);
+
+    if (BackendPool.IsValid())
+    {
+        BackendPool->Shutdown();
+        BackendPool.Reset();
+    }
+
     // Clean up WebSocket
     if (WebSocketHandler.IsValid())
     {
@@ -26,6 +51,21 @@ void FComfyUIModule::ShutdownModule()
         WebSocketHandler.Reset();
     }
 
+    if (Client.IsValid())
+    {
+        Client->LogStats();
+        Client.Reset();
+    }
+
+    if (OutputIndex.IsValid())
+    {
+        OutputIndex->Shutdown();
+        OutputIndex.Reset();
+    }
+
+    // Uploads recorded since the last timed save
+    FComfyUIUploadCache::Get().Flush();
+
     // Clean up if ComfyUI is running
     if (PortableHandle.IsValid())
     {
@@ -144,4 +184,32 @@ TSharedPtr<FComfyUIWebSocketHandler> FComfyUIModule::GetWebSocketHandler()
     return WebSocketHandler;
 }
 
+TSharedPtr<FComfyUIClient> FComfyUIModule::GetClient()
+{
+    return Client;
+}
+
+TSharedPtr<FComfyUIBackendPool> FComfyUIModule::GetBackendPool()
+{
+    return BackendPool;
+}
+
+TSharedPtr<FComfyUIOutputIndex> FComfyUIModule::GetOutputIndex()
+{
+    return OutputIndex;
+}
+
+void FComfyUIModule::PrimeOutputIndex()
+{
+    // Auto-detecting the portable folder logs errors when there is none; leave that case
+    // to the first lookup instead of reporting it on every editor start
+    const UComfyUISettings* Settings = GetDefault<UComfyUISettings>();
+    if (!OutputIndex.IsValid() || !Settings || Settings->GetEffectivePortableRoot().IsEmpty())
+        return;
+
+    const FString OutputFolder = UComfyUIBlueprintLibrary::GetComfyUIOutputFolder();
+    if (FPaths::DirectoryExists(OutputFolder))
+        OutputIndex->SetFolder(OutputFolder);
+}
+
 IMPLEMENT_MODULE(FComfyUIModule, ComfyUI)
@@ -0,0 +1,151 @@
+#include "ComfyUIMultipartBody.h"
+#include "HAL/PlatformFileManager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+#include "Algo/BinarySearch.h"
+
+namespace
+{
+    FString GetMimeType(const FString& FilePath)
+    {
+        const FString Extension = FPaths::GetExtension(FilePath).ToLower();
+        if (Extension == TEXT("png"))
+            return TEXT("image/png");
+        if (Extension == TEXT("jpg") || Extension == TEXT("jpeg"))
+            return TEXT("image/jpeg");
+        if (Extension == TEXT("webp"))
+            return TEXT("image/webp");
+        return TEXT("application/octet-stream");
+    }
+}
+
+FComfyUIMultipartBody::FComfyUIMultipartBody()
+    // Random so it can't collide with anything inside a streamed file we never look at
+    : Boundary(TEXT("----ComfyUIBoundary") + FGuid::NewGuid().ToString(EGuidFormats::Digits))
+{
+    SetIsLoading(true);
+    SetIsPersistent(false);
+}
+
+FComfyUIMultipartBody::~FComfyUIMultipartBody()
+{
+    Close();
+}
+
+void FComfyUIMultipartBody::AddField(const FString& Name, const FString& Value)
+{
+    check(!bFinished);
+    AppendText(FString::Printf(TEXT("--%s\r\nContent-Disposition: form-data; name=\"%s\"\r\n\r\n%s\r\n"), *Boundary, *Name, *Value));
+}
+
+bool FComfyUIMultipartBody::AddFile(const FString& Name, const FString& FilePath)
+{
+    check(!bFinished);
+
+    const int64 FileSize = FPlatformFileManager::Get().GetPlatformFile().FileSize(*FilePath);
+    if (FileSize < 0)
+        return false;
+
+    AppendText(FString::Printf(TEXT("--%s\r\nContent-Disposition: form-data; name=\"%s\"; filename=\"%s\"\r\nContent-Type: %s\r\n\r\n"),
+        *Boundary, *Name, *FPaths::GetCleanFilename(FilePath), *GetMimeType(FilePath)));
+
+    FPart& Part = Parts.AddDefaulted_GetRef();
+    Part.FilePath = FilePath;
+    Part.Offset = Size;
+    Part.Length = FileSize;
+    Size += FileSize;
+
+    AppendText(TEXT("\r\n"));
+    return true;
+}
+
+void FComfyUIMultipartBody::Finish()
+{
+    if (bFinished)
+        return;
+
+    AppendText(FString::Printf(TEXT("--%s--\r\n"), *Boundary));
+    bFinished = true;
+}
+
+FString FComfyUIMultipartBody::GetContentType() const
+{
+    return FString::Printf(TEXT("multipart/form-data; boundary=%s"), *Boundary);
+}
+
+void FComfyUIMultipartBody::AppendText(const FString& Text)
+{
+    FTCHARToUTF8 Converted(*Text);
+
+    // Consecutive text shares one part, so a body has at most two parts per file plus one
+    FPart* Part = Parts.Num() > 0 && Parts.Last().FilePath.IsEmpty() ? &Parts.Last() : nullptr;
+    if (!Part)
+    {
+        Part = &Parts.AddDefaulted_GetRef();
+        Part->Offset = Size;
+    }
+
+    Part->Bytes.Append((const uint8*)Converted.Get(), Converted.Length());
+    Part->Length += Converted.Length();
+    Size += Converted.Length();
+}
+
+void FComfyUIMultipartBody::Serialize(void* Data, int64 Num)
+{
+    uint8* Dest = static_cast<uint8*>(Data);
+
+    if (Num < 0 || Pos + Num > Size)
+    {
+        SetError();
+        return;
+    }
+
+    int32 PartIndex = Algo::UpperBoundBy(Parts, Pos, &FPart::Offset) - 1;
+    while (Num > 0 && Parts.IsValidIndex(PartIndex))
+    {
+        const FPart& Part = Parts[PartIndex];
+        const int64 PartPos = Pos - Part.Offset;
+        const int64 Count = FMath::Min(Num, Part.Length - PartPos);
+
+        if (Part.FilePath.IsEmpty())
+        {
+            FMemory::Memcpy(Dest, Part.Bytes.GetData() + PartPos, Count);
+        }
+        else
+        {
+            if (OpenPart != PartIndex)
+            {
+                OpenFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Part.FilePath));
+                OpenPart = PartIndex;
+            }
+
+            if (!OpenFile.IsValid()
+                || (OpenFile->Tell() != PartPos && !OpenFile->Seek(PartPos))
+                || !OpenFile->Read(Dest, Count))
+            {
+                UE_LOG(LogTemp, Error, TEXT("ComfyUI Upload: Failed to read %s while sending"), *Part.FilePath);
+                SetError();
+                return;
+            }
+        }
+
+        Dest += Count;
+        Pos += Count;
+        Num -= Count;
+        ++PartIndex;
+    }
+}
+
+void FComfyUIMultipartBody::Seek(int64 InPos)
+{
+    // Retries rewind the body; the file handle seeks lazily on the next read
+    Pos = FMath::Clamp<int64>(InPos, 0, Size);
+}
+
+bool FComfyUIMultipartBody::Close()
+{
+    OpenFile.Reset();
+    OpenPart = INDEX_NONE;
+    return !IsError();
+}
@@ -0,0 +1,402 @@
+#include "ComfyUIOutputIndex.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Algo/BinarySearch.h"
+
+#if WITH_EDITOR
+#include "DirectoryWatcherModule.h"
+#include "IDirectoryWatcher.h"
+#endif
+
+namespace
+{
+    constexpr int32 IndexFileVersion = 1;
+
+    bool IsOutputImage(const FString& Filename)
+    {
+        return FPaths::GetExtension(Filename).Equals(TEXT("png"), ESearchCase::IgnoreCase);
+    }
+
+    /** Whether a file named "<Key>_<counter>_.png" could start with Prefix, given Prefix extends Key */
+    bool CouldMatchCounter(const FString& Key, const FString& Prefix)
+    {
+        const FString Rest = Prefix.Mid(Key.Len());
+        if (!Rest.StartsWith(TEXT("_")))
+            return false;
+
+        int32 Index = 1;
+        while (Index < Rest.Len() && FChar::IsDigit(Rest[Index]))
+            ++Index;
+        return FString(TEXT("_.png")).StartsWith(Rest.Mid(Index));
+    }
+}
+
+FComfyUIOutputIndex::~FComfyUIOutputIndex()
+{
+    StopWatching();
+}
+
+void FComfyUIOutputIndex::SetFolder(const FString& InFolder)
+{
+    const FString FullFolder = FPaths::ConvertRelativePathToFull(InFolder);
+    if (!Folder.IsEmpty() && FPaths::IsSamePath(FullFolder, Folder))
+        return;
+
+    if (!Folder.IsEmpty())
+        Shutdown();
+
+    Folder = FullFolder;
+    Groups.Reset();
+    SortedKeys.Reset();
+    ChangedDuringScan.Reset();
+    bDirty = false;
+
+    Load();
+    StartWatching();
+    StartScan();
+}
+
+FString FComfyUIOutputIndex::FindLatest(const FString& FilenamePrefix)
+{
+#if !WITH_EDITOR
+    // Nothing tells us about new files, but adding or removing one moves the folder's
+    // timestamp, so a single stat decides whether the listing is needed. A change since
+    // the last listing is what the caller is looking for, so that scan is waited on.
+    if (!PendingScan.IsValid() && IFileManager::Get().GetTimeStamp(*Folder) != ScannedFolderTime)
+    {
+        StartScan();
+        FinishScan();
+    }
+#endif
+
+    // The startup scan only adds what appeared while the editor was closed; answer from
+    // the loaded index until it lands, and wait for it only if that index has no answer
+    if (PendingScan.IsValid() && PendingScan.IsReady())
+        FinishScan();
+
+    FString Latest = FindLatestIndexed(FilenamePrefix);
+    if (Latest.IsEmpty() && PendingScan.IsValid())
+    {
+        FinishScan();
+        Latest = FindLatestIndexed(FilenamePrefix);
+    }
+    return Latest;
+}
+
+FString FComfyUIOutputIndex::FindLatestIndexed(const FString& FilenamePrefix) const
+{
+    const FEntry* Latest = nullptr;
+
+    // Groups whose key starts with the prefix match entirely; their newest entry is first
+    for (int32 KeyIndex = Algo::LowerBound(SortedKeys, FilenamePrefix);
+        KeyIndex < SortedKeys.Num() && SortedKeys[KeyIndex].StartsWith(FilenamePrefix);
+        ++KeyIndex)
+    {
+        const FEntry& Newest = Groups.FindChecked(SortedKeys[KeyIndex])[0];
+        if (!Latest || Newest.Ticks > Latest->Ticks)
+            Latest = &Newest;
+    }
+
+    // The prefix may reach into a counter (e.g. "ComfyUI_0004"), so only some files of the
+    // group named by the text before an underscore match. Walk from the newest until
+    // nothing can beat Latest.
+    for (int32 Separator = FilenamePrefix.Find(TEXT("_")); Separator != INDEX_NONE;
+        Separator = FilenamePrefix.Find(TEXT("_"), ESearchCase::CaseSensitive, ESearchDir::FromStart, Separator + 1))
+    {
+        const FString Key = FilenamePrefix.Left(Separator);
+        const TArray<FEntry>* Group = Groups.Find(Key);
+        if (!Group || !CouldMatchCounter(Key, FilenamePrefix))
+            continue;
+
+        for (const FEntry& Entry : *Group)
+        {
+            if (Latest && Entry.Ticks <= Latest->Ticks)
+                break;
+            if (Entry.Filename.StartsWith(FilenamePrefix))
+            {
+                Latest = &Entry;
+                break;
+            }
+        }
+    }
+
+    return Latest ? FPaths::Combine(Folder, Latest->Filename) : FString();
+}
+
+void FComfyUIOutputIndex::Shutdown()
+{
+    StopWatching();
+    FinishScan();
+    Save();
+}
+
+FString FComfyUIOutputIndex::GetGroupKey(const FString& Filename)
+{
+    // "<prefix>_<counter>_" -> "<prefix>"; anything else is its own group
+    const FString Base = FPaths::GetBaseFilename(Filename);
+
+    int32 End = Base.Len();
+    if (End > 0 && Base[End - 1] == TEXT('_'))
+        --End;
+
+    int32 DigitsStart = End;
+    while (DigitsStart > 0 && FChar::IsDigit(Base[DigitsStart - 1]))
+        --DigitsStart;
+
+    if (DigitsStart < End && DigitsStart > 0 && Base[DigitsStart - 1] == TEXT('_'))
+        return Base.Left(DigitsStart - 1);
+    return Base;
+}
+
+FString FComfyUIOutputIndex::GetIndexPath()
+{
+    return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ComfyUI"), TEXT("OutputIndex.bin"));
+}
+
+void FComfyUIOutputIndex::Insert(FEntry&& Entry)
+{
+    const FString Key = GetGroupKey(Entry.Filename);
+    TArray<FEntry>* Group = Groups.Find(Key);
+    if (!Group)
+    {
+        SortedKeys.Insert(Key, Algo::LowerBound(SortedKeys, Key));
+        Group = &Groups.Add(Key);
+    }
+
+    // Loading the saved index arrives oldest last, so that case appends
+    if (Group->Num() == 0 || Entry.Ticks <= Group->Last().Ticks)
+    {
+        Group->Add(MoveTemp(Entry));
+    }
+    else
+    {
+        const int32 InsertAt = Algo::UpperBoundBy(*Group, Entry.Ticks, &FEntry::Ticks, TGreater<>());
+        Group->Insert(MoveTemp(Entry), InsertAt);
+    }
+}
+
+bool FComfyUIOutputIndex::Remove(const FString& Filename)
+{
+    const FString Key = GetGroupKey(Filename);
+    TArray<FEntry>* Group = Groups.Find(Key);
+    if (!Group)
+        return false;
+
+    const int32 Index = Group->IndexOfByPredicate([&Filename](const FEntry& Entry) { return Entry.Filename == Filename; });
+    if (Index == INDEX_NONE)
+        return false;
+
+    Group->RemoveAt(Index);
+    if (Group->Num() == 0)
+    {
+        Groups.Remove(Key);
+        SortedKeys.RemoveAt(Algo::BinarySearch(SortedKeys, Key));
+    }
+    return true;
+}
+
+void FComfyUIOutputIndex::StartScan()
+{
+    if (PendingScan.IsValid() || Folder.IsEmpty())
+        return;
+
+    TSet<FString> Known;
+    for (const TPair<FString, TArray<FEntry>>& Group : Groups)
+    {
+        for (const FEntry& Entry : Group.Value)
+            Known.Add(Entry.Filename);
+    }
+    ScannedFolderTime = IFileManager::Get().GetTimeStamp(*Folder);
+
+    PendingScan = Async(EAsyncExecution::ThreadPool, [ScanFolder = Folder, Known = MoveTemp(Known)]()
+    {
+        FScanResult Result;
+        IFileManager::Get().FindFiles(Result.Filenames, *FPaths::Combine(ScanFolder, TEXT("*.png")), true, false);
+
+        for (const FString& Filename : Result.Filenames)
+        {
+            if (Known.Contains(Filename))
+                continue;
+
+            const FDateTime TimeStamp = IFileManager::Get().GetTimeStamp(*FPaths::Combine(ScanFolder, Filename));
+            if (TimeStamp != FDateTime::MinValue())
+                Result.NewEntries.Add({ Filename, TimeStamp.GetTicks() });
+        }
+        return Result;
+    });
+}
+
+void FComfyUIOutputIndex::FinishScan()
+{
+    if (!PendingScan.IsValid())
+        return;
+
+    ApplyScan(PendingScan.Get());
+    PendingScan.Reset();
+    ChangedDuringScan.Reset();
+}
+
+void FComfyUIOutputIndex::ApplyScan(const FScanResult& Result)
+{
+    int32 NumAdded = 0;
+    for (const FEntry& Entry : Result.NewEntries)
+    {
+        if (!ChangedDuringScan.Contains(Entry.Filename))
+        {
+            Insert(FEntry(Entry));
+            ++NumAdded;
+        }
+    }
+
+    const TSet<FString> Present(Result.Filenames);
+    int32 NumRemoved = 0;
+    for (auto It = Groups.CreateIterator(); It; ++It)
+    {
+        NumRemoved += It.Value().RemoveAll([this, &Present](const FEntry& Entry)
+        {
+            return !Present.Contains(Entry.Filename) && !ChangedDuringScan.Contains(Entry.Filename);
+        });
+        if (It.Value().Num() == 0)
+        {
+            SortedKeys.RemoveAt(Algo::BinarySearch(SortedKeys, It.Key()));
+            It.RemoveCurrent();
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("ComfyUI Output Index: %d files in %s (%d new, %d gone since last scan)"),
+        Result.Filenames.Num(), *Folder, NumAdded, NumRemoved);
+
+    if (NumAdded > 0 || NumRemoved > 0)
+        bDirty = true;
+}
+
+void FComfyUIOutputIndex::StartWatching()
+{
+#if WITH_EDITOR
+    if (!FPaths::DirectoryExists(Folder))
+        return;
+
+    FDirectoryWatcherModule& WatcherModule = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+    if (IDirectoryWatcher* Watcher = WatcherModule.Get())
+    {
+        Watcher->RegisterDirectoryChangedCallback_Handle(Folder,
+            IDirectoryWatcher::FDirectoryChanged::CreateRaw(this, &FComfyUIOutputIndex::OnDirectoryChanged),
+            WatcherHandle);
+    }
+#endif
+}
+
+void FComfyUIOutputIndex::StopWatching()
+{
+#if WITH_EDITOR
+    if (!WatcherHandle.IsValid())
+        return;
+
+    if (FDirectoryWatcherModule* WatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")))
+    {
+        if (IDirectoryWatcher* Watcher = WatcherModule->Get())
+            Watcher->UnregisterDirectoryChangedCallback_Handle(Folder, WatcherHandle);
+    }
+    WatcherHandle.Reset();
+#endif
+}
+
+void FComfyUIOutputIndex::OnDirectoryChanged(const TArray<FFileChangeData>& Changes)
+{
+#if WITH_EDITOR
+    bool bRescan = false;
+
+    for (const FFileChangeData& Change : Changes)
+    {
+        if (Change.Action == FFileChangeData::FCA_RescanRequired)
+        {
+            bRescan = true;
+            continue;
+        }
+
+        // The watcher reports subfolders too; ComfyUI only looks at the top level
+        if (!IsOutputImage(Change.Filename) || !FPaths::IsSamePath(FPaths::GetPath(Change.Filename), Folder))
+            continue;
+
+        const FString Filename = FPaths::GetCleanFilename(Change.Filename);
+        if (PendingScan.IsValid())
+            ChangedDuringScan.Add(Filename);
+
+        Remove(Filename);
+        if (Change.Action != FFileChangeData::FCA_Removed)
+        {
+            const FDateTime TimeStamp = IFileManager::Get().GetTimeStamp(*Change.Filename);
+            if (TimeStamp != FDateTime::MinValue())
+                Insert({ Filename, TimeStamp.GetTicks() });
+        }
+        bDirty = true;
+    }
+
+    if (bRescan)
+    {
+        FinishScan();
+        StartScan();
+    }
+#endif
+}
+
+void FComfyUIOutputIndex::Load()
+{
+    TArray<uint8> Data;
+    if (!FFileHelper::LoadFileToArray(Data, *GetIndexPath(), FILEREAD_Silent))
+        return;
+
+    FMemoryReader Reader(Data);
+    int32 Version = 0;
+    FString SavedFolder;
+    Reader << Version << SavedFolder;
+    if (Reader.IsError() || Version != IndexFileVersion || !FPaths::IsSamePath(SavedFolder, Folder))
+        return;
+
+    int32 NumEntries = 0;
+    Reader << NumEntries;
+    for (int32 Index = 0; Index < NumEntries && !Reader.IsError(); ++Index)
+    {
+        FEntry Entry;
+        Reader << Entry.Filename << Entry.Ticks;
+        Insert(MoveTemp(Entry));
+    }
+
+    if (Reader.IsError())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ComfyUI Output Index: Ignoring unreadable index file %s"), *GetIndexPath());
+        Groups.Reset();
+        SortedKeys.Reset();
+    }
+}
+
+void FComfyUIOutputIndex::Save()
+{
+    if (!bDirty || Folder.IsEmpty())
+        return;
+
+    int32 NumEntries = 0;
+    for (const TPair<FString, TArray<FEntry>>& Group : Groups)
+        NumEntries += Group.Value.Num();
+
+    TArray<uint8> Data;
+    FMemoryWriter Writer(Data);
+    int32 Version = IndexFileVersion;
+    Writer << Version << Folder << NumEntries;
+
+    // Groups are written newest first, so loading appends without reordering
+    for (TPair<FString, TArray<FEntry>>& Group : Groups)
+    {
+        for (FEntry& Entry : Group.Value)
+            Writer << Entry.Filename << Entry.Ticks;
+    }
+
+    if (FFileHelper::SaveArrayToFile(Data, *GetIndexPath()))
+        bDirty = false;
+    else
+        UE_LOG(LogTemp, Warning, TEXT("ComfyUI Output Index: Failed to write %s"), *GetIndexPath());
+}
@@ -8,6 +8,15 @@ UComfyUISettings::UComfyUISettings()
 	SectionName = TEXT("ComfyUI");
 }
 
+FComfyUIHDRParams UComfyUISettings::GetHDRParams() const
+{
+	FComfyUIHDRParams Params;
+	Params.Operator = HDROperator;
+	Params.MaxLuminance = HDRMaxLuminance;
+	Params.ExposureEV = HDRExposureEV;
+	return Params;
+}
+
 FString UComfyUISettings::GetEffectivePortableRoot() const
 {
 	// If user explicitly set a path, use it
@@ -0,0 +1,165 @@
+#include "ComfyUIUploadCache.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+    // Keeps the file small; each entry is one short line
+    constexpr int32 MaxEntriesPerServer = 1024;
+
+    // Uploads tend to come in bursts (a batch of plates); one write covers the burst
+    constexpr float SaveDelaySeconds = 5.0f;
+}
+
+FComfyUIUploadCache& FComfyUIUploadCache::Get()
+{
+    static FComfyUIUploadCache Instance;
+    return Instance;
+}
+
+FComfyUIUploadCache::~FComfyUIUploadCache()
+{
+    // Static destruction is too late to write files; the module flushes on shutdown
+    if (SaveTickerHandle.IsValid())
+        FTSTicker::GetCoreTicker().RemoveTicker(SaveTickerHandle);
+}
+
+const FComfyUIUploadCache::FEntry* FComfyUIUploadCache::Find(const FString& ServerUrl, uint64 Hash)
+{
+    LoadIfNeeded();
+
+    const TMap<uint64, FEntry>* Server = Entries.Find(ServerUrl);
+    return Server ? Server->Find(Hash) : nullptr;
+}
+
+void FComfyUIUploadCache::Add(const FString& ServerUrl, uint64 Hash, const FString& StoredFilename, int64 Size)
+{
+    LoadIfNeeded();
+
+    TMap<uint64, FEntry>& Server = Entries.FindOrAdd(ServerUrl);
+
+    // No recency tracking: a full server starts over, costing at most one re-upload per image
+    if (Server.Num() >= MaxEntriesPerServer && !Server.Contains(Hash))
+    {
+        Server.Reset();
+    }
+    Server.Add(Hash, { StoredFilename, Size });
+    ScheduleSave();
+}
+
+void FComfyUIUploadCache::Remove(const FString& ServerUrl, uint64 Hash)
+{
+    LoadIfNeeded();
+
+    TMap<uint64, FEntry>* Server = Entries.Find(ServerUrl);
+    if (Server && Server->Remove(Hash) > 0)
+    {
+        ScheduleSave();
+    }
+}
+
+void FComfyUIUploadCache::Flush()
+{
+    if (SaveTickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(SaveTickerHandle);
+        SaveTickerHandle.Reset();
+    }
+    Save();
+}
+
+void FComfyUIUploadCache::LoadIfNeeded()
+{
+    if (bLoaded)
+        return;
+    bLoaded = true;
+
+    FString Json;
+    if (!FFileHelper::LoadFileToString(Json, *GetCachePath()))
+        return;
+
+    TSharedPtr<FJsonObject> Root;
+    const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
+    if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ComfyUI Upload Cache: Ignoring unreadable cache file %s"), *GetCachePath());
+        return;
+    }
+
+    for (const TPair<FString, TSharedPtr<FJsonValue>>& ServerPair : Root->Values)
+    {
+        const TSharedPtr<FJsonObject>* ServerObject;
+        if (!ServerPair.Value->TryGetObject(ServerObject))
+            continue;
+
+        TMap<uint64, FEntry>& Server = Entries.FindOrAdd(ServerPair.Key);
+        for (const TPair<FString, TSharedPtr<FJsonValue>>& EntryPair : (*ServerObject)->Values)
+        {
+            // Entries without a size can't be validated and are dropped
+            const TSharedPtr<FJsonObject>* EntryObject;
+            FEntry Entry;
+            if (EntryPair.Value->TryGetObject(EntryObject)
+                && (*EntryObject)->TryGetStringField(TEXT("name"), Entry.StoredFilename)
+                && (*EntryObject)->TryGetNumberField(TEXT("size"), Entry.Size))
+            {
+                Server.Add(FCString::Strtoui64(*EntryPair.Key, nullptr, 16), MoveTemp(Entry));
+            }
+        }
+    }
+}
+
+void FComfyUIUploadCache::ScheduleSave()
+{
+    bDirty = true;
+    if (SaveTickerHandle.IsValid())
+        return;
+
+    SaveTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+        FTickerDelegate::CreateRaw(this, &FComfyUIUploadCache::OnSaveTick), SaveDelaySeconds);
+}
+
+bool FComfyUIUploadCache::OnSaveTick(float DeltaTime)
+{
+    SaveTickerHandle.Reset();
+    Save();
+
+    // One-shot
+    return false;
+}
+
+void FComfyUIUploadCache::Save()
+{
+    if (!bDirty)
+        return;
+
+    TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+    for (const TPair<FString, TMap<uint64, FEntry>>& ServerPair : Entries)
+    {
+        TSharedRef<FJsonObject> ServerObject = MakeShared<FJsonObject>();
+        for (const TPair<uint64, FEntry>& EntryPair : ServerPair.Value)
+        {
+            TSharedRef<FJsonObject> EntryObject = MakeShared<FJsonObject>();
+            EntryObject->SetStringField(TEXT("name"), EntryPair.Value.StoredFilename);
+            EntryObject->SetNumberField(TEXT("size"), (double)EntryPair.Value.Size);
+            ServerObject->SetObjectField(FString::Printf(TEXT("%016llx"), EntryPair.Key), EntryObject);
+        }
+        Root->SetObjectField(ServerPair.Key, ServerObject);
+    }
+
+    FString Json;
+    const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+    if (FJsonSerializer::Serialize(Root, Writer) && FFileHelper::SaveStringToFile(Json, *GetCachePath()))
+    {
+        bDirty = false;
+    }
+    else
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ComfyUI Upload Cache: Failed to write %s"), *GetCachePath());
+    }
+}
+
+FString FComfyUIUploadCache::GetCachePath()
+{
+    return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ComfyUI"), TEXT("UploadCache.json"));
+}
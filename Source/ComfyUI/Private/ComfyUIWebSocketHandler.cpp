@@ -1,70 +1,448 @@
 #include "ComfyUIWebSocketHandler.h"
+#include "ComfyUIClient.h"
+#include "ComfyUIImageUtils.h"
 #include "WebSocketsModule.h"
 #include "Serialization/JsonSerializer.h"
+#include "Engine/Texture2D.h"
+#include "Async/Async.h"
 
-FComfyUIWebSocketHandler::FComfyUIWebSocketHandler()
+namespace
+{
+    // Binary event types sent by ComfyUI (server.py BinaryEventTypes)
+    constexpr uint32 BinaryEventPreviewImage = 1;
+    constexpr uint32 BinaryEventPreviewImageWithMetadata = 4;
+
+    // Reconnect backoff: 1s, 2s, 4s ... capped at 30s, each scaled by a random 50-100%
+    // so editors that lost the same server don't all come back in lockstep
+    constexpr float ReconnectBaseDelaySeconds = 1.0f;
+    constexpr float ReconnectMaxDelaySeconds = 30.0f;
+
+    // How many recent /history entries to check pending prompts against after a reconnect
+    constexpr int32 ReconcileHistoryItems = 64;
+
+    // Finished-but-unwatched prompts kept around for watchers that register late
+    constexpr int32 MaxRecentlyFinishedPrompts = 32;
+
+    uint32 ReadBigEndianUInt32(const uint8* Bytes)
+    {
+        return (uint32(Bytes[0]) << 24) | (uint32(Bytes[1]) << 16) | (uint32(Bytes[2]) << 8) | uint32(Bytes[3]);
+    }
+
+    /**
+     * Finds the first "Key" member at nesting depth Depth (1 = top-level object) and
+     * returns its string value as a view into Json, without allocating. Returns false
+     * when the key is missing, its value isn't a plain string, or the value contains
+     * escapes — callers then fall back to a full parse.
+     */
+    bool ScanStringField(const FString& Json, FStringView Key, int32 Depth, FStringView& OutValue)
+    {
+        const TCHAR* P = *Json;
+        const TCHAR* End = P + Json.Len();
+        int32 CurrentDepth = 0;
+
+        auto SkipWhitespace = [End](const TCHAR* Q)
+        {
+            while (Q < End && FChar::IsWhitespace(*Q)) ++Q;
+            return Q;
+        };
+
+        while (P < End)
+        {
+            const TCHAR C = *P++;
+            if (C == TEXT('{') || C == TEXT('['))
+            {
+                ++CurrentDepth;
+                continue;
+            }
+            if (C == TEXT('}') || C == TEXT(']'))
+            {
+                --CurrentDepth;
+                continue;
+            }
+            if (C != TEXT('"'))
+            {
+                continue;
+            }
+
+            // String token; skip escaped characters so quotes inside don't end it
+            const TCHAR* TokenStart = P;
+            bool bHasEscape = false;
+            while (P < End && *P != TEXT('"'))
+            {
+                if (*P == TEXT('\\'))
+                {
+                    bHasEscape = true;
+                    ++P;
+                }
+                ++P;
+            }
+            if (P >= End)
+            {
+                return false;
+            }
+            const FStringView Token(TokenStart, UE_PTRDIFF_TO_INT32(P - TokenStart));
+            ++P;
+
+            if (CurrentDepth != Depth || bHasEscape || !Token.Equals(Key, ESearchCase::CaseSensitive))
+            {
+                continue;
+            }
+
+            const TCHAR* Q = SkipWhitespace(P);
+            if (Q >= End || *Q != TEXT(':'))
+            {
+                // A string value that happens to equal the key name
+                continue;
+            }
+
+            Q = SkipWhitespace(Q + 1);
+            if (Q >= End || *Q != TEXT('"'))
+            {
+                return false;
+            }
+
+            const TCHAR* ValueStart = ++Q;
+            while (Q < End && *Q != TEXT('"'))
+            {
+                if (*Q == TEXT('\\'))
+                {
+                    return false;
+                }
+                ++Q;
+            }
+            if (Q >= End)
+            {
+                return false;
+            }
+
+            OutValue = FStringView(ValueStart, UE_PTRDIFF_TO_INT32(Q - ValueStart));
+            return true;
+        }
+        return false;
+    }
+}
+
+FComfyUIWebSocketHandler::FComfyUIWebSocketHandler(const TSharedPtr<FComfyUIClient>& InClient)
+    : Client(InClient)
 {
 }
 
 FComfyUIWebSocketHandler::~FComfyUIWebSocketHandler()
 {
     Disconnect();
+    ReleasePreviewTexture();
 }
 
 void FComfyUIWebSocketHandler::Connect(const FString& Url)
 {
-    if (bIsConnected)
+    bWantsConnection = true;
+
+    // Already open, or a handshake / scheduled reconnect is in progress
+    if (bIsConnected || WebSocket.IsValid() || ReconnectTickerHandle.IsValid())
     {
-        return;
+        if (Url == SocketUrl)
+        {
+            return;
+        }
+        CloseSocket();
     }
 
+    SocketUrl = Url;
+    ReconnectAttempt = 0;
+    OpenSocket();
+}
+
+void FComfyUIWebSocketHandler::Disconnect()
+{
+    bWantsConnection = false;
+    CloseSocket();
+}
+
+bool FComfyUIWebSocketHandler::IsConnected() const
+{
+    return bIsConnected;
+}
+
+void FComfyUIWebSocketHandler::OpenSocket()
+{
     FWebSocketsModule& Module = FModuleManager::LoadModuleChecked<FWebSocketsModule>(TEXT("WebSockets"));
-    WebSocket = Module.CreateWebSocket(Url, TEXT("ws"));
+    WebSocket = Module.CreateWebSocket(SocketUrl, TEXT("ws"));
 
     WebSocket->OnConnected().AddRaw(this, &FComfyUIWebSocketHandler::OnConnected);
     WebSocket->OnConnectionError().AddRaw(this, &FComfyUIWebSocketHandler::OnConnectionError);
     WebSocket->OnClosed().AddRaw(this, &FComfyUIWebSocketHandler::OnClosed);
     WebSocket->OnMessage().AddRaw(this, &FComfyUIWebSocketHandler::OnMessage);
+    WebSocket->OnBinaryMessage().AddRaw(this, &FComfyUIWebSocketHandler::OnBinaryMessage);
+
+    // Preview frames are decoded on workers, which can't load modules themselves
+    ComfyUIImage::PreloadImageWrapperModule();
 
     WebSocket->Connect();
 }
 
-void FComfyUIWebSocketHandler::Disconnect()
+void FComfyUIWebSocketHandler::CloseSocket()
+{
+    if (ReconnectTickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(ReconnectTickerHandle);
+        ReconnectTickerHandle.Reset();
+    }
+    ReleaseSocket();
+}
+
+void FComfyUIWebSocketHandler::ReleaseSocket()
 {
     if (WebSocket.IsValid())
     {
+        // Unbind first so the close doesn't come back to us as a drop to recover from
+        WebSocket->OnConnected().RemoveAll(this);
+        WebSocket->OnConnectionError().RemoveAll(this);
+        WebSocket->OnClosed().RemoveAll(this);
+        WebSocket->OnMessage().RemoveAll(this);
+        WebSocket->OnBinaryMessage().RemoveAll(this);
         WebSocket->Close();
         WebSocket.Reset();
     }
     bIsConnected = false;
-}
-
-bool FComfyUIWebSocketHandler::IsConnected() const
-{
-    return bIsConnected;
+    PendingBinaryFrame.Reset();
 }
 
 void FComfyUIWebSocketHandler::OnConnected()
 {
     UE_LOG(LogTemp, Warning, TEXT("ComfyUI WebSocket: Connected"));
     bIsConnected = true;
-	OnConnectedEvent.Broadcast();
+    ReconnectAttempt = 0;
+    OnConnectedEvent.Broadcast();
+
+    // Anything watched while the socket was down (including watchers registered
+    // from OnConnectedEvent just now) may already have finished
+    ReconcilePendingPrompts();
 }
 
 void FComfyUIWebSocketHandler::OnConnectionError(const FString& Error)
 {
     UE_LOG(LogTemp, Error, TEXT("ComfyUI WebSocket: Connection error - %s"), *Error);
     bIsConnected = false;
+    OnDisconnectedEvent.Broadcast();
+    ScheduleReconnect();
 }
 
 void FComfyUIWebSocketHandler::OnClosed(int32 StatusCode, const FString& Reason, bool bWasClean)
 {
     UE_LOG(LogTemp, Warning, TEXT("ComfyUI WebSocket: Closed (%d: %s)"), StatusCode, *Reason);
     bIsConnected = false;
+    OnDisconnectedEvent.Broadcast();
+    ScheduleReconnect();
+}
+
+// ============================================================================
+// Reconnect
+// ============================================================================
+
+void FComfyUIWebSocketHandler::ScheduleReconnect()
+{
+    if (!bWantsConnection || ReconnectTickerHandle.IsValid())
+    {
+        return;
+    }
+
+    const float Backoff = FMath::Min(ReconnectMaxDelaySeconds,
+        ReconnectBaseDelaySeconds * FMath::Pow(2.0f, (float)FMath::Min(ReconnectAttempt, 16)));
+    const float Delay = Backoff * FMath::FRandRange(0.5f, 1.0f);
+    ReconnectAttempt++;
+
+    UE_LOG(LogTemp, Warning, TEXT("ComfyUI WebSocket: Reconnecting in %.1fs (attempt %d)"), Delay, ReconnectAttempt);
+
+    ReconnectTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+        FTickerDelegate::CreateSP(this, &FComfyUIWebSocketHandler::OnReconnectTick), Delay);
+}
+
+bool FComfyUIWebSocketHandler::OnReconnectTick(float DeltaTime)
+{
+    ReconnectTickerHandle.Reset();
+
+    if (bWantsConnection && !bIsConnected)
+    {
+        ReleaseSocket();
+        OpenSocket();
+    }
+
+    // One-shot
+    return false;
+}
+
+void FComfyUIWebSocketHandler::ReconcilePendingPrompts()
+{
+    TSharedPtr<FComfyUIClient> PinnedClient = Client.Pin();
+    if (!PinnedClient.IsValid() || (PromptCallbacks.Num() == 0 && ObservedPrompts.Num() == 0))
+    {
+        return;
+    }
+
+    UE_LOG(LogTemp, Warning, TEXT("ComfyUI WebSocket: Reconciling %d pending prompt(s) against /history"),
+        PromptCallbacks.Num() + ObservedPrompts.Num());
+
+    TWeakPtr<FComfyUIWebSocketHandler> WeakHandler = AsShared();
+    PinnedClient->GetHistoryBatch(ReconcileHistoryItems,
+        [WeakHandler](bool bSuccess, const TSharedPtr<FJsonObject>& History)
+        {
+            TSharedPtr<FComfyUIWebSocketHandler> Handler = WeakHandler.Pin();
+            if (Handler.IsValid() && bSuccess)
+            {
+                Handler->ApplyReconcileHistory(History);
+            }
+        });
+}
+
+void FComfyUIWebSocketHandler::ApplyReconcileHistory(const TSharedPtr<FJsonObject>& History)
+{
+    // FinishPrompt mutates both containers, so work from a snapshot
+    TArray<FString> Pending;
+    PromptCallbacks.GetKeys(Pending);
+    for (const FString& Observed : ObservedPrompts)
+    {
+        Pending.AddUnique(Observed);
+    }
+
+    TArray<FString> Missing;
+    for (const FString& PromptId : Pending)
+    {
+        const TSharedPtr<FJsonObject>* Entry;
+        const TSharedPtr<FJsonObject>* Status;
+        if (!History->TryGetObjectField(PromptId, Entry) || !(*Entry)->TryGetObjectField(TEXT("status"), Status))
+        {
+            // Still queued or running, older than the batch, or gone with a server restart
+            Missing.Add(PromptId);
+            continue;
+        }
+
+        FString StatusStr;
+        (*Status)->TryGetStringField(TEXT("status_str"), StatusStr);
+        if (StatusStr == TEXT("success") || StatusStr == TEXT("error"))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("ComfyUI WebSocket: Prompt %s finished while disconnected (%s)"), *PromptId, *StatusStr);
+            FinishPrompt(PromptId, StatusStr == TEXT("success"));
+        }
+    }
+
+    if (Missing.Num() > 0)
+    {
+        ReconcileMissingPrompts(Missing);
+    }
+}
+
+void FComfyUIWebSocketHandler::ReconcileMissingPrompts(const TArray<FString>& PromptIds)
+{
+    TSharedPtr<FComfyUIClient> PinnedClient = Client.Pin();
+    if (!PinnedClient.IsValid())
+    {
+        return;
+    }
+
+    TWeakPtr<FComfyUIWebSocketHandler> WeakHandler = AsShared();
+    PinnedClient->GetQueue([WeakHandler, PromptIds](bool bSuccess, const FString& QueueJson)
+        {
+            TSharedPtr<FComfyUIWebSocketHandler> Handler = WeakHandler.Pin();
+            if (Handler.IsValid() && bSuccess)
+            {
+                Handler->ApplyReconcileQueue(PromptIds, QueueJson);
+            }
+        });
+}
+
+void FComfyUIWebSocketHandler::ApplyReconcileQueue(const TArray<FString>& PromptIds, const FString& QueueJson)
+{
+    TSet<FString> Queued;
+    TSharedPtr<FComfyUIClient> PinnedClient = Client.Pin();
+    if (!PinnedClient.IsValid() || !FComfyUIClient::ExtractQueuedPromptIds(QueueJson, Queued))
+    {
+        return;
+    }
+
+    TWeakPtr<FComfyUIWebSocketHandler> WeakHandler = AsShared();
+    for (const FString& PromptId : PromptIds)
+    {
+        if (Queued.Contains(PromptId) || !IsPromptPending(PromptId))
+        {
+            // Queued prompts are reported by the new socket
+            continue;
+        }
+
+        // Asked after /queue, so a prompt that left the queue in between has its entry by now
+        PinnedClient->GetHistory(PromptId, [WeakHandler, PromptId](bool bSuccess, const TSharedPtr<FJsonObject>& History)
+            {
+                TSharedPtr<FComfyUIWebSocketHandler> Handler = WeakHandler.Pin();
+                if (Handler.IsValid() && bSuccess)
+                {
+                    Handler->ApplyReconcilePromptHistory(PromptId, History);
+                }
+            });
+    }
+}
+
+void FComfyUIWebSocketHandler::ApplyReconcilePromptHistory(const FString& PromptId, const TSharedPtr<FJsonObject>& History)
+{
+    if (!IsPromptPending(PromptId))
+    {
+        return;
+    }
+
+    // Servers that predate "status" only write the entry once the prompt has run
+    const TSharedPtr<FJsonObject>* Entry;
+    const TSharedPtr<FJsonObject>* Status;
+    FString StatusStr;
+    if (History->TryGetObjectField(PromptId, Entry))
+    {
+        StatusStr = TEXT("success");
+        if ((*Entry)->TryGetObjectField(TEXT("status"), Status))
+            (*Status)->TryGetStringField(TEXT("status_str"), StatusStr);
+    }
+
+    if (StatusStr == TEXT("success"))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ComfyUI WebSocket: Prompt %s finished while disconnected (%s)"), *PromptId, *StatusStr);
+        FinishPrompt(PromptId, true);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Error, TEXT("ComfyUI WebSocket: Prompt %s is neither queued nor finished successfully (%s), failing it"),
+            *PromptId, StatusStr.IsEmpty() ? TEXT("no history") : *StatusStr);
+        FinishPrompt(PromptId, false);
+    }
+}
+
+bool FComfyUIWebSocketHandler::IsPromptPending(const FString& PromptId) const
+{
+    return PromptCallbacks.Contains(PromptId) || ObservedPrompts.Contains(PromptId);
 }
 
 void FComfyUIWebSocketHandler::OnMessage(const FString& Message)
 {
+    // Every client on a shared server sees a steady stream of progress and status
+    // traffic. Pre-scan the envelope and drop what nobody here listens to before
+    // paying for a DOM. ComfyUI messages are {"type": ..., "data": {"prompt_id": ...}}
+    FStringView TypeView;
+    if (ScanStringField(Message, TEXTVIEW("type"), 1, TypeView))
+    {
+        FStringView PromptIdView;
+        ScanStringField(Message, TEXTVIEW("prompt_id"), 2, PromptIdView);
+
+        if (!WantsMessage(TypeView, PromptIdView))
+        {
+            // Still attribute preview frames of unwatched prompts correctly
+            if (TypeView == TEXTVIEW("execution_start"))
+                ExecutingPromptId = FString(PromptIdView);
+
+            // A prompt can finish before its submitter has the prompt_id back from /prompt
+            // (fully cached graphs); remember the outcome for a late WatchPrompt
+            const bool bFinishedOk = TypeView == TEXTVIEW("execution_success") || TypeView == TEXTVIEW("execution_complete");
+            const bool bFinishedFailed = TypeView == TEXTVIEW("execution_error") || TypeView == TEXTVIEW("execution_interrupted");
+            if ((bFinishedOk || bFinishedFailed) && !PromptIdView.IsEmpty())
+                RememberFinishedPrompt(FString(PromptIdView), bFinishedOk);
+            return;
+        }
+    }
+
     TSharedPtr<FJsonObject> JsonObject;
     const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Message);
     if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
@@ -76,59 +454,382 @@ void FComfyUIWebSocketHandler::OnMessage(const FString& Message)
     if (!JsonObject->TryGetStringField(TEXT("type"), Type))
         return;
 
-    // execution_complete fires once per prompt with the exact prompt_id
-    // This is the correct signal for multi-user scenarios — each client
-    // only reacts to their own job, not the global queue emptying
-    if (Type == TEXT("execution_complete"))
+    const TSharedPtr<FJsonObject>* DataObject;
+    if (!JsonObject->TryGetObjectField(TEXT("data"), DataObject))
+        return;
+    const TSharedPtr<FJsonObject>& Data = *DataObject;
+
+    if (Type == TEXT("status"))
     {
-        const TSharedPtr<FJsonObject>* DataObject;
-        if (JsonObject->TryGetObjectField(TEXT("data"), DataObject))
+        HandleStatus(Data);
+    }
+    else if (Type == TEXT("execution_start"))
+    {
+        // Remember which prompt is running so plain preview frames (which carry
+        // no metadata) can be attributed to it
+        Data->TryGetStringField(TEXT("prompt_id"), ExecutingPromptId);
+    }
+    else if (Type == TEXT("executing"))
+    {
+        HandleExecuting(Data);
+    }
+    else if (Type == TEXT("progress"))
+    {
+        HandleProgress(Data);
+    }
+    else if (Type == TEXT("executed"))
+    {
+        HandleExecuted(Data);
+    }
+    else if (Type == TEXT("execution_cached"))
+    {
+        HandleExecutionCached(Data);
+    }
+    // execution_success (execution_complete on older servers) fires once per prompt
+    // with the exact prompt_id. This is the correct signal for multi-user scenarios —
+    // each client only reacts to their own job, not the global queue emptying
+    else if (Type == TEXT("execution_success") || Type == TEXT("execution_complete"))
+    {
+        FString PromptId;
+        if (Data->TryGetStringField(TEXT("prompt_id"), PromptId))
         {
-            FString PromptId;
-            if ((*DataObject)->TryGetStringField(TEXT("prompt_id"), PromptId))
-            {
-                UE_LOG(LogTemp, Warning, TEXT("ComfyUI WebSocket: execution_complete for prompt %s"), *PromptId);
+            UE_LOG(LogTemp, Warning, TEXT("ComfyUI WebSocket: %s for prompt %s"), *Type, *PromptId);
+            FinishPrompt(PromptId, true);
+        }
+    }
+    // Handle errors and interrupts — also prompt-specific
+    else if (Type == TEXT("execution_error") || Type == TEXT("execution_interrupted"))
+    {
+        FString PromptId;
+        if (Data->TryGetStringField(TEXT("prompt_id"), PromptId))
+        {
+            UE_LOG(LogTemp, Error, TEXT("ComfyUI WebSocket: %s for prompt %s"), *Type, *PromptId);
+            FinishPrompt(PromptId, false);
+        }
+    }
+}
 
-                if (FComfyUIWorkflowCompleteDelegateNative* Callback = PromptCallbacks.Find(PromptId))
-                {
-                    Callback->ExecuteIfBound(true, PromptId);
-                    PromptCallbacks.Remove(PromptId);
-                }
-                else
-                {
-                    // Not our prompt — belongs to another user, ignore it
-                    UE_LOG(LogTemp, Warning, TEXT("ComfyUI WebSocket: execution_complete for untracked prompt %s (another user's job)"), *PromptId);
-                }
-            }
+bool FComfyUIWebSocketHandler::WantsMessage(FStringView Type, FStringView PromptId) const
+{
+    if (Type == TEXTVIEW("status"))
+    {
+        return OnQueueStatus.IsBound();
+    }
+
+    const bool bPromptEvent =
+        Type == TEXTVIEW("progress")
+        || Type == TEXTVIEW("executing")
+        || Type == TEXTVIEW("executed")
+        || Type == TEXTVIEW("execution_cached")
+        || Type == TEXTVIEW("execution_start")
+        || Type == TEXTVIEW("execution_success")
+        || Type == TEXTVIEW("execution_complete")
+        || Type == TEXTVIEW("execution_error")
+        || Type == TEXTVIEW("execution_interrupted");
+
+    if (!bPromptEvent)
+    {
+        // Custom node chatter (system monitors etc.) and message types we don't handle
+        return false;
+    }
+
+    // Older servers omit prompt_id on some messages; let the full parse sort those out
+    return PromptId.IsEmpty() || IsPromptOfInterest(PromptId);
+}
+
+bool FComfyUIWebSocketHandler::IsPromptOfInterest(FStringView PromptId) const
+{
+    // Only a handful of prompts are ever in flight per editor; a linear scan
+    // avoids building an FString for the lookup
+    for (const TPair<FString, FComfyUIWorkflowCompleteDelegateNative>& Pair : PromptCallbacks)
+    {
+        if (PromptId.Equals(Pair.Key, ESearchCase::CaseSensitive))
+            return true;
+    }
+    for (const FString& Observed : ObservedPrompts)
+    {
+        if (PromptId.Equals(Observed, ESearchCase::CaseSensitive))
+            return true;
+    }
+    return false;
+}
+
+void FComfyUIWebSocketHandler::HandleStatus(const TSharedPtr<FJsonObject>& Data)
+{
+    // {"status": {"exec_info": {"queue_remaining": N}}}
+    const TSharedPtr<FJsonObject>* StatusObject;
+    const TSharedPtr<FJsonObject>* ExecInfo;
+    if (!Data->TryGetObjectField(TEXT("status"), StatusObject)
+        || !(*StatusObject)->TryGetObjectField(TEXT("exec_info"), ExecInfo))
+    {
+        return;
+    }
+
+    int32 Remaining = 0;
+    if ((*ExecInfo)->TryGetNumberField(TEXT("queue_remaining"), Remaining))
+    {
+        QueueRemaining = Remaining;
+        OnQueueStatus.Broadcast(QueueRemaining);
+    }
+}
+
+void FComfyUIWebSocketHandler::HandleExecuting(const TSharedPtr<FJsonObject>& Data)
+{
+    FString PromptId;
+    Data->TryGetStringField(TEXT("prompt_id"), PromptId);
+
+    // "node": null marks the end of the prompt; execution_success follows it
+    FString NodeId;
+    if (!Data->TryGetStringField(TEXT("node"), NodeId))
+    {
+        if (PromptId == ExecutingPromptId)
+            ExecutingPromptId.Reset();
+        return;
+    }
+
+    ExecutingPromptId = PromptId;
+    OnNodeExecuting.Broadcast(PromptId, NodeId);
+}
+
+void FComfyUIWebSocketHandler::HandleProgress(const TSharedPtr<FJsonObject>& Data)
+{
+    FString PromptId;
+    FString NodeId;
+    int32 Value = 0;
+    int32 Max = 0;
+    Data->TryGetStringField(TEXT("prompt_id"), PromptId);
+    Data->TryGetStringField(TEXT("node"), NodeId);
+    Data->TryGetNumberField(TEXT("value"), Value);
+    Data->TryGetNumberField(TEXT("max"), Max);
+
+    OnProgress.Broadcast(PromptId.IsEmpty() ? ExecutingPromptId : PromptId, NodeId, Value, Max);
+}
+
+void FComfyUIWebSocketHandler::HandleExecuted(const TSharedPtr<FJsonObject>& Data)
+{
+    FString PromptId;
+    FString NodeId;
+    Data->TryGetStringField(TEXT("prompt_id"), PromptId);
+    Data->TryGetStringField(TEXT("node"), NodeId);
+
+    TSharedPtr<FJsonObject> Output;
+    const TSharedPtr<FJsonObject>* OutputObject;
+    if (Data->TryGetObjectField(TEXT("output"), OutputObject))
+        Output = *OutputObject;
+
+    OnNodeExecuted.Broadcast(PromptId, NodeId, Output);
+}
+
+void FComfyUIWebSocketHandler::HandleExecutionCached(const TSharedPtr<FJsonObject>& Data)
+{
+    FString PromptId;
+    Data->TryGetStringField(TEXT("prompt_id"), PromptId);
+
+    TArray<FString> NodeIds;
+    Data->TryGetStringArrayField(TEXT("nodes"), NodeIds);
+
+    OnNodesCached.Broadcast(PromptId, NodeIds);
+}
+
+void FComfyUIWebSocketHandler::FinishPrompt(const FString& PromptId, bool bSuccess)
+{
+    if (PromptId == ExecutingPromptId)
+        ExecutingPromptId.Reset();
+
+    ObservedPrompts.Remove(PromptId);
+
+    FComfyUIWorkflowCompleteDelegateNative Callback;
+    if (PromptCallbacks.RemoveAndCopyValue(PromptId, Callback))
+    {
+        Callback.ExecuteIfBound(bSuccess, PromptId);
+    }
+    else
+    {
+        // Not our prompt — belongs to another user, or its watcher isn't registered yet
+        RememberFinishedPrompt(PromptId, bSuccess);
+        UE_LOG(LogTemp, Verbose, TEXT("ComfyUI WebSocket: Finished untracked prompt %s (another user's job)"), *PromptId);
+    }
+
+    OnPromptFinished.Broadcast(PromptId, bSuccess);
+}
+
+// ============================================================================
+// Binary preview frames
+// ============================================================================
+
+void FComfyUIWebSocketHandler::OnBinaryMessage(const void* Data, SIZE_T Size, bool bIsLastFragment)
+{
+    PendingBinaryFrame.Append(static_cast<const uint8*>(Data), Size);
+    if (!bIsLastFragment)
+    {
+        return;
+    }
+
+    TArray<uint8> Frame = MoveTemp(PendingBinaryFrame);
+    PendingBinaryFrame.Reset();
+    HandleBinaryFrame(MoveTemp(Frame));
+}
+
+void FComfyUIWebSocketHandler::HandleBinaryFrame(TArray<uint8>&& Frame)
+{
+    if (Frame.Num() < 8)
+    {
+        return;
+    }
+
+    const uint32 EventType = ReadBigEndianUInt32(Frame.GetData());
+
+    if (EventType == BinaryEventPreviewImage)
+    {
+        // [event type][image type (1 = JPEG, 2 = PNG)][image bytes]
+        StartPreviewDecode(ExecutingPromptId, MoveTemp(Frame), 8);
+    }
+    else if (EventType == BinaryEventPreviewImageWithMetadata)
+    {
+        // [event type][metadata length][metadata JSON][image bytes]
+        const int64 MetadataLength = ReadBigEndianUInt32(Frame.GetData() + 4);
+        if (8 + MetadataLength >= Frame.Num())
+        {
+            return;
         }
+
+        FString PromptId = ExecutingPromptId;
+        const FString MetadataJson(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Frame.GetData() + 8), (int32)MetadataLength));
+        TSharedPtr<FJsonObject> Metadata;
+        const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(MetadataJson);
+        if (FJsonSerializer::Deserialize(Reader, Metadata) && Metadata.IsValid())
+        {
+            Metadata->TryGetStringField(TEXT("prompt_id"), PromptId);
+        }
+
+        StartPreviewDecode(PromptId, MoveTemp(Frame), 8 + (int32)MetadataLength);
     }
-    // Handle errors — also prompt-specific
-    else if (Type == TEXT("execution_error"))
+}
+
+void FComfyUIWebSocketHandler::StartPreviewDecode(const FString& PromptId, TArray<uint8>&& Frame, int32 ImageOffset)
+{
+    if (bPreviewDecodeInFlight)
     {
-        const TSharedPtr<FJsonObject>* DataObject;
-        if (JsonObject->TryGetObjectField(TEXT("data"), DataObject))
+        // The sampler can outpace decoding; only the newest frame is worth showing
+        QueuedPreviewPromptId = PromptId;
+        QueuedPreviewFrame = MoveTemp(Frame);
+        QueuedPreviewOffset = ImageOffset;
+        return;
+    }
+
+    bPreviewDecodeInFlight = true;
+    TWeakPtr<FComfyUIWebSocketHandler> WeakHandler = AsShared();
+
+    Async(EAsyncExecution::ThreadPool,
+        [WeakHandler, PromptId, Frame = MoveTemp(Frame), ImageOffset]()
         {
-            FString PromptId;
-            if ((*DataObject)->TryGetStringField(TEXT("prompt_id"), PromptId))
-            {
-                UE_LOG(LogTemp, Error, TEXT("ComfyUI WebSocket: Execution error for prompt %s"), *PromptId);
+            FComfyUIDecodedImage Decoded;
+            const bool bDecoded = ComfyUIImage::DecodeToBGRA(Frame.GetData() + ImageOffset, Frame.Num() - ImageOffset, Decoded);
 
-                if (FComfyUIWorkflowCompleteDelegateNative* Callback = PromptCallbacks.Find(PromptId))
+            AsyncTask(ENamedThreads::GameThread,
+                [WeakHandler, PromptId, bDecoded, Decoded = MoveTemp(Decoded)]() mutable
                 {
-                    Callback->ExecuteIfBound(false, PromptId);
-                    PromptCallbacks.Remove(PromptId);
-                }
-            }
+                    if (TSharedPtr<FComfyUIWebSocketHandler> Handler = WeakHandler.Pin())
+                    {
+                        Handler->OnPreviewDecoded(PromptId, bDecoded, MoveTemp(Decoded));
+                    }
+                });
+        });
+}
+
+void FComfyUIWebSocketHandler::OnPreviewDecoded(const FString& PromptId, bool bDecoded, FComfyUIDecodedImage&& Image)
+{
+    bPreviewDecodeInFlight = false;
+
+    if (bDecoded)
+    {
+        UTexture2D* Texture = ComfyUIImage::UpdateOrCreateTransientTexture(PreviewTexture, MoveTemp(Image));
+        if (Texture && Texture != PreviewTexture)
+        {
+            ReleasePreviewTexture();
+            Texture->AddToRoot();
+            PreviewTexture = Texture;
         }
+
+        if (PreviewTexture)
+        {
+            OnPreviewUpdated.Broadcast(PromptId, PreviewTexture);
+        }
+    }
+
+    if (QueuedPreviewFrame.Num() > 0)
+    {
+        TArray<uint8> Frame = MoveTemp(QueuedPreviewFrame);
+        QueuedPreviewFrame.Reset();
+        StartPreviewDecode(QueuedPreviewPromptId, MoveTemp(Frame), QueuedPreviewOffset);
+    }
+}
+
+void FComfyUIWebSocketHandler::ReleasePreviewTexture()
+{
+    if (PreviewTexture && UObjectInitialized())
+    {
+        PreviewTexture->RemoveFromRoot();
     }
+    PreviewTexture = nullptr;
 }
 
+// ============================================================================
+// Watchers
+// ============================================================================
+
 void FComfyUIWebSocketHandler::WatchPrompt(const FString& PromptId, const FComfyUIWorkflowCompleteDelegateNative& Callback)
 {
+    const int32 FinishedIndex = RecentlyFinishedPrompts.IndexOfByPredicate(
+        [&PromptId](const TPair<FString, bool>& Entry) { return Entry.Key == PromptId; });
+    if (FinishedIndex != INDEX_NONE)
+    {
+        const bool bSuccess = RecentlyFinishedPrompts[FinishedIndex].Value;
+        RecentlyFinishedPrompts.RemoveAt(FinishedIndex);
+        UE_LOG(LogTemp, Warning, TEXT("ComfyUI WebSocket: Prompt %s finished before its watcher was registered"), *PromptId);
+        Callback.ExecuteIfBound(bSuccess, PromptId);
+        return;
+    }
+
     PromptCallbacks.Add(PromptId, Callback);
     UE_LOG(LogTemp, Warning, TEXT("ComfyUI WebSocket: Registered watcher for prompt %s (total watchers: %d)"), *PromptId, PromptCallbacks.Num());
 }
 
+void FComfyUIWebSocketHandler::RememberFinishedPrompt(const FString& PromptId, bool bSuccess)
+{
+    if (RecentlyFinishedPrompts.Num() >= MaxRecentlyFinishedPrompts)
+        RecentlyFinishedPrompts.RemoveAt(0);
+    RecentlyFinishedPrompts.Emplace(PromptId, bSuccess);
+}
+
+void FComfyUIWebSocketHandler::ObservePrompt(const FString& PromptId)
+{
+    ObservedPrompts.Add(PromptId);
+}
+
+void FComfyUIWebSocketHandler::UnobservePrompt(const FString& PromptId)
+{
+    ObservedPrompts.Remove(PromptId);
+}
+
+bool FComfyUIWebSocketHandler::HasPromptFinished(const FString& PromptId) const
+{
+    return RecentlyFinishedPrompts.ContainsByPredicate(
+        [&PromptId](const TPair<FString, bool>& Entry) { return Entry.Key == PromptId; });
+}
+
+bool FComfyUIWebSocketHandler::IsTrackingPrompt(const FString& PromptId) const
+{
+    return bIsConnected && PromptCallbacks.Contains(PromptId);
+}
+
+FString FComfyUIWebSocketHandler::GetClientId() const
+{
+    FString ClientId;
+    SocketUrl.Split(TEXT("clientId="), nullptr, &ClientId);
+    return ClientId;
+}
+
 void FComfyUIWebSocketHandler::UnwatchPrompt(const FString& PromptId)
 {
     if (PromptCallbacks.Remove(PromptId) > 0)
@@ -0,0 +1,248 @@
+#include "ComfyUIWorkflowTemplate.h"
+#include "Serialization/JsonSerializer.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Misc/Guid.h"
+
+namespace
+{
+    using FCondensedWriterFactory = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>;
+
+    // Written in place of slot inputs while serializing, then cut out again.
+    // Plain ASCII so the JSON writer emits it verbatim; the per-compile nonce keeps
+    // workflow text (which may come straight from Blueprint) from spelling it.
+    FString MakeMarker(const FString& Nonce, int32 SlotIndex)
+    {
+        return FString::Printf(TEXT("@@ComfyTemplateSlot_%s_%d@@"), *Nonce, SlotIndex);
+    }
+
+    FString SerializeValue(const TSharedPtr<FJsonValue>& Value)
+    {
+        // Serialize as a one-element array and strip the brackets; the writer
+        // does not accept a bare scalar at the root
+        TArray<TSharedPtr<FJsonValue>> Wrapped;
+        Wrapped.Add(Value);
+
+        FString Out;
+        const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = FCondensedWriterFactory::Create(&Out);
+        FJsonSerializer::Serialize(Wrapped, Writer);
+        return Out.Mid(1, Out.Len() - 2);
+    }
+}
+
+bool FComfyWorkflowTemplate::Compile(const FString& WorkflowJson, const TArray<FComfyTemplateSlot>& InSlots)
+{
+    TSharedPtr<FJsonObject> Workflow;
+    const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(WorkflowJson);
+    if (!FJsonSerializer::Deserialize(Reader, Workflow) || !Workflow.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("ComfyUI Template: Invalid workflow JSON"));
+        return false;
+    }
+    return Compile(Workflow.ToSharedRef(), InSlots);
+}
+
+bool FComfyWorkflowTemplate::Compile(const TSharedRef<FJsonObject>& Workflow, const TArray<FComfyTemplateSlot>& InSlots)
+{
+    Slots = InSlots;
+    DefaultValues.Reset();
+    DefaultValues.SetNum(Slots.Num());
+    Segments.Reset();
+    SegmentSlots.Reset();
+    BaseLength = 0;
+
+    struct FSwappedInput
+    {
+        TSharedPtr<FJsonObject> Inputs;
+        FString InputName;
+        TSharedPtr<FJsonValue> Value;
+    };
+    TArray<FSwappedInput> Swapped;
+    TArray<int32> LiveSlots;
+    const FString Nonce = FGuid::NewGuid().ToString(EGuidFormats::Digits);
+
+    for (int32 Index = 0; Index < Slots.Num(); ++Index)
+    {
+        const FComfyTemplateSlot& Slot = Slots[Index];
+
+        const TSharedPtr<FJsonObject>* Node;
+        const TSharedPtr<FJsonObject>* Inputs;
+        TSharedPtr<FJsonValue> Value;
+        if (!Workflow->TryGetObjectField(Slot.NodeId, Node)
+            || !(*Node)->TryGetObjectField(TEXT("inputs"), Inputs)
+            || !(Value = (*Inputs)->TryGetField(Slot.InputName)).IsValid())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("ComfyUI Template: Input %s.%s not found, slot dropped"), *Slot.NodeId, *Slot.InputName);
+            continue;
+        }
+
+        // The same input declared twice would leave one marker without a match
+        if (Swapped.ContainsByPredicate([&](const FSwappedInput& Entry) { return Entry.Inputs == *Inputs && Entry.InputName == Slot.InputName; }))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("ComfyUI Template: Input %s.%s declared twice, duplicate dropped"), *Slot.NodeId, *Slot.InputName);
+            continue;
+        }
+
+        DefaultValues[Index] = SerializeValue(Value);
+        Swapped.Add({ *Inputs, Slot.InputName, Value });
+        (*Inputs)->SetStringField(Slot.InputName, MakeMarker(Nonce, Index));
+        LiveSlots.Add(Index);
+    }
+
+    FString Serialized;
+    const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = FCondensedWriterFactory::Create(&Serialized);
+    const bool bSerialized = FJsonSerializer::Serialize(Workflow, Writer);
+
+    for (const FSwappedInput& Entry : Swapped)
+    {
+        Entry.Inputs->SetField(Entry.InputName, Entry.Value);
+    }
+
+    if (!bSerialized)
+    {
+        UE_LOG(LogTemp, Error, TEXT("ComfyUI Template: Failed to serialize workflow"));
+        return false;
+    }
+
+    // Locate every marker (quotes included) and cut the text around them in output order.
+    // Each must appear exactly once, or the cut would land in the wrong place.
+    TArray<TPair<int32, int32>> MarkerPositions;
+    for (int32 SlotIndex : LiveSlots)
+    {
+        const FString QuotedMarker = FString::Printf(TEXT("\"%s\""), *MakeMarker(Nonce, SlotIndex));
+        const int32 Position = Serialized.Find(QuotedMarker, ESearchCase::CaseSensitive);
+        if (Position == INDEX_NONE
+            || Serialized.Find(QuotedMarker, ESearchCase::CaseSensitive, ESearchDir::FromStart, Position + 1) != INDEX_NONE)
+        {
+            UE_LOG(LogTemp, Error, TEXT("ComfyUI Template: Slot marker for %s.%s not found exactly once in serialized workflow"),
+                *Slots[SlotIndex].NodeId, *Slots[SlotIndex].InputName);
+            DefaultValues.Reset();
+            return false;
+        }
+        MarkerPositions.Emplace(Position, SlotIndex);
+    }
+    MarkerPositions.Sort([](const TPair<int32, int32>& A, const TPair<int32, int32>& B) { return A.Key < B.Key; });
+
+    int32 Cursor = 0;
+    for (const TPair<int32, int32>& Marker : MarkerPositions)
+    {
+        Segments.Add(Serialized.Mid(Cursor, Marker.Key - Cursor));
+        SegmentSlots.Add(Marker.Value);
+        Cursor = Marker.Key + MakeMarker(Nonce, Marker.Value).Len() + 2;
+    }
+    Segments.Add(Serialized.Mid(Cursor));
+
+    for (const FString& Segment : Segments)
+    {
+        BaseLength += Segment.Len();
+    }
+    for (const FString& Default : DefaultValues)
+    {
+        BaseLength += Default.Len();
+    }
+
+    return true;
+}
+
+int32 FComfyWorkflowTemplate::FindSlot(const FString& NodeId, const FString& InputName) const
+{
+    const int32 Index = Slots.IndexOfByKey(FComfyTemplateSlot(NodeId, InputName));
+    return SegmentSlots.Contains(Index) ? Index : INDEX_NONE;
+}
+
+FString FComfyWorkflowTemplate::Render(TConstArrayView<FComfyTemplateValue> Values) const
+{
+    FString Out;
+    RenderInto(Out, Values);
+    return Out;
+}
+
+FString FComfyWorkflowTemplate::RenderRequestBody(TConstArrayView<FComfyTemplateValue> Values, const FString& ClientId) const
+{
+    FString Out;
+    Out.Reserve(BaseLength + ClientId.Len() + 64);
+    Out += TEXT("{\"prompt\":");
+    RenderInto(Out, Values);
+    if (!ClientId.IsEmpty())
+    {
+        Out += TEXT(",\"client_id\":");
+        AppendJsonValue(Out, FComfyTemplateValue(ClientId));
+    }
+    Out += TEXT("}");
+    return Out;
+}
+
+void FComfyWorkflowTemplate::RenderInto(FString& Out, TConstArrayView<FComfyTemplateValue> Values) const
+{
+    if (!IsValid())
+    {
+        Out += TEXT("{}");
+        return;
+    }
+
+    int32 ExtraLength = 0;
+    for (const FComfyTemplateValue& Value : Values)
+    {
+        ExtraLength += Value.Kind == FComfyTemplateValue::EKind::String ? Value.String.Len() + 2 : 24;
+    }
+    Out.Reserve(Out.Len() + BaseLength + ExtraLength);
+
+    for (int32 Index = 0; Index < SegmentSlots.Num(); ++Index)
+    {
+        Out += Segments[Index];
+
+        const int32 SlotIndex = SegmentSlots[Index];
+        if (Values.IsValidIndex(SlotIndex) && Values[SlotIndex].Kind != FComfyTemplateValue::EKind::Default)
+            AppendJsonValue(Out, Values[SlotIndex]);
+        else
+            Out += DefaultValues[SlotIndex];
+    }
+    Out += Segments.Last();
+}
+
+void FComfyWorkflowTemplate::AppendJsonValue(FString& Out, const FComfyTemplateValue& Value)
+{
+    switch (Value.Kind)
+    {
+    case FComfyTemplateValue::EKind::Number:
+        // Integral values print without a fraction, matching what the JSON writer produces
+        if (FMath::IsFinite(Value.Number) && FMath::Abs(Value.Number) < 9.0e15 && Value.Number == FMath::FloorToDouble(Value.Number))
+            Out.Appendf(TEXT("%lld"), (int64)Value.Number);
+        else if (FMath::IsFinite(Value.Number))
+            Out.Appendf(TEXT("%.17g"), Value.Number);
+        else
+            Out += TEXT("0");
+        return;
+
+    case FComfyTemplateValue::EKind::Bool:
+        Out += Value.bBool ? TEXT("true") : TEXT("false");
+        return;
+
+    case FComfyTemplateValue::EKind::String:
+        break;
+
+    default:
+        Out += TEXT("null");
+        return;
+    }
+
+    Out.AppendChar(TEXT('"'));
+    for (const TCHAR Char : Value.String)
+    {
+        switch (Char)
+        {
+        case TEXT('"'):  Out += TEXT("\\\""); break;
+        case TEXT('\\'): Out += TEXT("\\\\"); break;
+        case TEXT('\n'): Out += TEXT("\\n"); break;
+        case TEXT('\r'): Out += TEXT("\\r"); break;
+        case TEXT('\t'): Out += TEXT("\\t"); break;
+        case TEXT('\b'): Out += TEXT("\\b"); break;
+        case TEXT('\f'): Out += TEXT("\\f"); break;
+        default:
+            if (Char < 0x20)
+                Out.Appendf(TEXT("\\u%04x"), (uint32)Char);
+            else
+                Out.AppendChar(Char);
+        }
+    }
+    Out.AppendChar(TEXT('"'));
+}
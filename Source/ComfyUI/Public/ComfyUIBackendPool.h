@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FComfyUIClient;
+class FComfyUIWebSocketHandler;
+
+/** One ComfyUI server: its REST client, its socket, and the load it last reported */
+struct COMFYUI_API FComfyUIBackend
+{
+    FComfyUIBackend(const TSharedRef<FComfyUIClient>& InClient, const TSharedRef<FComfyUIWebSocketHandler>& InWebSocket)
+        : Client(InClient)
+        , WebSocket(InWebSocket)
+    {
+    }
+
+    TSharedRef<FComfyUIClient> Client;
+    TSharedRef<FComfyUIWebSocketHandler> WebSocket;
+
+    // From the last probe
+    bool bReachable = true;
+    int32 QueueDepth = 0;           // running + pending prompts on /queue
+    int64 VramFree = 0;             // bytes on the first device in /system_stats
+    double LastProbeTime = -1.0;
+
+    /** Prompts sent here since the probe, which its QueueDepth doesn't include yet */
+    int32 DispatchedSinceProbe = 0;
+};
+
+/**
+ * Spreads prompts across the Base URL server and UComfyUISettings::AdditionalBackendUrls.
+ *
+ * Each submission goes to the backend with the fewest queued prompts, ties going to the
+ * most free VRAM. Loads are probed with /queue and /system_stats at most every couple of
+ * seconds and topped up locally with what has been dispatched since, so a burst of
+ * submissions fans out instead of piling onto one server. The chosen backend is
+ * pinned to the prompt id: its socket, /history and /view must all be asked on the server
+ * that ran it, so look prompts up with GetBackendForPrompt.
+ *
+ * With no additional URLs configured everything goes to the default backend without any
+ * probing. Owned by FComfyUIModule. Game thread only.
+ */
+class COMFYUI_API FComfyUIBackendPool : public TSharedFromThis<FComfyUIBackendPool>
+{
+public:
+    using FOnSelected = TFunction<void(const TSharedRef<FComfyUIBackend>& /*Backend*/)>;
+    using FOnSubmitted = TFunction<void(bool /*bSuccess*/, const FString& /*PromptId*/, const FString& /*ResponseJson*/,
+        const TSharedRef<FComfyUIBackend>& /*Backend*/)>;
+
+    /** The default backend wraps the module's shared client and socket */
+    FComfyUIBackendPool(const TSharedRef<FComfyUIClient>& DefaultClient, const TSharedRef<FComfyUIWebSocketHandler>& DefaultWebSocket);
+
+    const TSharedRef<FComfyUIBackend>& GetDefaultBackend() const { return Backends[0]; }
+
+    /** Default first, then the additional URLs in settings order. Picks up settings changes. */
+    const TArray<TSharedRef<FComfyUIBackend>>& GetBackends();
+
+    /** Calls OnSelected with the least loaded reachable backend, probing first if loads are stale */
+    void SelectBackend(FOnSelected OnSelected);
+
+    /** POST /prompt to a selected backend and pin the returned prompt id to it */
+    void SubmitPrompt(const FString& RequestBody, FOnSubmitted OnComplete);
+
+    /** Remembers that PromptId runs on Backend */
+    void PinPrompt(const FString& PromptId, const TSharedRef<FComfyUIBackend>& Backend);
+
+    /** Backend PromptId was pinned to, or the default backend for prompts submitted elsewhere */
+    TSharedRef<FComfyUIBackend> GetBackendForPrompt(const FString& PromptId) const;
+
+    /** Disconnects the additional backends' sockets */
+    void Shutdown();
+
+private:
+    void SyncWithSettings();
+    void OnSettingsChanged(UObject* Settings, struct FPropertyChangedEvent& PropertyChangedEvent);
+    void ProbeStaleBackends();
+    void OnProbeFinished();
+
+    /** Hands every waiting caller a backend, counting each pick against its load */
+    void ServeWaiting();
+    TSharedRef<FComfyUIBackend> PickLeastLoaded() const;
+
+    /** Index 0 is the default backend */
+    TArray<TSharedRef<FComfyUIBackend>> Backends;
+    TArray<FString> ConfiguredUrls;
+    FDelegateHandle SettingsChangedHandle;
+
+    TArray<FOnSelected> WaitingForProbe;
+    int32 ProbesInFlight = 0;
+
+    TMap<FString, TSharedRef<FComfyUIBackend>> PinnedPrompts;
+
+    /** Pin order, oldest first, so the map can be trimmed */
+    TArray<FString> PinOrder;
+};
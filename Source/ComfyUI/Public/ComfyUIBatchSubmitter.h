@@ -0,0 +1,123 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "ComfyUIRequestTypes.h"
+#include "ComfyUIWorkflowTemplate.h"
+
+class FComfyUIClient;
+class FComfyUIWebSocketHandler;
+class FComfyUIBackendPool;
+
+/**
+ * Queues one base workflow many times with per-variant input overrides.
+ *
+ * The base graph is parsed once and compiled into a template with a slot per
+ * overridden input, so each request body is spliced as text. /prompt POSTs are
+ * pipelined, a few in flight at a time instead of one round trip per variant.
+ * Every prompt is watched on its server's WebSocket and a single completion fires
+ * when all variants have either produced their images or failed. ComfyUI only reports
+ * a prompt to the socket of its client_id, so variants whose socket is down or was
+ * opened under another client id are polled on /history instead. Submitters made
+ * from a backend pool spread the variants across its servers. Polled variants that
+ * are neither queued nor in /history were lost by the server and fail.
+ *
+ * The submitter keeps itself alive through its pending callbacks until the batch
+ * completes, times out or is cancelled. Game thread only.
+ */
+class COMFYUI_API FComfyUIBatchSubmitter : public TSharedFromThis<FComfyUIBatchSubmitter>
+{
+public:
+    FComfyUIBatchSubmitter(const TSharedPtr<FComfyUIClient>& InClient, const TSharedPtr<FComfyUIWebSocketHandler>& InWebSocketHandler);
+
+    /** Dispatches each variant through Pool */
+    explicit FComfyUIBatchSubmitter(const TSharedRef<FComfyUIBackendPool>& InPool);
+
+    ~FComfyUIBatchSubmitter();
+
+    /**
+     * Convenience wrapper: creates a submitter on the module's backend pool and starts it.
+     * Returns nullptr (after firing OnComplete with failure) when the batch can't be started.
+     */
+    static TSharedPtr<FComfyUIBatchSubmitter> Submit(const FString& BaseWorkflowJson, const TArray<FComfyUIBatchVariant>& Variants,
+        const FString& ClientId, const FComfyUIBatchCompleteDelegateNative& OnComplete);
+
+    /** Parses BaseWorkflowJson and starts queueing. Returns false if the workflow is invalid. */
+    bool Start(const FString& BaseWorkflowJson, const TArray<FComfyUIBatchVariant>& InVariants,
+        const FString& InClientId, const FComfyUIBatchCompleteDelegateNative& InOnComplete);
+
+    /**
+     * Fails every variant that hasn't finished and fires OnComplete now. Prompts already
+     * queued keep running on their servers; their results are ignored.
+     */
+    void Cancel();
+
+    /**
+     * Unfinished variants are failed once no variant has been queued or finished for
+     * Seconds, so a prompt nobody reports can't hold the batch open. Defaults to ten
+     * minutes; raise it for workflows where one variant runs longer. 0 disables it.
+     */
+    void SetTimeout(float Seconds) { TimeoutSeconds = Seconds; }
+
+    int32 GetNumVariants() const { return Variants.Num(); }
+    int32 GetNumFinished() const { return NumFinished; }
+    bool IsFinished() const { return NumFinished == Variants.Num(); }
+
+private:
+    /** Keeps up to MaxPostsInFlight /prompt requests outstanding */
+    void PumpPosts();
+
+    /** Queues one variant, through the pool when there is one */
+    void PostVariant(int32 Index, const FString& RequestBody);
+
+    /** Renders the base graph with Variant's overrides applied */
+    FString BuildRequestBody(const FComfyUIBatchVariant& Variant) const;
+
+    void OnPromptQueued(int32 Index, bool bSuccess, const FString& PromptId);
+    void OnPromptFinished(int32 Index, bool bSuccess);
+    void FinishVariant(int32 Index, bool bSuccess);
+    void FailUnfinishedVariants();
+
+    /** Whether Index's socket will report its completion */
+    bool IsReportedBySocket(int32 Index) const;
+
+    /**
+     * Checks variants their socket can't report against their server's /queue, and the
+     * ones no longer queued against /history. Also enforces the timeout.
+     */
+    bool PollHistory(float DeltaTime);
+    void ApplyPollQueue(const TSharedPtr<FComfyUIClient>& VariantClient, const TArray<int32>& Indices, bool bSuccess, const FString& QueueJson);
+    void ApplyPollHistory(int32 Index, bool bSuccess, const TSharedPtr<FJsonObject>& History);
+    void StopPolling();
+
+    TSharedPtr<FComfyUIClient> Client;
+    TSharedPtr<FComfyUIWebSocketHandler> WebSocketHandler;
+    TSharedPtr<FComfyUIBackendPool> Pool;
+
+    /** Server each variant was queued on, parallel to Variants */
+    TArray<TSharedPtr<FComfyUIClient>> VariantClients;
+    TArray<TSharedPtr<FComfyUIWebSocketHandler>> VariantSockets;
+
+    /** Variants whose completion was seen, by socket or poll; parallel to Variants */
+    TBitArray<> CompletionSeen;
+
+    /** Variants whose result is final; late callbacks for them are ignored */
+    TBitArray<> VariantFinished;
+
+    /** Variants with a /queue or /history request outstanding */
+    TBitArray<> HistoryPollsInFlight;
+    FTSTicker::FDelegateHandle PollTickerHandle;
+
+    FComfyWorkflowTemplate Template;
+    TArray<FComfyUIBatchVariant> Variants;
+    TArray<FComfyUIBatchItemResult> Results;
+    FString ClientId;
+    FComfyUIBatchCompleteDelegateNative OnComplete;
+
+    int32 NextVariant = 0;
+    int32 PostsInFlight = 0;
+    int32 NumFinished = 0;
+    double StartTime = 0.0;
+    double LastProgressTime = 0.0;
+    float TimeoutSeconds = 600.0f;
+};
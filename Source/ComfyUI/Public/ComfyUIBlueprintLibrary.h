@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "Engine/LatentActionManager.h"
 #include "ComfyUIRequestTypes.h"
 #include "ComfyUIBlueprintLibrary.generated.h"
 
@@ -27,6 +28,15 @@ public:
     UFUNCTION(BlueprintCallable, Category = "ComfyUI")
     static void SubmitWorkflowJson(const FString& WorkflowJson, const FComfyUISubmitOptions& Options, const FComfyUIResponseDelegate& OnComplete);
 
+    /**
+     * Queues BaseWorkflowJson once per variant with that variant's input overrides (seeds,
+     * prompts, sizes...). POSTs are pipelined and OnComplete fires once with every result.
+     * Native code can use FComfyUIBatchSubmitter directly.
+     */
+    UFUNCTION(BlueprintCallable, Category = "ComfyUI")
+    static void SubmitWorkflowBatch(const FString& BaseWorkflowJson, const TArray<FComfyUIBatchVariant>& Variants,
+        const FComfyUISubmitOptions& Options, const FComfyUIBatchCompleteDelegate& OnComplete);
+
     // --- Workflow Builders ---
 
     UFUNCTION(BlueprintCallable, Category = "ComfyUI")
@@ -46,15 +56,48 @@ public:
     UFUNCTION(BlueprintCallable, Category = "ComfyUI")
     static UTexture2D* LoadImageFromFile(const FString& FilePath);
 
+    /** Reads and decodes on a worker thread; only the texture upload runs on the game thread */
+    UFUNCTION(BlueprintCallable, Category = "ComfyUI", meta = (Latent, LatentInfo = "LatentInfo", WorldContext = "WorldContextObject"))
+    static void LoadImageFromFileAsync(UObject* WorldContextObject, const FString& FilePath, UTexture2D*& Texture, FLatentActionInfo LatentInfo);
+
     UFUNCTION(BlueprintPure, Category = "ComfyUI")
     static FString GetComfyUIOutputFolder();
 
+    /** Newest file in the local output folder by prefix. Prefer GetOutputsForPrompt when the prompt id is known. */
     UFUNCTION(BlueprintCallable, Category = "ComfyUI")
     static FString GetLatestOutputImage(const FString& FilenamePrefix);
 
+    /**
+     * Exact images (filename, subfolder, type) PromptId produced, read from the server's
+     * /history and cached per prompt. Works against remote servers; fetch the files with
+     * /view. Fails while the prompt is still queued or running.
+     */
+    UFUNCTION(BlueprintCallable, Category = "ComfyUI")
+    static void GetOutputsForPrompt(const FString& PromptId, const FComfyUIOutputsDelegate& OnComplete);
+
     UFUNCTION(BlueprintCallable, Category = "ComfyUI", meta = (DisplayName = "Import Image As Asset"))
     static UTexture2D* ImportImageAsAsset(const FString& SourceFilePath, const FString& DestAssetPath);
 
+    /**
+     * Imports SourceFilePaths[i] as a texture asset at DestAssetPaths[i]. Files are read and
+     * decoded in parallel on worker threads a few at a time, and each group's packages are
+     * created on the game thread as it lands, so memory doesn't grow with the batch. All
+     * assets are announced to the asset registry together at the end. The assets get the source format,
+     * sRGB, alpha and default settings ImportImageAsAsset's texture factory would give them;
+     * formats it decodes specially (HDR, EXR, ...) are imported through the factory itself.
+     * Compression still happens in the texture compiling manager's async build, so the
+     * assets may not be ready to render when OnComplete runs. OnComplete gets one entry per
+     * source, nullptr where that import failed. Outside the editor, like ImportImageAsAsset,
+     * the entries are transient textures rather than assets.
+     */
+    static void ImportImagesAsAssets(const TArray<FString>& SourceFilePaths, const TArray<FString>& DestAssetPaths,
+        TFunction<void(const TArray<UTexture2D*>& /*Textures*/)> OnComplete);
+
+    /** Blueprint version of ImportImagesAsAssets; Textures is parallel to SourceFilePaths */
+    UFUNCTION(BlueprintCallable, Category = "ComfyUI", meta = (Latent, LatentInfo = "LatentInfo", WorldContext = "WorldContextObject", DisplayName = "Import Images As Assets"))
+    static void ImportImagesAsAssetsAsync(UObject* WorldContextObject, const TArray<FString>& SourceFilePaths, const TArray<FString>& DestAssetPaths,
+        TArray<UTexture2D*>& Textures, FLatentActionInfo LatentInfo);
+
     UFUNCTION(BlueprintPure, Category = "ComfyUI")
     static FString GenerateUniqueAssetName(const FString& BasePath, const FString& BaseName);
 
@@ -63,6 +106,19 @@ public:
     UFUNCTION(BlueprintCallable, Category = "ComfyUI")
     static void WatchWorkflowCompletion(const FString& PromptId, const FComfyUIWorkflowCompleteDelegate& OnComplete);
 
+    /**
+     * Streams sampler steps, node events and queue length for PromptId until it finishes.
+     * Does nothing for a prompt the socket has already seen finish. A prompt that never
+     * runs never finishes either; call StopWatchingWorkflowProgress to drop the listeners.
+     */
+    UFUNCTION(BlueprintCallable, Category = "ComfyUI")
+    static void WatchWorkflowProgress(const FString& PromptId, const FComfyUIProgressDelegate& OnProgress,
+        const FComfyUINodeEventDelegate& OnNodeEvent, const FComfyUIQueueStatusDelegate& OnQueueStatus);
+
+    /** Unbinds every WatchWorkflowProgress listener for PromptId */
+    UFUNCTION(BlueprintCallable, Category = "ComfyUI")
+    static void StopWatchingWorkflowProgress(const FString& PromptId);
+
 private:
     static FString GetBaseUrl();
     static void TryEnsurePortable();
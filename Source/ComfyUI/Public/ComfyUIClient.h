@@ -0,0 +1,158 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Dom/JsonObject.h"
+#include "ComfyUIRequestTypes.h"
+
+/** Form fields sent with /upload/image */
+struct FComfyUIUploadOptions
+{
+    /** Folder under the server's input directory; empty for input/ itself */
+    FString Subfolder;
+
+    /** Replace an existing file of the same name instead of letting the server rename the upload */
+    bool bOverwrite = false;
+};
+
+/**
+ * Shared HTTP client for the ComfyUI REST API, owned by FComfyUIModule.
+ *
+ * Every request goes through this one object so the base URL is resolved once
+ * (and re-resolved only when UComfyUISettings changes) and per-endpoint
+ * request metrics are collected in a single place.
+ *
+ * Extra servers in a backend pool get their own client bound to a fixed URL instead.
+ *
+ * All callbacks fire on the game thread.
+ */
+class COMFYUI_API FComfyUIClient : public TSharedFromThis<FComfyUIClient>
+{
+public:
+    using FOnJsonResponse = TFunction<void(bool /*bSuccess*/, const FString& /*ResponseJson*/)>;
+    using FOnPromptQueued = TFunction<void(bool /*bSuccess*/, const FString& /*PromptId*/, const FString& /*ResponseJson*/)>;
+    using FOnHistory      = TFunction<void(bool /*bSuccess*/, const TSharedPtr<FJsonObject>& /*History*/)>;
+    using FOnOutputs      = TFunction<void(bool /*bSuccess*/, const TArray<FComfyUIOutputImage>& /*Outputs*/)>;
+    using FOnImageData    = TFunction<void(bool /*bSuccess*/, const TArray<uint8>& /*ImageData*/)>;
+    using FOnUploaded     = TFunction<void(bool /*bSuccess*/, const FString& /*StoredFilename*/)>;
+    using FOnUploadedAll  = TFunction<void(bool /*bAllSucceeded*/, const TArray<FString>& /*StoredFilenames*/)>;
+    using FOnDownloaded   = TFunction<void(bool /*bSuccess*/, const FString& /*FilePath*/)>;
+    using FOnProgress     = TFunction<void(int64 /*BytesReceived*/, int64 /*TotalBytes*/)>;
+
+    struct FEndpointStats
+    {
+        int32 NumRequests = 0;
+        int32 NumFailures = 0;
+        double TotalSeconds = 0.0;
+        double MaxSeconds = 0.0;
+    };
+
+    /** Empty FixedBaseUrl follows UComfyUISettings::BaseUrl; otherwise the client always talks to FixedBaseUrl */
+    explicit FComfyUIClient(const FString& FixedBaseUrl = FString());
+    ~FComfyUIClient();
+
+    /** Base URL from settings without a trailing slash. Cached until the settings change. */
+    const FString& GetBaseUrl();
+
+    /** ws:// (or wss://) URL of the server's /ws endpoint, optionally bound to a client id */
+    FString GetWebSocketUrl(const FString& ClientId = FString());
+
+    /** Drops the cached base URL so the next request re-reads UComfyUISettings. No-op for a fixed URL. */
+    void InvalidateBaseUrl();
+
+    // --- Typed endpoints ---
+
+    /** GET /system_stats. TimeoutSeconds <= 0 uses the HTTP module default. */
+    void GetSystemStats(FOnJsonResponse OnComplete, float TimeoutSeconds = 0.0f);
+
+    /** GET /queue: the prompts running and pending on the server */
+    void GetQueue(FOnJsonResponse OnComplete, float TimeoutSeconds = 0.0f);
+
+    /** POST /prompt with an already wrapped {"prompt": ..., "client_id": ...} body */
+    void PostPrompt(const FString& RequestBody, FOnPromptQueued OnComplete);
+
+    /** GET /history/{PromptId}. History is the full response object keyed by prompt id. */
+    void GetHistory(const FString& PromptId, FOnHistory OnComplete);
+
+    /** GET /history?max_items=N. The MaxItems most recent prompts in one response, keyed by prompt id. */
+    void GetHistoryBatch(int32 MaxItems, FOnHistory OnComplete);
+
+    /**
+     * Every image a finished prompt produced, from GET /history/{PromptId}. Fails if the
+     * prompt isn't in the server's history yet. A finished prompt's outputs never change,
+     * so once found they are cached and later calls answer without a request; concurrent
+     * calls for the same prompt share one request.
+     */
+    void GetOutputs(const FString& PromptId, FOnOutputs OnComplete);
+
+    /** GET /view for a single output/input/temp image */
+    void GetView(const FString& Filename, const FString& Subfolder, const FString& Type, FOnImageData OnComplete);
+
+    /**
+     * GET /view streamed straight into DestPath, for results too large to hold in memory.
+     * The body is written to DestPath.part through a small file buffer as it arrives and
+     * renamed over DestPath only once complete, so DestPath never holds a partial image.
+     * OnProgress reports bytes received; TotalBytes is 0 until the server sends a length.
+     */
+    void DownloadView(const FString& Filename, const FString& Subfolder, const FString& Type, const FString& DestPath,
+        FOnDownloaded OnComplete, FOnProgress OnProgress = nullptr);
+
+    /**
+     * POST /upload/image as multipart/form-data. Reports the filename ComfyUI stored it as,
+     * "subfolder/name" when it went into a subfolder, ready to pass to a LoadImage node.
+     * Files are hashed off the game thread first; content this server already has is not sent
+     * again. A cached name is trusted only if a HEAD /view on it reports the file's size, so an
+     * unrelated upload that reused the name after the input folder was cleaned is caught. The
+     * body streams from disk.
+     */
+    void UploadImage(const FString& LocalFilePath, FOnUploaded OnComplete, const FComfyUIUploadOptions& Options = FComfyUIUploadOptions());
+
+    /**
+     * Uploads several files concurrently, one request each since /upload/image takes a
+     * single image per form. StoredFilenames is parallel to LocalFilePaths.
+     */
+    void UploadImages(const TArray<FString>& LocalFilePaths, FOnUploadedAll OnComplete, const FComfyUIUploadOptions& Options = FComfyUIUploadOptions());
+
+    /** Collects every image listed under History[PromptId].outputs, in node order */
+    static void ExtractOutputImages(const TSharedPtr<FJsonObject>& History, const FString& PromptId, TArray<FComfyUIOutputImage>& OutImages);
+
+    /** Collects the prompt ids running or pending in a /queue response. False if QueueJson doesn't parse. */
+    static bool ExtractQueuedPromptIds(const FString& QueueJson, TSet<FString>& OutPromptIds);
+
+    // --- Metrics ---
+
+    const TMap<FString, FEndpointStats>& GetEndpointStats() const { return EndpointStats; }
+    void LogStats() const;
+
+private:
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> CreateRequest(const FString& Verb, const FString& Path);
+    static FString MakeViewPath(const FString& Filename, const FString& Subfolder, const FString& Type);
+
+    /** Binds completion, records metrics for Endpoint and fires the request */
+    void Dispatch(const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>& Request, const FString& Endpoint,
+        TFunction<void(bool /*bOk*/, FHttpResponsePtr /*Response*/)> OnComplete);
+
+    /** Reuses the server's copy of the file when the upload cache has a live entry for Hash */
+    void UploadHashed(const FString& LocalFilePath, uint64 Hash, int64 Size, const FComfyUIUploadOptions& Options, FOnUploaded OnComplete);
+
+    /** Sends the file; Hash 0 skips recording the result in the upload cache */
+    void PostUpload(const FString& LocalFilePath, uint64 Hash, int64 Size, const FComfyUIUploadOptions& Options, FOnUploaded OnComplete);
+
+    /** Dispatches a /history request and parses the response object */
+    void DispatchHistory(const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>& Request, FOnHistory OnComplete);
+
+    void OnSettingsChanged(UObject* Settings, struct FPropertyChangedEvent& PropertyChangedEvent);
+
+    FString CachedBaseUrl;
+    bool bBaseUrlResolved = false;
+    bool bFixedBaseUrl = false;
+    FDelegateHandle SettingsChangedHandle;
+
+    TMap<FString, FEndpointStats> EndpointStats;
+
+    /** Prompt id -> outputs, for prompts already found in /history */
+    TMap<FString, TArray<FComfyUIOutputImage>> OutputCache;
+
+    /** Callers waiting on an in-flight GetOutputs request, by prompt id */
+    TMap<FString, TArray<FOnOutputs>> PendingOutputs;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ComfyUIRequestTypes.h"
+#include "Math/Float16Color.h"
+
+struct FComfyUIDecodedImage;
+
+// ============================================================================
+// FComfyUIHDRImage
+// ============================================================================
+struct COMFYUI_API FComfyUIHDRImage
+{
+    int32 Width = 0;
+    int32 Height = 0;
+
+    /** Linear RGBA32F pixels, row major. Layout matches ERGBFormat::RGBAF / TSF_RGBA32F. */
+    TArray64<FLinearColor> Pixels;
+
+    bool IsValid() const
+    {
+        return Width > 0 && Height > 0 && Pixels.Num() == (int64)Width * Height;
+    }
+};
+
+struct FComfyUIHDRParams
+{
+    EComfyUIHDROperator Operator = EComfyUIHDROperator::LegacyBoost;
+
+    /** InverseReinhard only: luminance that pure white expands to */
+    float MaxLuminance = 16.0f;
+
+    /** Applied after every operator, in stops */
+    float ExposureEV = 0.0f;
+};
+
+namespace ComfyUIHDR
+{
+    /**
+     * Expands an 8-bit panorama into HDR for lighting. The transfer curve is decoded
+     * through a lookup table, then Params.Operator scales each pixel by a factor of its
+     * luminance, so bright areas (sky, light sources) give an HDRI Backdrop meaningful
+     * intensity variation. The default parameters reproduce the original conversion.
+     *
+     * Rows are converted in parallel with SIMD math per pixel, writing straight into
+     * OutImage. Safe to call from any thread.
+     */
+    COMFYUI_API bool ConvertLDRToHDR(const FComfyUIDecodedImage& Source, FComfyUIHDRImage& OutImage,
+        const FComfyUIHDRParams& Params = FComfyUIHDRParams());
+
+    /** Packs Image into Width * Height half-float pixels at OutPixels, rows in parallel */
+    COMFYUI_API void ConvertToHalf(const FComfyUIHDRImage& Image, FFloat16Color* OutPixels);
+
+    /**
+     * Cube face size for an equirect panorama: RequestedSize (or a quarter of the panorama
+     * width when 0) rounded up to a power of two and clamped to 32..4096.
+     */
+    COMFYUI_API int32 GetCubeFaceSize(const FComfyUIHDRImage& Equirect, int32 RequestedSize);
+
+    /** Mips in a full chain down to 1x1 for a power-of-two FaceSize */
+    COMFYUI_API int32 GetCubeMipCount(int32 FaceSize);
+
+    /**
+     * Resamples an equirect panorama into the six faces of a cubemap and box-filters a
+     * full mip chain from them. MipData[Mip] points at that mip's six faces, back to back
+     * in the engine's face order (+X, -X, +Y, -Y, +Z, -Z) - the layout FTextureSource
+     * uses for a six-slice cube. Directions follow the engine's long-lat convention, so
+     * the result matches what the texture build would produce from the equirect source.
+     *
+     * Runs in parallel over faces and rows; each mip waits for the one above it.
+     */
+    COMFYUI_API void BakeCubeFaces(const FComfyUIHDRImage& Equirect, int32 FaceSize, TConstArrayView<FLinearColor*> MipData);
+    COMFYUI_API void BakeCubeFaces(const FComfyUIHDRImage& Equirect, int32 FaceSize, TConstArrayView<FFloat16Color*> MipData);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+
+class UTexture2D;
+
+// ============================================================================
+// FComfyUIDecodedImage
+// ============================================================================
+struct COMFYUI_API FComfyUIDecodedImage
+{
+    int32 Width = 0;
+    int32 Height = 0;
+
+    /** Tightly packed BGRA8 pixels, Width * Height * 4 bytes */
+    TArray64<uint8> Pixels;
+
+    bool IsValid() const
+    {
+        return Width > 0 && Height > 0 && Pixels.Num() == (int64)Width * Height * 4;
+    }
+};
+
+namespace ComfyUIImage
+{
+    /**
+     * Decodes PNG/JPEG/BMP bytes into BGRA8. The format is detected from the data.
+     * Safe to call from worker threads once the ImageWrapper module is loaded.
+     */
+    COMFYUI_API bool DecodeToBGRA(const void* CompressedData, int64 CompressedSize, FComfyUIDecodedImage& OutImage);
+
+    /** Loads the ImageWrapper module. Must run on the game thread before any worker decodes. */
+    COMFYUI_API void PreloadImageWrapperModule();
+
+    /**
+     * Creates a transient BGRA8 texture holding Image. The pixels are copied into the
+     * mip once and Image is emptied; the mip memory is handed to the render resource
+     * and freed after upload, so the texture keeps no CPU copy. Game thread only.
+     *
+     * The render resource is the only copy of the pixels: callers must never call
+     * UpdateResource or ReleaseResource on the result, which would leave it black.
+     * Change its pixels through UpdateOrCreateTransientTexture instead.
+     */
+    COMFYUI_API UTexture2D* CreateTransientTexture(FComfyUIDecodedImage&& Image);
+
+    /**
+     * Pushes Image into Existing when it is a transient BGRA8 texture of the same size,
+     * otherwise creates a new transient texture. When reusing, pixels are moved into the
+     * render command and freed after upload. Textures from CreateTransientTexture must
+     * still have the resource they were created with. Game thread only.
+     */
+    COMFYUI_API UTexture2D* UpdateOrCreateTransientTexture(UTexture2D* Existing, FComfyUIDecodedImage&& Image);
+
+    /**
+     * Reads and decodes FilePath on a worker thread. The future holds an invalid
+     * image if the file could not be read or decoded. Call from the game thread.
+     */
+    COMFYUI_API TFuture<FComfyUIDecodedImage> DecodeFileAsync(const FString& FilePath);
+
+    /**
+     * Reads and decodes on a worker, then creates the transient texture on the game
+     * thread, which is where the future is fulfilled (nullptr on failure). The texture
+     * is not rooted: continuations that keep it must reference it before returning.
+     */
+    COMFYUI_API TFuture<UTexture2D*> LoadImageFromFileAsync(const FString& FilePath);
+}
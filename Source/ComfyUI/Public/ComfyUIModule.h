@@ -4,6 +4,9 @@
 #include "Modules/ModuleManager.h"
 
 class FComfyUIWebSocketHandler;
+class FComfyUIClient;
+class FComfyUIOutputIndex;
+class FComfyUIBackendPool;
 
 class COMFYUI_API FComfyUIModule final : public IModuleInterface
 {
@@ -17,12 +20,28 @@ public:
     /** Force-starts ComfyUI regardless of bAutoStartPortable (for user-initiated starts) */
     bool ForceStartPortable();
 
+    /** Socket of the Base URL server. Prompts may run elsewhere; see GetBackendPool. */
     TSharedPtr<FComfyUIWebSocketHandler> GetWebSocketHandler();
 
+    /** HTTP client for the Base URL server */
+    TSharedPtr<FComfyUIClient> GetClient();
+
+    /** Every configured server; dispatches new prompts and remembers where each one runs */
+    TSharedPtr<FComfyUIBackendPool> GetBackendPool();
+
+    /** Index of ComfyUI's output folder, used for latest-output lookups */
+    TSharedPtr<FComfyUIOutputIndex> GetOutputIndex();
+
 private:
     /** Internal launch logic shared by both methods */
     bool LaunchPortable();
+
+    /** Points the output index at the configured folder so its scan runs before the first lookup */
+    void PrimeOutputIndex();
     
     FProcHandle PortableHandle;
     TSharedPtr<FComfyUIWebSocketHandler> WebSocketHandler;
+    TSharedPtr<FComfyUIClient> Client;
+    TSharedPtr<FComfyUIOutputIndex> OutputIndex;
+    TSharedPtr<FComfyUIBackendPool> BackendPool;
 };
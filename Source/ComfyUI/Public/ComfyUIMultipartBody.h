@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Serialization/Archive.h"
+
+class IFileHandle;
+
+/**
+ * multipart/form-data request body that reads file parts from disk as it is sent.
+ *
+ * Pass it to IHttpRequest::SetContentFromStream. Only the boundary lines and
+ * field headers are held in memory; file contents are read in whatever chunk
+ * size the HTTP module asks for, so uploading a large plate costs a file handle
+ * rather than a copy of the file. Files are sized when added and must not change
+ * until the request completes. Add every part, then call Finish.
+ */
+class COMFYUI_API FComfyUIMultipartBody : public FArchive
+{
+public:
+    FComfyUIMultipartBody();
+    virtual ~FComfyUIMultipartBody() override;
+
+    /** Plain form field, e.g. "subfolder" or "overwrite" */
+    void AddField(const FString& Name, const FString& Value);
+
+    /** File field streamed from FilePath. Returns false if the file can't be sized. */
+    bool AddFile(const FString& Name, const FString& FilePath);
+
+    /** Appends the closing boundary; no parts can be added afterwards */
+    void Finish();
+
+    /** Value for the request's Content-Type header, including the boundary */
+    FString GetContentType() const;
+
+    // FArchive
+    virtual void Serialize(void* Data, int64 Num) override;
+    virtual int64 TotalSize() override { return Size; }
+    virtual int64 Tell() override { return Pos; }
+    virtual void Seek(int64 InPos) override;
+    virtual bool Close() override;
+    virtual FString GetArchiveName() const override { return TEXT("FComfyUIMultipartBody"); }
+
+private:
+    struct FPart
+    {
+        TArray<uint8> Bytes;    // in-memory part, or empty for a file part
+        FString FilePath;
+        int64 Offset = 0;       // where the part starts in the body
+        int64 Length = 0;
+    };
+
+    void AppendText(const FString& Text);
+
+    FString Boundary;
+    TArray<FPart> Parts;
+    int64 Size = 0;
+    int64 Pos = 0;
+    bool bFinished = false;
+
+    /** File part currently open for reading; parts are read in order so one handle suffices */
+    TUniquePtr<IFileHandle> OpenFile;
+    int32 OpenPart = INDEX_NONE;
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+
+struct FFileChangeData;
+
+/**
+ * Index of the PNGs in ComfyUI's output folder, grouped by filename prefix.
+ *
+ * ComfyUI saves images as "<prefix>_<counter>_.png". Each <prefix> gets its own list,
+ * kept newest first, and the prefixes are also kept sorted so a lookup only visits the
+ * groups it can match. The index is written to Saved/ComfyUI on shutdown; on the next
+ * start the saved copy is reconciled against a names-only listing on a worker thread, so
+ * only files that appeared while the editor was closed are stat'ed. The module sets the
+ * folder right after engine init, and lookups answer from the saved copy until that scan
+ * lands, waiting for it only when the saved copy has no match. In the editor a directory
+ * watcher keeps the index current from then on. Without a watcher (non-editor builds) a
+ * lookup stats the folder itself and reconciles only when its timestamp has moved.
+ *
+ * Game thread only.
+ */
+class COMFYUI_API FComfyUIOutputIndex
+{
+public:
+    ~FComfyUIOutputIndex();
+
+    /** Tracks InFolder, discarding the index if it belonged to a different folder */
+    void SetFolder(const FString& InFolder);
+
+    /**
+     * Full path of the newest file whose name starts with FilenamePrefix, or empty if none.
+     * An empty prefix matches everything. Cost depends on the number of prefixes that
+     * match, not the number of files.
+     */
+    FString FindLatest(const FString& FilenamePrefix);
+
+    /** Stops watching and writes the index to disk */
+    void Shutdown();
+
+private:
+    struct FEntry
+    {
+        FString Filename;
+        int64 Ticks = 0;
+    };
+
+    struct FScanResult
+    {
+        /** Every PNG currently in the folder */
+        TArray<FString> Filenames;
+
+        /** Timestamps for the files the index did not know about when the scan started */
+        TArray<FEntry> NewEntries;
+    };
+
+    FString FindLatestIndexed(const FString& FilenamePrefix) const;
+
+    static FString GetGroupKey(const FString& Filename);
+    static FString GetIndexPath();
+
+    void Insert(FEntry&& Entry);
+    bool Remove(const FString& Filename);
+
+    void StartScan();
+    void FinishScan();
+    void ApplyScan(const FScanResult& Result);
+
+    void StartWatching();
+    void StopWatching();
+    void OnDirectoryChanged(const TArray<FFileChangeData>& Changes);
+
+    void Load();
+    void Save();
+
+    FString Folder;
+
+    /** Prefix -> entries, newest first */
+    TMap<FString, TArray<FEntry>> Groups;
+
+    /** Keys of Groups in lexical order, so the keys starting with a prefix are one contiguous run */
+    TArray<FString> SortedKeys;
+
+    TFuture<FScanResult> PendingScan;
+
+    /** Filenames the watcher reported while a scan was running; the scan's view of them is stale */
+    TSet<FString> ChangedDuringScan;
+
+    FDelegateHandle WatcherHandle;
+    bool bDirty = false;
+
+    /** Folder timestamp when the last scan started; non-editor builds rescan when it moves */
+    FDateTime ScannedFolderTime;
+};
@@ -44,6 +44,10 @@ struct FComfyUISimpleWorkflowParams
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
     int32 Height = 512;
 
+    /** Images sampled in one pass from the same latent batch; all of them are saved */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI", meta = (ClampMin = "1", ClampMax = "64"))
+    int32 BatchSize = 1;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
     int32 Seed = -1;
 
@@ -86,6 +90,9 @@ struct FComfyUIFlux2WorkflowParams
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
     int32 Height = 1024;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI", meta = (ClampMin = "1", ClampMax = "64"))
+    int32 BatchSize = 1;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
     int32 Seed = -1;
 
@@ -106,6 +113,18 @@ enum class EComfyUIModelFamily : uint8
     Qwen    UMETA(DisplayName = "Qwen")
 };
 
+// How an 8-bit panorama is expanded to HDR for lighting
+UENUM(BlueprintType)
+enum class EComfyUIHDROperator : uint8
+{
+    // Gamma 2.2 decode, then highlights boosted by 1 + L^2 * 8
+    LegacyBoost     UMETA(DisplayName = "Legacy Boost"),
+    // Exact sRGB EOTF with no expansion; display-referred linear
+    SRGB            UMETA(DisplayName = "sRGB Linear"),
+    // sRGB EOTF, then inverse Reinhard mapping white up to a maximum luminance
+    InverseReinhard UMETA(DisplayName = "Inverse Reinhard")
+};
+
 USTRUCT(BlueprintType)
 struct FComfyUIQwenGenerateParams
 {
@@ -138,6 +157,9 @@ struct FComfyUIQwenGenerateParams
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
     int32 Height = 1024;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI", meta = (ClampMin = "1", ClampMax = "64"))
+    int32 BatchSize = 1;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
     int32 Seed = -1;
 
@@ -209,12 +231,121 @@ struct FComfyUISubmitOptions
     FString ClientId;
 };
 
+// ============================================================================
+// Batch submission
+// ============================================================================
+
+UENUM(BlueprintType)
+enum class EComfyUIInputValueType : uint8
+{
+    String  UMETA(DisplayName = "String"),
+    Number  UMETA(DisplayName = "Number"),
+    Bool    UMETA(DisplayName = "Bool")
+};
+
+// Replaces one node input of the base workflow, e.g. node "3" input "seed"
+USTRUCT(BlueprintType)
+struct FComfyUIInputOverride
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
+    FString NodeId;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
+    FString InputName;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
+    EComfyUIInputValueType ValueType = EComfyUIInputValueType::String;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
+    FString StringValue;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
+    double NumberValue = 0.0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
+    bool bBoolValue = false;
+};
+
+// One prompt of a batch: the base workflow with these inputs replaced
+USTRUCT(BlueprintType)
+struct FComfyUIBatchVariant
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
+    TArray<FComfyUIInputOverride> Overrides;
+};
+
+// An image listed in a prompt's /history outputs, addressable through /view
+USTRUCT(BlueprintType)
+struct FComfyUIOutputImage
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
+    FString Filename;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
+    FString Subfolder;
+
+    // "output", "temp" or "input"
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
+    FString Type;
+};
+
+USTRUCT(BlueprintType)
+struct FComfyUIBatchItemResult
+{
+    GENERATED_BODY()
+
+    // Index into the submitted variant list
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
+    int32 VariantIndex = INDEX_NONE;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
+    FString PromptId;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
+    bool bSuccess = false;
+
+    // Saved ("output" type) images on the server
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
+    TArray<FComfyUIOutputImage> Images;
+
+    // The same images in the local ComfyUI output folder, when it is known. Empty for
+    // variants that ran on an additional backend, whose files never reach that folder.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI")
+    TArray<FString> OutputPaths;
+};
+
+UENUM(BlueprintType)
+enum class EComfyUINodeEvent : uint8
+{
+    Executing   UMETA(DisplayName = "Executing"),
+    Executed    UMETA(DisplayName = "Executed"),
+    Cached      UMETA(DisplayName = "Cached")
+};
+
 // Delegates
 DECLARE_DYNAMIC_DELEGATE_TwoParams(FComfyUIResponseDelegate, bool, bSuccess, const FString&, ResponseJson);
 
 // Dynamic delegate for Blueprint-exposed workflow completion
 DECLARE_DYNAMIC_DELEGATE_TwoParams(FComfyUIWorkflowCompleteDelegate, bool, bSuccess, const FString&, PromptId);
 
+// Dynamic delegates for Blueprint-exposed execution events of a single prompt
+DECLARE_DYNAMIC_DELEGATE_FourParams(FComfyUIProgressDelegate, const FString&, PromptId, const FString&, NodeId, int32, Value, int32, Max);
+DECLARE_DYNAMIC_DELEGATE_ThreeParams(FComfyUINodeEventDelegate, const FString&, PromptId, const FString&, NodeId, EComfyUINodeEvent, Event);
+DECLARE_DYNAMIC_DELEGATE_OneParam(FComfyUIQueueStatusDelegate, int32, QueueRemaining);
+
+// Fires once when every variant of a batch has finished or failed
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FComfyUIBatchCompleteDelegate, bool, bAllSucceeded, const TArray<FComfyUIBatchItemResult>&, Results);
+
+// Outputs of one prompt as listed in /history
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FComfyUIOutputsDelegate, bool, bSuccess, const TArray<FComfyUIOutputImage>&, Outputs);
+
 // Non-dynamic delegates for C++ internal use (editor panel, websocket)
 DECLARE_DELEGATE_ThreeParams(FComfyUIResponseDelegateNative, bool /*bSuccess*/, const FString& /*ResponseJson*/, const FString& /*PromptId*/);
 DECLARE_DELEGATE_TwoParams(FComfyUIWorkflowCompleteDelegateNative, bool /*bSuccess*/, const FString& /*PromptId*/);
+DECLARE_DELEGATE_TwoParams(FComfyUIBatchCompleteDelegateNative, bool /*bAllSucceeded*/, const TArray<FComfyUIBatchItemResult>& /*Results*/);
@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DeveloperSettings.h"
+#include "ComfyUIHDRUtils.h"
 #include "ComfyUISettings.generated.h"
 
 UCLASS(config = Game, defaultconfig, meta = (DisplayName = "ComfyUI"))
@@ -16,6 +17,11 @@ public:
         meta = (DisplayName = "Base URL"))
     FString BaseUrl = TEXT("http://127.0.0.1:8188");
 
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Connection",
+        meta = (DisplayName = "Additional Backend URLs",
+        ToolTip = "Other ComfyUI servers to spread prompts across. Each prompt goes to the server with the shortest queue, ties going to the one with the most free VRAM, and stays there for progress, history and downloads. Leave empty to use Base URL only."))
+    TArray<FString> AdditionalBackendUrls;
+
     UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Portable",
         meta = (DisplayName = "Auto Start Portable"))
     bool bAutoStartPortable = false;
@@ -33,6 +39,44 @@ public:
         meta = (DisplayName = "Portable Arguments"))
     FString PortableArgs;
 
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "HDRI",
+        meta = (DisplayName = "Expansion Operator",
+        ToolTip = "How generated panoramas are expanded to HDR before import. Time each with the ComfyUI.BenchmarkHDR console command."))
+    EComfyUIHDROperator HDROperator = EComfyUIHDROperator::LegacyBoost;
+
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "HDRI",
+        meta = (DisplayName = "Max Luminance", ClampMin = "1.0", UIMin = "1.0", UIMax = "100.0",
+        EditCondition = "HDROperator == EComfyUIHDROperator::InverseReinhard"))
+    float HDRMaxLuminance = 16.0f;
+
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "HDRI",
+        meta = (DisplayName = "Exposure (EV)", UIMin = "-4.0", UIMax = "4.0"))
+    float HDRExposureEV = 0.0f;
+
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "HDRI",
+        meta = (DisplayName = "Half-Float Source",
+        ToolTip = "Store imported HDRI source data as RGBA16F instead of RGBA32F. Halves the asset's source size; the built texture is half-float either way."))
+    bool bHDRIHalfFloatSource = true;
+
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "HDRI",
+        meta = (DisplayName = "Also Write EXR",
+        ToolTip = "Save a float EXR next to the downloaded panorama in the background. Not needed for the import."))
+    bool bWriteHDRIExr = false;
+
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "HDRI",
+        meta = (DisplayName = "Bake Cube Faces",
+        ToolTip = "Resample the panorama into six cube faces with mips when importing, instead of storing it long-lat and leaving the conversion to the texture build."))
+    bool bBakeHDRICubeFaces = true;
+
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "HDRI",
+        meta = (DisplayName = "Cube Face Size", ClampMin = "0", ClampMax = "4096",
+        ToolTip = "Edge length of each baked face, rounded up to a power of two. 0 picks a quarter of the panorama width.",
+        EditCondition = "bBakeHDRICubeFaces"))
+    int32 HDRICubeFaceSize = 0;
+
+    /** HDR conversion parameters from the HDRI settings above */
+    FComfyUIHDRParams GetHDRParams() const;
+
     /** Returns PortableRoot if set, otherwise auto-detects from plugin directory */
     FString GetEffectivePortableRoot() const;
 };
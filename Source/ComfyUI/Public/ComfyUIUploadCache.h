@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+
+/**
+ * Remembers which local image contents have already been uploaded to which server.
+ *
+ * Entries map an XXH64 of the file bytes to the filename /upload/image stored it
+ * as, and the file's size, per base URL, so re-running img2img or 360 on the same
+ * plate can reuse the server copy instead of sending it again. Entries are hints
+ * only: the caller checks the server still has a file of that name and size before
+ * use and forgets stale ones.
+ *
+ * One instance is shared by every client, since they all persist to the same JSON
+ * file under Saved/ComfyUI. Loaded on first use; changes are written a few seconds
+ * after the last one and on Flush. Game thread only.
+ */
+class COMFYUI_API FComfyUIUploadCache
+{
+public:
+    struct FEntry
+    {
+        FString StoredFilename;
+        int64 Size = 0;
+    };
+
+    static FComfyUIUploadCache& Get();
+
+    ~FComfyUIUploadCache();
+
+    /** Entry for Hash on ServerUrl, or nullptr if it was never uploaded there */
+    const FEntry* Find(const FString& ServerUrl, uint64 Hash);
+
+    void Add(const FString& ServerUrl, uint64 Hash, const FString& StoredFilename, int64 Size);
+    void Remove(const FString& ServerUrl, uint64 Hash);
+
+    /** Writes pending changes now instead of waiting for the deferred save */
+    void Flush();
+
+private:
+    FComfyUIUploadCache() = default;
+
+    void LoadIfNeeded();
+    void ScheduleSave();
+    bool OnSaveTick(float DeltaTime);
+    void Save();
+    static FString GetCachePath();
+
+    /** ServerUrl -> content hash -> entry */
+    TMap<FString, TMap<uint64, FEntry>> Entries;
+    bool bLoaded = false;
+    bool bDirty = false;
+    FTSTicker::FDelegateHandle SaveTickerHandle;
+};
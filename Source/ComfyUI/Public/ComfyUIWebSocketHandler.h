@@ -2,32 +2,167 @@
 
 #include "CoreMinimal.h"
 #include "IWebSocket.h"
+#include "Containers/Ticker.h"
 #include "ComfyUIRequestTypes.h"
 
+class UTexture2D;
+class FJsonObject;
+class FComfyUIClient;
+struct FComfyUIDecodedImage;
+
 DECLARE_MULTICAST_DELEGATE(FOnWebSocketConnected);
+DECLARE_MULTICAST_DELEGATE(FOnWebSocketDisconnected);
+
+/** Fired on the game thread each time a latent preview frame has been decoded into the preview texture */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnComfyUIPreviewUpdated, const FString& /*PromptId*/, UTexture2D* /*Texture*/);
+
+// Execution events parsed from the server's text messages. All fire on the game thread
+// and carry the prompt_id they belong to, so listeners filter for their own jobs.
+DECLARE_MULTICAST_DELEGATE_FourParams(FOnComfyUIProgress, const FString& /*PromptId*/, const FString& /*NodeId*/, int32 /*Value*/, int32 /*Max*/);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnComfyUINodeExecuting, const FString& /*PromptId*/, const FString& /*NodeId*/);
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnComfyUINodeExecuted, const FString& /*PromptId*/, const FString& /*NodeId*/, const TSharedPtr<FJsonObject>& /*Output*/);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnComfyUINodesCached, const FString& /*PromptId*/, const TArray<FString>& /*NodeIds*/);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnComfyUIPromptFinished, const FString& /*PromptId*/, bool /*bSuccess*/);
+
+/** Server-wide queue length from "status" messages; not tied to a prompt */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnComfyUIQueueStatus, int32 /*QueueRemaining*/);
 
 class COMFYUI_API FComfyUIWebSocketHandler : public TSharedFromThis<FComfyUIWebSocketHandler>
 {
 public:
-    FComfyUIWebSocketHandler();
+    /** Client is used to reconcile pending prompts against /history after a reconnect */
+    explicit FComfyUIWebSocketHandler(const TSharedPtr<FComfyUIClient>& InClient = nullptr);
     ~FComfyUIWebSocketHandler();
 
     FOnWebSocketConnected OnConnectedEvent;
+    FOnWebSocketDisconnected OnDisconnectedEvent;
+    FOnComfyUIPreviewUpdated OnPreviewUpdated;
+
+    FOnComfyUIProgress OnProgress;
+    FOnComfyUINodeExecuting OnNodeExecuting;
+    FOnComfyUINodeExecuted OnNodeExecuted;
+    FOnComfyUINodesCached OnNodesCached;
+    FOnComfyUIPromptFinished OnPromptFinished;
+    FOnComfyUIQueueStatus OnQueueStatus;
 
+    /**
+     * Opens the socket and keeps it open: if it drops, it is reopened on the same
+     * Url (and therefore the same clientId) with jittered exponential backoff.
+     */
     void Connect(const FString& Url);
+
+    /** Closes the socket and stops reconnecting */
     void Disconnect();
     bool IsConnected() const;
 
+    /** True between Connect and Disconnect, including while reconnecting */
+    bool WantsConnection() const { return bWantsConnection; }
+
+    /** Url last passed to Connect */
+    const FString& GetUrl() const { return SocketUrl; }
+
     void WatchPrompt(const FString& PromptId, const FComfyUIWorkflowCompleteDelegateNative& Callback);
     void UnwatchPrompt(const FString& PromptId);
 
+    /** True while a completion watcher is registered and the socket can deliver it */
+    bool IsTrackingPrompt(const FString& PromptId) const;
+
+    /**
+     * clientId the socket was opened with, empty if it was never connected. ComfyUI sends
+     * a prompt's execution events only to the client_id it was queued with.
+     */
+    FString GetClientId() const;
+
+    /**
+     * Lets execution events for PromptId through without a completion watcher.
+     * Messages for prompts nobody watches or observes are dropped unparsed.
+     * Cleared automatically when the prompt finishes.
+     */
+    void ObservePrompt(const FString& PromptId);
+    void UnobservePrompt(const FString& PromptId);
+
+    /** True if PromptId finished recently without anyone watching it */
+    bool HasPromptFinished(const FString& PromptId) const;
+
+    /**
+     * Last queue_remaining reported by the server, or -1 before the first status message.
+     * Status messages are skipped while OnQueueStatus has no listeners.
+     */
+    int32 GetQueueRemaining() const { return QueueRemaining; }
+
+    /** Transient texture that live preview frames are streamed into. Reused between frames. */
+    UTexture2D* GetPreviewTexture() const { return PreviewTexture; }
+
 private:
+    void OpenSocket();
+    void CloseSocket();
+    void ReleaseSocket();
+    void ScheduleReconnect();
+    bool OnReconnectTick(float DeltaTime);
+
+    /** Fires watchers for prompts that finished while the socket was down, using one /history call */
+    void ReconcilePendingPrompts();
+    void ApplyReconcileHistory(const TSharedPtr<FJsonObject>& History);
+
+    /**
+     * Checks prompts the /history batch didn't list against /queue, then each one left over
+     * against /history/{id}. Prompts in neither were lost (server restart, deleted from the
+     * queue) and are finished as failed so their watchers don't wait forever.
+     */
+    void ReconcileMissingPrompts(const TArray<FString>& PromptIds);
+    void ApplyReconcileQueue(const TArray<FString>& PromptIds, const FString& QueueJson);
+    void ApplyReconcilePromptHistory(const FString& PromptId, const TSharedPtr<FJsonObject>& History);
+    bool IsPromptPending(const FString& PromptId) const;
+
     void OnConnected();
     void OnConnectionError(const FString& Error);
     void OnClosed(int32 StatusCode, const FString& Reason, bool bWasClean);
     void OnMessage(const FString& Message);
+    void OnBinaryMessage(const void* Data, SIZE_T Size, bool bIsLastFragment);
+
+    /** Cheap check on pre-scanned fields, run before any JSON DOM is built */
+    bool WantsMessage(FStringView Type, FStringView PromptId) const;
+    bool IsPromptOfInterest(FStringView PromptId) const;
 
+    // Text message handlers, Data is the message's "data" object
+    void HandleStatus(const TSharedPtr<FJsonObject>& Data);
+    void HandleExecuting(const TSharedPtr<FJsonObject>& Data);
+    void HandleProgress(const TSharedPtr<FJsonObject>& Data);
+    void HandleExecuted(const TSharedPtr<FJsonObject>& Data);
+    void HandleExecutionCached(const TSharedPtr<FJsonObject>& Data);
+    void FinishPrompt(const FString& PromptId, bool bSuccess);
+    void RememberFinishedPrompt(const FString& PromptId, bool bSuccess);
+
+    /** Parses the binary frame header and hands the image payload to a worker for decoding */
+    void HandleBinaryFrame(TArray<uint8>&& Frame);
+    void StartPreviewDecode(const FString& PromptId, TArray<uint8>&& Frame, int32 ImageOffset);
+    void OnPreviewDecoded(const FString& PromptId, bool bDecoded, FComfyUIDecodedImage&& Image);
+    void ReleasePreviewTexture();
+
+    TWeakPtr<FComfyUIClient> Client;
     TSharedPtr<IWebSocket> WebSocket;
     TMap<FString, FComfyUIWorkflowCompleteDelegateNative> PromptCallbacks;
+    TSet<FString> ObservedPrompts;
+
+    /** Oldest first; lets WatchPrompt fire at once for prompts that already finished */
+    TArray<TPair<FString, bool>> RecentlyFinishedPrompts;
     bool bIsConnected = false;
+    int32 QueueRemaining = -1;
+
+    // Reconnect state
+    FString SocketUrl;
+    bool bWantsConnection = false;
+    int32 ReconnectAttempt = 0;
+    FTSTicker::FDelegateHandle ReconnectTickerHandle;
+
+    // Binary preview streaming
+    TArray<uint8> PendingBinaryFrame;
+    UTexture2D* PreviewTexture = nullptr;
+    FString ExecutingPromptId;
+    bool bPreviewDecodeInFlight = false;
+
+    /** Newest frame that arrived while a decode was running; older ones are dropped */
+    FString QueuedPreviewPromptId;
+    TArray<uint8> QueuedPreviewFrame;
+    int32 QueuedPreviewOffset = 0;
 };
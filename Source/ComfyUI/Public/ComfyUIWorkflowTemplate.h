@@ -0,0 +1,116 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+
+// ============================================================================
+// FComfyTemplateSlot / FComfyTemplateValue
+// ============================================================================
+
+/** One patchable workflow input, addressed by node id and input key */
+struct FComfyTemplateSlot
+{
+    FString NodeId;
+    FString InputName;
+
+    FComfyTemplateSlot() = default;
+    FComfyTemplateSlot(const FString& InNodeId, const FString& InInputName)
+        : NodeId(InNodeId), InputName(InInputName) {}
+
+    bool operator==(const FComfyTemplateSlot& Other) const
+    {
+        return NodeId == Other.NodeId && InputName == Other.InputName;
+    }
+};
+
+/**
+ * Value spliced into a slot. Default-constructed values keep the input as it was
+ * in the workflow the template was compiled from. String values are views and
+ * must outlive the Render call.
+ */
+struct FComfyTemplateValue
+{
+    enum class EKind : uint8
+    {
+        Default,
+        String,
+        Number,
+        Bool
+    };
+
+    EKind Kind = EKind::Default;
+    FStringView String;
+    double Number = 0.0;
+    bool bBool = false;
+
+    FComfyTemplateValue() = default;
+    FComfyTemplateValue(const FString& InString) : Kind(EKind::String), String(InString) {}
+    FComfyTemplateValue(const TCHAR* InString) : Kind(EKind::String), String(InString) {}
+    FComfyTemplateValue(FStringView InString) : Kind(EKind::String), String(InString) {}
+    FComfyTemplateValue(double InNumber) : Kind(EKind::Number), Number(InNumber) {}
+    FComfyTemplateValue(int32 InNumber) : Kind(EKind::Number), Number(InNumber) {}
+    FComfyTemplateValue(bool bInBool) : Kind(EKind::Bool), bBool(bInBool) {}
+};
+
+// ============================================================================
+// FComfyWorkflowTemplate
+// ============================================================================
+
+/**
+ * A workflow graph serialized once, with the inputs that change between runs
+ * cut out as slots.
+ *
+ * Compile parses (or walks) the graph a single time and keeps the serialized
+ * JSON as literal segments between slots. Render then writes the segments and
+ * the escaped slot values into one preallocated buffer, so producing a request
+ * body costs O(bytes) and no JSON DOM.
+ *
+ * Immutable after Compile, so a compiled template may be shared across threads.
+ */
+class COMFYUI_API FComfyWorkflowTemplate
+{
+public:
+    /** Parses WorkflowJson and compiles it. Returns false if it isn't a JSON object. */
+    bool Compile(const FString& WorkflowJson, const TArray<FComfyTemplateSlot>& InSlots);
+
+    /**
+     * Compiles an already parsed graph. Slot inputs are swapped for markers while
+     * serializing and put back before returning, so Workflow is left unchanged.
+     * Slots whose node or input does not exist are dropped with a warning. Returns false,
+     * leaving the template invalid, if the graph can't be serialized or cut at its slots.
+     */
+    bool Compile(const TSharedRef<FJsonObject>& Workflow, const TArray<FComfyTemplateSlot>& InSlots);
+
+    bool IsValid() const { return Segments.Num() > 0; }
+
+    /** Index of the slot in the list given to Compile, INDEX_NONE if it was never declared or was dropped */
+    int32 FindSlot(const FString& NodeId, const FString& InputName) const;
+    int32 GetNumSlots() const { return Slots.Num(); }
+
+    /**
+     * Writes the graph (the "prompt" object). Values are indexed like the slot list
+     * given to Compile; missing trailing values and values for dropped slots are ignored.
+     */
+    FString Render(TConstArrayView<FComfyTemplateValue> Values) const;
+
+    /** Writes a complete /prompt request body: {"prompt": <graph>, "client_id": ClientId} */
+    FString RenderRequestBody(TConstArrayView<FComfyTemplateValue> Values, const FString& ClientId) const;
+
+    /** Appends Value to Out as JSON text. Strings are quoted and escaped. */
+    static void AppendJsonValue(FString& Out, const FComfyTemplateValue& Value);
+
+private:
+    void RenderInto(FString& Out, TConstArrayView<FComfyTemplateValue> Values) const;
+
+    TArray<FComfyTemplateSlot> Slots;
+
+    /** Serialized value of each slot in the source graph, used for Default values */
+    TArray<FString> DefaultValues;
+
+    /** Literal JSON text in output order; each segment but the last is followed by slot SegmentSlots[I] */
+    TArray<FString> Segments;
+    TArray<int32> SegmentSlots;
+
+    /** Sum of segment and default lengths, used to size the output buffer */
+    int32 BaseLength = 0;
+};
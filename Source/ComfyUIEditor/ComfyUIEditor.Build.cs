@@ -32,7 +32,8 @@ public class ComfyUIEditor : ModuleRules
                 "Engine",
                 "projects",
                 "RenderCore",
-                "HDRIBackdrop"
+                "HDRIBackdrop",
+                "DirectoryWatcher"
             }
         );
         if (Target.bBuildEditor)
@@ -1,5 +1,6 @@
 #include "ComfyUIEditorModule.h"
 #include "SComfyUIPanel.h"
+#include "ComfyUIWorkflowCache.h"
 #include "WorkspaceMenuStructure.h"
 #include "WorkspaceMenuStructureModule.h"
 #include "ToolMenus.h"
@@ -24,6 +25,8 @@ void FComfyUIEditorModule::StartupModule()
         );
     }
 
+    WorkflowCache = MakeShared<FComfyUIWorkflowCache>();
+
     // Register tab spawner
     FGlobalTabmanager::Get()->RegisterNomadTabSpawner(
         ComfyUITabName,
@@ -49,6 +52,8 @@ void FComfyUIEditorModule::ShutdownModule()
 
     UToolMenus::UnRegisterStartupCallback(this);
     UToolMenus::UnregisterOwner(this);
+
+    WorkflowCache.Reset();
 }
 
 void FComfyUIEditorModule::RegisterMenus()
@@ -0,0 +1,67 @@
+#include "ComfyUIPreviewTexturePool.h"
+#include "ComfyUIImageUtils.h"
+#include "Engine/Texture2D.h"
+
+namespace
+{
+    // Enough for two preview slots cycling through a batch without holding
+    // on to every size the user has ever generated
+    constexpr int32 MaxReleasedTextures = 8;
+}
+
+UTexture2D* FComfyUIPreviewTexturePool::Acquire(FComfyUIDecodedImage&& Image)
+{
+    check(IsInGameThread());
+
+    if (!Image.IsValid())
+    {
+        return nullptr;
+    }
+
+    const FPoolKey Key{ Image.Width, Image.Height, PF_B8G8R8A8 };
+
+    // Newest first: the texture released last is the one most likely still resident
+    for (int32 Index = Released.Num() - 1; Index >= 0; --Index)
+    {
+        UTexture2D* Candidate = Released[Index];
+        if (Candidate && MakeKey(Candidate) == Key)
+        {
+            Released.RemoveAt(Index);
+            UTexture2D* Texture = ComfyUIImage::UpdateOrCreateTransientTexture(Candidate, MoveTemp(Image));
+            Acquired.Add(Texture);
+            return Texture;
+        }
+    }
+
+    UTexture2D* Texture = ComfyUIImage::CreateTransientTexture(MoveTemp(Image));
+    if (Texture)
+    {
+        Acquired.Add(Texture);
+    }
+    return Texture;
+}
+
+void FComfyUIPreviewTexturePool::Release(UTexture2D* Texture)
+{
+    if (!Texture || Acquired.RemoveSingleSwap(Texture) == 0)
+    {
+        return;
+    }
+
+    Released.Add(Texture);
+    if (Released.Num() > MaxReleasedTextures)
+    {
+        Released.RemoveAt(0);
+    }
+}
+
+void FComfyUIPreviewTexturePool::AddReferencedObjects(FReferenceCollector& Collector)
+{
+    Collector.AddReferencedObjects(Acquired);
+    Collector.AddReferencedObjects(Released);
+}
+
+FComfyUIPreviewTexturePool::FPoolKey FComfyUIPreviewTexturePool::MakeKey(const UTexture2D* Texture)
+{
+    return FPoolKey{ Texture->GetSizeX(), Texture->GetSizeY(), Texture->GetPixelFormat() };
+}
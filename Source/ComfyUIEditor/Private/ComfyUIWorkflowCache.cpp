@@ -0,0 +1,142 @@
+#include "ComfyUIWorkflowCache.h"
+#include "DirectoryWatcherModule.h"
+#include "IDirectoryWatcher.h"
+#include "Interfaces/IPluginManager.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+FComfyUIWorkflowCache::FComfyUIWorkflowCache()
+{
+    if (const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("ComfyUI")))
+    {
+        PluginDir = Plugin->GetBaseDir();
+        WorkflowDir = FPaths::Combine(PluginDir, TEXT("workflows"));
+    }
+
+    if (WorkflowDir.IsEmpty() || !FPaths::DirectoryExists(WorkflowDir))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ComfyUI: Workflow directory not found, cached workflows will not reload on edit"));
+        return;
+    }
+
+    FDirectoryWatcherModule& WatcherModule = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+    if (IDirectoryWatcher* Watcher = WatcherModule.Get())
+    {
+        Watcher->RegisterDirectoryChangedCallback_Handle(WorkflowDir,
+            IDirectoryWatcher::FDirectoryChanged::CreateRaw(this, &FComfyUIWorkflowCache::OnDirectoryChanged),
+            WatcherHandle,
+            IDirectoryWatcher::WatchOptions::IncludeDirectoryChanges);
+    }
+}
+
+FComfyUIWorkflowCache::~FComfyUIWorkflowCache()
+{
+    if (!WatcherHandle.IsValid())
+        return;
+
+    if (FDirectoryWatcherModule* WatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")))
+    {
+        if (IDirectoryWatcher* Watcher = WatcherModule->Get())
+            Watcher->UnregisterDirectoryChangedCallback_Handle(WorkflowDir, WatcherHandle);
+    }
+}
+
+bool FComfyUIWorkflowCache::GetWorkflowCopy(const FString& RelativePath, TSharedPtr<FJsonObject>& OutWorkflow)
+{
+    const FEntry* Entry = FindOrLoad(RelativePath);
+    if (!Entry)
+        return false;
+
+    OutWorkflow = MakeShared<FJsonObject>();
+    FJsonObject::Duplicate(Entry->Workflow, OutWorkflow);
+    return true;
+}
+
+TSharedPtr<const FComfyWorkflowTemplate> FComfyUIWorkflowCache::GetTemplate(const FString& RelativePath, const TArray<FComfyTemplateSlot>& Slots)
+{
+    FEntry* Entry = FindOrLoad(RelativePath);
+    if (!Entry)
+        return nullptr;
+
+    for (const TPair<TArray<FComfyTemplateSlot>, TSharedPtr<const FComfyWorkflowTemplate>>& Compiled : Entry->Templates)
+    {
+        if (Compiled.Key == Slots)
+            return Compiled.Value;
+    }
+
+    // Compile marks the slot inputs in place while serializing, so give it its own copy
+    TSharedRef<FJsonObject> Scratch = MakeShared<FJsonObject>();
+    FJsonObject::Duplicate(Entry->Workflow, Scratch);
+
+    TSharedRef<FComfyWorkflowTemplate> Template = MakeShared<FComfyWorkflowTemplate>();
+    if (!Template->Compile(Scratch, Slots))
+        return nullptr;
+
+    Entry->Templates.Emplace(Slots, Template);
+    return Template;
+}
+
+void FComfyUIWorkflowCache::InvalidateAll()
+{
+    Entries.Reset();
+}
+
+FComfyUIWorkflowCache::FEntry* FComfyUIWorkflowCache::FindOrLoad(const FString& RelativePath)
+{
+    const FString FullPath = FPaths::Combine(PluginDir, RelativePath);
+    const FString Key = MakeKey(FullPath);
+    if (FEntry* Existing = Entries.Find(Key))
+        return Existing;
+
+    if (PluginDir.IsEmpty() || !FPaths::FileExists(FullPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("ComfyUI: Workflow not found at: %s"), *FullPath);
+        return nullptr;
+    }
+
+    FString WorkflowJson;
+    if (!FFileHelper::LoadFileToString(WorkflowJson, *FullPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("ComfyUI: Failed to read workflow: %s"), *FullPath);
+        return nullptr;
+    }
+
+    TSharedPtr<FJsonObject> Workflow;
+    const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(WorkflowJson);
+    if (!FJsonSerializer::Deserialize(Reader, Workflow) || !Workflow.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("ComfyUI: Failed to parse workflow: %s"), *FullPath);
+        return nullptr;
+    }
+
+    UE_LOG(LogTemp, Warning, TEXT("ComfyUI: Cached workflow %s"), *RelativePath);
+
+    FEntry& Entry = Entries.Add(Key);
+    Entry.Workflow = Workflow;
+    return &Entry;
+}
+
+FString FComfyUIWorkflowCache::MakeKey(const FString& Path) const
+{
+    FString Key = FPaths::ConvertRelativePathToFull(Path);
+    FPaths::NormalizeFilename(Key);
+    FPaths::CollapseRelativeDirectories(Key);
+    return Key;
+}
+
+void FComfyUIWorkflowCache::OnDirectoryChanged(const TArray<FFileChangeData>& Changes)
+{
+    for (const FFileChangeData& Change : Changes)
+    {
+        // Directory events (renames, moves) can affect any entry below them
+        if (FPaths::GetExtension(Change.Filename).IsEmpty())
+        {
+            InvalidateAll();
+            return;
+        }
+
+        if (Entries.Remove(MakeKey(Change.Filename)) > 0)
+            UE_LOG(LogTemp, Warning, TEXT("ComfyUI: Workflow changed on disk, reloading: %s"), *Change.Filename);
+    }
+}
@@ -1,11 +1,13 @@
 #include "SComfyUIPanel.h"
 #include "ComfyUIBlueprintLibrary.h"
+#include "ComfyUIClient.h"
+#include "ComfyUIImageUtils.h"
+#include "ComfyUIHDRUtils.h"
 #include "ComfyUIModule.h"
 #include "ComfyUISettings.h"
 #include "ComfyUIWebSocketHandler.h"
-#include "HttpModule.h"
-#include "Interfaces/IHttpRequest.h"
-#include "Interfaces/IHttpResponse.h"
+#include "ComfyUIEditorModule.h"
+#include "ComfyUIWorkflowCache.h"
 #include "Serialization/JsonSerializer.h"
 #include "Widgets/Layout/SScrollBox.h"
 #include "Widgets/Input/SEditableTextBox.h"
@@ -20,7 +22,6 @@
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "Misc/Paths.h"
 #include "Misc/FileHelper.h"
-#include "Interfaces/IPluginManager.h"
 #include "Kismet/GameplayStatics.h"
 #include "EngineUtils.h"
 #include "IDesktopPlatform.h"
@@ -30,9 +31,101 @@
 #include "IImageWrapper.h"
 #include "IImageWrapperModule.h"
 #include "Misc/PackageName.h"
+#include "Async/Async.h"
 
 #define LOCTEXT_NAMESPACE "SComfyUIPanel"
 
+/** Pixels for an HDRI cubemap's Source, prepared on a worker in FTextureSource layout */
+struct FComfyUIHDRTextureSource
+{
+    /** Every mip back to back; empty when the float equirect is used as is */
+    TArray64<uint8> Data;
+    TSharedPtr<const FComfyUIHDRImage, ESPMode::ThreadSafe> Equirect;
+
+    int32 SizeX = 0;
+    int32 SizeY = 0;
+    int32 NumSlices = 1;
+    int32 NumMips = 1;
+    ETextureSourceFormat Format = TSF_RGBA32F;
+    TextureMipGenSettings MipGenSettings = TMGS_NoMipmaps;
+
+    const uint8* GetData() const
+    {
+        if (Data.Num() > 0)
+            return Data.GetData();
+        return Equirect.IsValid() && Equirect->IsValid() ? reinterpret_cast<const uint8*>(Equirect->Pixels.GetData()) : nullptr;
+    }
+};
+
+namespace
+{
+    TSharedPtr<FComfyUIClient> GetComfyClient()
+    {
+        FComfyUIModule* Module = FModuleManager::GetModulePtr<FComfyUIModule>(TEXT("ComfyUI"));
+        return Module ? Module->GetClient() : nullptr;
+    }
+
+    /** Bakes cube faces or packs half floats from Image. Safe to call from any thread. */
+    FComfyUIHDRTextureSource BuildHDRTextureSource(const TSharedRef<FComfyUIHDRImage, ESPMode::ThreadSafe>& Image,
+        bool bHalfFloat, bool bBakeFaces, int32 RequestedFaceSize)
+    {
+        FComfyUIHDRTextureSource Source;
+        Source.Format = bHalfFloat ? TSF_RGBA16F : TSF_RGBA32F;
+        const int64 BytesPerPixel = bHalfFloat ? sizeof(FFloat16Color) : sizeof(FLinearColor);
+
+        if (bBakeFaces)
+        {
+            // Six faces with a full mip chain, so the texture build has nothing to resample
+            // and the skybox can stream mips
+            const int32 FaceSize = ComfyUIHDR::GetCubeFaceSize(*Image, RequestedFaceSize);
+            Source.SizeX = FaceSize;
+            Source.SizeY = FaceSize;
+            Source.NumSlices = 6;
+            Source.NumMips = ComfyUIHDR::GetCubeMipCount(FaceSize);
+            Source.MipGenSettings = TMGS_LeaveExistingMips;
+
+            TArray<int64, TInlineAllocator<16>> MipOffsets;
+            int64 TotalBytes = 0;
+            for (int32 Mip = 0; Mip < Source.NumMips; ++Mip)
+            {
+                const int64 MipSize = FMath::Max(FaceSize >> Mip, 1);
+                MipOffsets.Add(TotalBytes);
+                TotalBytes += MipSize * MipSize * 6 * BytesPerPixel;
+            }
+            Source.Data.SetNumUninitialized(TotalBytes);
+
+            TArray<uint8*, TInlineAllocator<16>> MipData;
+            for (const int64 Offset : MipOffsets)
+                MipData.Add(Source.Data.GetData() + Offset);
+
+            const double BakeStart = FPlatformTime::Seconds();
+            if (bHalfFloat)
+                ComfyUIHDR::BakeCubeFaces(*Image, FaceSize, MakeArrayView(reinterpret_cast<FFloat16Color* const*>(MipData.GetData()), Source.NumMips));
+            else
+                ComfyUIHDR::BakeCubeFaces(*Image, FaceSize, MakeArrayView(reinterpret_cast<FLinearColor* const*>(MipData.GetData()), Source.NumMips));
+
+            UE_LOG(LogTemp, Log, TEXT("ComfyUI HDR: Baked %d px cube faces with %d mips in %.1f ms"),
+                FaceSize, Source.NumMips, (FPlatformTime::Seconds() - BakeStart) * 1000.0);
+        }
+        else
+        {
+            // Equirectangular longlat source; the texture build converts it to a cubemap
+            Source.SizeX = Image->Width;
+            Source.SizeY = Image->Height;
+            if (bHalfFloat)
+            {
+                Source.Data.SetNumUninitialized((int64)Image->Width * Image->Height * BytesPerPixel);
+                ComfyUIHDR::ConvertToHalf(*Image, reinterpret_cast<FFloat16Color*>(Source.Data.GetData()));
+            }
+            else
+            {
+                Source.Equirect = Image;
+            }
+        }
+        return Source;
+    }
+}
+
 // ============================================================================
 // Construct
 // ============================================================================
@@ -83,6 +176,13 @@ void SComfyUIPanel::Construct(const FArguments& InArgs)
     WeakThis = SharedThis(this);         
     PollComfyConnection();
 
+    // Stream sampler previews and progress into the panel while a job runs
+    if (FComfyUIModule* Module = FModuleManager::GetModulePtr<FComfyUIModule>(TEXT("ComfyUI")))
+    {
+        if (TSharedPtr<FComfyUIWebSocketHandler> WSHandler = Module->GetWebSocketHandler())
+            SubscribeToSocket(WSHandler.ToSharedRef());
+    }
+
     ChildSlot
         [
             SNew(SVerticalBox)
@@ -234,6 +334,16 @@ TSharedRef<SWidget> SComfyUIPanel::BuildGenerateTab()
                                 .OnValueChanged(this, &SComfyUIPanel::OnCustomHeightChanged)
                                 .MinValue(64).MaxValue(8192).MinDesiredValueWidth(100)
                         ]
+                    + SHorizontalBox::Slot().AutoWidth().Padding(20, 0, 0, 0).VAlign(VAlign_Center)
+                        [SNew(STextBlock).Text(LOCTEXT("BatchLabel", "Batch: "))]
+                        + SHorizontalBox::Slot().Padding(10, 0, 0, 0).AutoWidth()
+                        [
+                            SNew(SNumericEntryBox<int32>)
+                                .Value_Lambda([this]() { return TOptional<int32>(BatchSize); })
+                                .OnValueChanged_Lambda([this](int32 V) { BatchSize = V; })
+                                .MinValue(1).MaxValue(8).MinDesiredValueWidth(50)
+                                .ToolTipText(LOCTEXT("BatchTooltip", "Images sampled together in one pass"))
+                        ]
                 ]
 
             // --- Generate / Browse ---
@@ -280,6 +390,10 @@ TSharedRef<SWidget> SComfyUIPanel::BuildGenerateTab()
                             })
                         [SAssignNew(PreviewImageA, SImage)]
                 ]
+            + SVerticalBox::Slot().AutoHeight().HAlign(HAlign_Center)
+                [
+                    BuildResultCycler(false)
+                ]
 
             // --- Preview A Actions ---
             + SVerticalBox::Slot().AutoHeight().Padding(0, 5, 0, 15)
@@ -354,6 +468,10 @@ TSharedRef<SWidget> SComfyUIPanel::BuildGenerateTab()
                             })
                         [SAssignNew(PreviewImageB, SImage)]
                 ]
+            + SVerticalBox::Slot().AutoHeight().HAlign(HAlign_Center)
+                [
+                    BuildResultCycler(true)
+                ]
 
             // --- Preview B Actions ---
             + SVerticalBox::Slot().AutoHeight().Padding(0, 5, 0, 15)
@@ -629,143 +747,133 @@ TSharedRef<SWidget> SComfyUIPanel::BuildSettingsTab()
 
 void SComfyUIPanel::SubmitWorkflow(const FComfyWorkflowParams& Params)
 {
-    TSharedPtr<FJsonObject> PromptObject;
-    const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Params.WorkflowJson);
-    if (!FJsonSerializer::Deserialize(Reader, PromptObject) || !PromptObject.IsValid())
+    // The builders already produce serialized graphs; wrap the text as-is rather
+    // than parsing it back into a DOM just to write it out again
+    if (!FStringView(Params.WorkflowJson).TrimStart().StartsWith(TEXT('{')))
     {
         UpdateStatus(TEXT("Error: Invalid workflow JSON"));
         return;
     }
 
-    TSharedPtr<FJsonObject> Wrapper = MakeShared<FJsonObject>();
-    Wrapper->SetObjectField(TEXT("prompt"), PromptObject);
-    Wrapper->SetStringField(TEXT("client_id"), TEXT("unrealplugin"));
-
     FString RequestBody;
-    const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&RequestBody);
-    FJsonSerializer::Serialize(Wrapper.ToSharedRef(), Writer);
-
-    const UComfyUISettings* Settings = GetDefault<UComfyUISettings>();
-    FString BaseUrl = Settings ? Settings->BaseUrl : TEXT("http://127.0.0.1:8188");
-
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-    Request->SetURL(BaseUrl + TEXT("/prompt"));
-    Request->SetVerb(TEXT("POST"));
-    Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
-    Request->SetContentAsString(RequestBody);
+    RequestBody.Reserve(Params.WorkflowJson.Len() + 64);
+    RequestBody += TEXT("{\"prompt\":");
+    RequestBody += Params.WorkflowJson;
+    RequestBody += TEXT(",\"client_id\":\"unrealplugin\"}");
+
+    FComfyUIModule* Module = FModuleManager::GetModulePtr<FComfyUIModule>(TEXT("ComfyUI"));
+    TSharedPtr<FComfyUIBackendPool> Pool = Module ? Module->GetBackendPool() : nullptr;
+    if (!Pool.IsValid())
+    {
+        UpdateStatus(TEXT("Error: ComfyUI module not loaded"));
+        return;
+    }
 
     FComfyWorkflowParams CapturedParams = Params;
     TWeakPtr<SComfyUIPanel> CapturedWeakThis = WeakThis;
 
-    Request->OnProcessRequestComplete().BindLambda(
-        [CapturedParams, CapturedWeakThis, BaseUrl](FHttpRequestPtr, FHttpResponsePtr Response, bool bSucceeded)
+    auto OnQueued = [CapturedParams, CapturedWeakThis](bool bSucceeded, const FString& PromptId, const FString&, const TSharedRef<FComfyUIBackend>& Backend)
         {
             TSharedPtr<SComfyUIPanel> Panel = CapturedWeakThis.Pin();
             if (!Panel.IsValid()) return;
 
-            if (!bSucceeded || !Response.IsValid() || !EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+            if (!bSucceeded)
             {
                 Panel->UpdateStatus(TEXT("Error: Failed to submit workflow"));
                 return;
             }
 
-            TSharedPtr<FJsonObject> JsonResponse;
-            const TSharedRef<TJsonReader<>> JsonReader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
-            if (!FJsonSerializer::Deserialize(JsonReader, JsonResponse) || !JsonResponse.IsValid())
+            if (PromptId.IsEmpty())
             {
                 Panel->UpdateStatus(TEXT("Error: Could not parse prompt_id"));
                 return;
             }
 
-            FString PromptId = JsonResponse->GetStringField(TEXT("prompt_id"));
-            Panel->CurrentPromptId = PromptId;
-            Panel->UpdateStatus(CapturedParams.RunningStatus);
+            UE_LOG(LogTemp, Warning, TEXT("ComfyUI: Submitted workflow to %s, prompt_id: %s"), *Backend->Client->GetBaseUrl(), *PromptId);
 
-            UE_LOG(LogTemp, Warning, TEXT("ComfyUI: Submitted workflow, prompt_id: %s"), *PromptId);
+            FComfyJob& Job = Panel->Jobs.Add(PromptId);
+            Job.PromptId = PromptId;
+            Job.Params = CapturedParams;
+            Job.Backend = Backend;
+            Panel->SetJobStatus(Job, CapturedParams.RunningStatus);
 
-            Panel->StartHistoryPoller(PromptId, CapturedParams);
+            // Progress and completion only arrive on the socket of the server running the prompt
+            const TSharedRef<FComfyUIWebSocketHandler>& WSHandler = Backend->WebSocket;
+            Panel->SubscribeToSocket(WSHandler);
 
-            if (FComfyUIModule* Module = FModuleManager::GetModulePtr<FComfyUIModule>(TEXT("ComfyUI")))
-            {
-                TSharedPtr<FComfyUIWebSocketHandler> WSHandler = Module->GetWebSocketHandler();
-                if (!WSHandler.IsValid()) return;
-
-                FString WsUrl = BaseUrl
-                    .Replace(TEXT("http://"), TEXT("ws://"))
-                    .Replace(TEXT("https://"), TEXT("wss://"))
-                    + TEXT("/ws?clientId=unrealplugin");
-
-                // Build the watch+register logic as a lambda so we can defer it
-                // until the socket is actually connected
-                auto RegisterWatcher = [CapturedWeakThis, CapturedParams, PromptId, WSHandler]()
-                    {
-                        TSharedPtr<SComfyUIPanel> InnerPanel = CapturedWeakThis.Pin();
-                        if (!InnerPanel.IsValid()) return;
-
-                        // Clear our own previous stale watcher if any
-                        if (!InnerPanel->CurrentPromptId.IsEmpty())
-                            WSHandler->UnwatchPrompt(InnerPanel->CurrentPromptId);
-
-                        FComfyUIWorkflowCompleteDelegateNative CompleteDelegate;
-                        CompleteDelegate.BindLambda(
-                            [CapturedWeakThis, CapturedParams, PromptId](bool bSuccess, const FString& InPromptId)
-                            {
-                                TSharedPtr<SComfyUIPanel> Panel = CapturedWeakThis.Pin();
-                                if (Panel.IsValid())
-                                    Panel->OnWorkflowComplete(bSuccess, PromptId, CapturedParams);
-                            });
-
-                        WSHandler->WatchPrompt(PromptId, CompleteDelegate);
-                    };
-
-                if (WSHandler->IsConnected())
-                {
-                    // Already connected — register immediately
-                    RegisterWatcher();
-                }
-                else
+            // Watchers can be registered before the socket is up; the handler checks
+            // /history for anything that finished in between once it connects
+            FComfyUIWorkflowCompleteDelegateNative CompleteDelegate;
+            CompleteDelegate.BindLambda(
+                [CapturedWeakThis](bool bSuccess, const FString& InPromptId)
                 {
-                    // Not connected yet — defer registration until handshake completes
-                    WSHandler->OnConnectedEvent.AddLambda([RegisterWatcher, WSHandler]()
-                        {
-                            RegisterWatcher();
-                            WSHandler->OnConnectedEvent.Clear();
-                        });
+                    TSharedPtr<SComfyUIPanel> Panel = CapturedWeakThis.Pin();
+                    if (Panel.IsValid())
+                        Panel->OnWorkflowComplete(bSuccess, InPromptId);
+                });
+            WSHandler->WatchPrompt(PromptId, CompleteDelegate);
 
-                    WSHandler->Connect(WsUrl);
-                }
-            }
-        });
+            if (!WSHandler->IsConnected())
+                WSHandler->Connect(Backend->Client->GetWebSocketUrl(TEXT("unrealplugin")));
+
+            // /history polling is only a fallback for when the socket can't report completion
+            if (!WSHandler->IsConnected())
+                Panel->StartHistoryPoller(PromptId);
+        };
 
-    Request->ProcessRequest();
+    // Uploaded inputs and earlier outputs live on the Base URL server, so those jobs can't move
+    if (Params.bUsesServerInputs)
+    {
+        const TSharedRef<FComfyUIBackend> Backend = Pool->GetDefaultBackend();
+        Backend->Client->PostPrompt(RequestBody,
+            [OnQueued, Backend](bool bSucceeded, const FString& PromptId, const FString& ResponseJson)
+            {
+                OnQueued(bSucceeded, PromptId, ResponseJson, Backend);
+            });
+    }
+    else
+    {
+        Pool->SubmitPrompt(RequestBody, OnQueued);
+    }
 }
 
-void SComfyUIPanel::OnWorkflowComplete(bool bSuccess, const FString& PromptId, FComfyWorkflowParams Params)
+void SComfyUIPanel::OnWorkflowComplete(bool bSuccess, const FString& PromptId)
 {
+    // The socket and the fallback poller can both report the same prompt
+    FComfyJob* Job = Jobs.Find(PromptId);
+    if (!Job || Job->State == EComfyJobState::Fetching)
+        return;
 
-    StopHistoryPoller();
+    StopHistoryPoller(PromptId);
 
     // Clean up the watcher whether WS fired or poller fired
-    if (FComfyUIModule* Module = FModuleManager::GetModulePtr<FComfyUIModule>(TEXT("ComfyUI")))
-    {
-        TSharedPtr<FComfyUIWebSocketHandler> WSHandler = Module->GetWebSocketHandler();
-        if (WSHandler.IsValid())
-            WSHandler->UnwatchPrompt(PromptId);
-    }
+    if (Job->Backend.IsValid())
+        Job->Backend->WebSocket->UnwatchPrompt(PromptId);
 
     UE_LOG(LogTemp, Warning, TEXT("ComfyUI: OnWorkflowComplete - Success: %d, PromptId: %s"),
         bSuccess, *PromptId);
 
+    const FComfyWorkflowParams Params = Job->Params;
+    const TSharedPtr<FComfyUIBackend> Backend = Job->Backend;
+
     if (!bSuccess)
     {
-        UpdateStatus(TEXT("Error: Workflow failed"));
+        // Drop the live preview and show the last real result again
+        if (LivePreviewPromptId == PromptId)
+        {
+            TSharedPtr<SImage>& Preview = Params.bTargetPreviewB ? PreviewImageB : PreviewImageA;
+            const TSharedPtr<FSlateBrush>& Brush = Params.bTargetPreviewB ? ImageBrushB : ImageBrushA;
+            if (Preview.IsValid())
+                Preview->SetImage(Brush.IsValid() ? Brush.Get() : nullptr);
+            LivePreviewPromptId.Reset();
+        }
+
+        FinishJob(PromptId, TEXT("Error: Workflow failed"));
         return;
     }
 
-    UpdateStatus(TEXT("Fetching result..."));
-
-    const UComfyUISettings* Settings = GetDefault<UComfyUISettings>();
-    FString BaseUrl = Settings ? Settings->BaseUrl : TEXT("http://127.0.0.1:8188");
+    Job->State = EComfyJobState::Fetching;
+    SetJobStatus(*Job, TEXT("Fetching result..."));
 
     TWeakPtr<SComfyUIPanel> CapturedWeakThis = WeakThis;
 
@@ -774,121 +882,128 @@ void SComfyUIPanel::OnWorkflowComplete(bool bSuccess, const FString& PromptId, F
         FTimerHandle DelayTimer;
         GEditor->GetTimerManager()->SetTimer(
             DelayTimer,
-            [CapturedWeakThis, Params, BaseUrl, PromptId]()
+            [CapturedWeakThis, Params, PromptId, Backend]()
             {
                 TSharedPtr<SComfyUIPanel> Panel = CapturedWeakThis.Pin();
-                if (!Panel.IsValid()) return;
+                if (!Panel.IsValid() || !Backend.IsValid()) return;
 
-                // Step 1: fetch /history to get the output filename
-                TSharedRef<IHttpRequest, ESPMode::ThreadSafe> HistoryRequest = FHttpModule::Get().CreateRequest();
-                HistoryRequest->SetURL(BaseUrl + TEXT("/history/") + PromptId);
-                HistoryRequest->SetVerb(TEXT("GET"));
-                HistoryRequest->OnProcessRequestComplete().BindLambda(
-                    [CapturedWeakThis, Params, BaseUrl, PromptId](FHttpRequestPtr, FHttpResponsePtr Response, bool bSucceeded)
+                // Step 1: fetch /history to get the output filenames, from the server that ran it
+                TSharedRef<FComfyUIClient> Client = Backend->Client;
+                Client->GetOutputs(PromptId,
+                    [CapturedWeakThis, Params, PromptId, Client](bool bSucceeded, const TArray<FComfyUIOutputImage>& AllImages)
                     {
                         TSharedPtr<SComfyUIPanel> Panel = CapturedWeakThis.Pin();
                         if (!Panel.IsValid()) return;
 
-                        if (!bSucceeded || !Response.IsValid())
+                        if (!bSucceeded)
                         {
-                            Panel->UpdateStatus(TEXT("Error: Could not fetch history"));
+                            Panel->FinishJob(PromptId, TEXT("Error: Could not fetch history"));
                             return;
                         }
 
-                        TSharedPtr<FJsonObject> History;
-                        const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
-                        if (!FJsonSerializer::Deserialize(Reader, History) || !History.IsValid())
+                        // Every saved image; a batched latent yields several from one SaveImage node
+                        TArray<FComfyUIOutputImage> OutputImages;
+                        for (const FComfyUIOutputImage& Image : AllImages)
                         {
-                            Panel->UpdateStatus(TEXT("Error: Could not parse history"));
-                            return;
+                            if (Image.Type == TEXT("output"))
+                                OutputImages.Add(Image);
                         }
 
-                        // Find first non-temp image in outputs
-                        FString OutputFilename;
-                        const TSharedPtr<FJsonObject>* PromptHistory;
-                        if (History->TryGetObjectField(PromptId, PromptHistory))
+                        if (OutputImages.Num() == 0)
                         {
-                            const TSharedPtr<FJsonObject>* Outputs;
-                            if ((*PromptHistory)->TryGetObjectField(TEXT("outputs"), Outputs))
-                            {
-                                for (auto& NodePair : (*Outputs)->Values)
-                                {
-                                    const TSharedPtr<FJsonObject>* NodeOutput;
-                                    if (NodePair.Value->TryGetObject(NodeOutput))
-                                    {
-                                        const TArray<TSharedPtr<FJsonValue>>* Images;
-                                        if ((*NodeOutput)->TryGetArrayField(TEXT("images"), Images) && Images->Num() > 0)
-                                        {
-                                            FString Filename = (*Images)[0]->AsObject()->GetStringField(TEXT("filename"));
-                                            if (!Filename.Contains(TEXT("_temp_")))
-                                            {
-                                                OutputFilename = Filename;
-                                                break;
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-
-                        if (OutputFilename.IsEmpty())
-                        {
-                            Panel->UpdateStatus(TEXT("Error: No output image found in history"));
+                            Panel->FinishJob(PromptId, TEXT("Error: No output image found in history"));
                             return;
                         }
 
-                        UE_LOG(LogTemp, Warning, TEXT("ComfyUI: Output filename: %s"), *OutputFilename);
+                        UE_LOG(LogTemp, Warning, TEXT("ComfyUI: %d output image(s), first: %s"),
+                            OutputImages.Num(), *OutputImages[0].Filename);
 
-                        // Step 2: download the image via /view
-                        Panel->UpdateStatus(TEXT("Downloading result..."));
-                        Panel->DownloadImageFromComfyUI(OutputFilename,
-                            [CapturedWeakThis, Params](bool bDownloadSuccess, const FString& LocalPath)
+                        // Step 2: download all images via /view
+                        if (FComfyJob* Job = Panel->Jobs.Find(PromptId))
+                            Panel->SetJobStatus(*Job, OutputImages.Num() > 1
+                                ? FString::Printf(TEXT("Downloading %d results..."), OutputImages.Num())
+                                : FString(TEXT("Downloading result...")));
+
+                        Panel->DownloadOutputImages(Client, OutputImages, Params.bStreamDownload,
+                            [CapturedWeakThis, PromptId](int64 BytesReceived, int64 TotalBytes)
+                            {
+                                TSharedPtr<SComfyUIPanel> Panel = CapturedWeakThis.Pin();
+                                FComfyJob* Job = Panel.IsValid() ? Panel->Jobs.Find(PromptId) : nullptr;
+                                if (!Job)
+                                    return;
+
+                                // Skip SetJobStatus: it logs, and progress arrives per received chunk
+                                const double Mb = 1024.0 * 1024.0;
+                                Job->Status = TotalBytes > 0
+                                    ? FString::Printf(TEXT("Downloading result... %.1f / %.1f MB"), BytesReceived / Mb, TotalBytes / Mb)
+                                    : FString::Printf(TEXT("Downloading result... %.1f MB"), BytesReceived / Mb);
+                                Panel->RefreshStatusFromJobs();
+                            },
+                            [CapturedWeakThis, Params, PromptId](const TArray<FString>& LocalPaths, TArray<FComfyUIDecodedImage>& Images)
                             {
                                 TSharedPtr<SComfyUIPanel> Panel = CapturedWeakThis.Pin();
                                 if (!Panel.IsValid()) return;
 
-                                if (!bDownloadSuccess || LocalPath.IsEmpty())
+                                if (LocalPaths.Num() == 0)
                                 {
-                                    Panel->UpdateStatus(TEXT("Error: Failed to download result image"));
+                                    Panel->FinishJob(PromptId, TEXT("Error: Failed to download result image"));
                                     return;
                                 }
 
-                                UE_LOG(LogTemp, Warning, TEXT("ComfyUI: Downloaded to: %s"), *LocalPath);
-
                                 if (Params.bUpdatePreview)
                                 {
-                                    if (Params.bTargetPreviewB)
-                                        Panel->PreviewImagePathB = LocalPath;
+                                    // Streamed downloads arrive undecoded; decode them from disk
+                                    if (Images.Num() == LocalPaths.Num())
+                                        Panel->SetPreviewResults(Params.bTargetPreviewB, LocalPaths, MoveTemp(Images));
                                     else
-                                        Panel->PreviewImagePathA = LocalPath;
-
-                                    Panel->LoadAndDisplayImage(LocalPath, Params.bTargetPreviewB);
+                                        Panel->LoadAndDisplayImages(LocalPaths, Params.bTargetPreviewB);
+                                    if (Panel->LivePreviewPromptId == PromptId)
+                                        Panel->LivePreviewPromptId.Reset();
                                 }
 
                                 if (Params.bConvertToHDRI)
                                 {
-                                    // Convert downloaded panorama to .hdr
-                                    FString HdrPath = Panel->ConvertImageToHDR(LocalPath);
-                                    if (!HdrPath.IsEmpty())
-                                    {
-                                        // Import as HDR texture
-                                        UTextureCube* HdrTexture = Panel->ImportHDRToProject(
-                                            HdrPath, Params.OutputPrefix);
-                                        if (HdrTexture)
+                                    Panel->WhenFileWritten(LocalPaths[0],
+                                        [CapturedWeakThis, Params, Path = LocalPaths[0]](bool bWritten)
                                         {
-                                            Panel->ApplyTextureToHDRIBackdrop(HdrTexture);
-                                        }
-                                    }
+                                            TSharedPtr<SComfyUIPanel> Panel = CapturedWeakThis.Pin();
+                                            if (!Panel.IsValid() || !bWritten) return;
+
+                                            // Convert downloaded panorama to float HDR and import it as a cubemap
+                                            Panel->ConvertAndImportHDRAsync(Path, Params.OutputPrefix);
+                                        });
                                 }
-                                else if (Params.bAutoImport)
+                                else if (Params.bAutoImport && LocalPaths.Num() > 0)
                                 {
-                                    Panel->ImportImageToProject(LocalPath, Params.OutputPrefix);
+                                    // Wait for every write, then import the whole set in one batch
+                                    struct FPendingImport
+                                    {
+                                        TArray<FString> WrittenPaths;
+                                        int32 Remaining = 0;
+                                    };
+                                    TSharedRef<FPendingImport> Pending = MakeShared<FPendingImport>();
+                                    Pending->Remaining = LocalPaths.Num();
+
+                                    for (const FString& LocalPath : LocalPaths)
+                                    {
+                                        Panel->WhenFileWritten(LocalPath,
+                                            [CapturedWeakThis, LocalPath, Pending, Prefix = Params.OutputPrefix](bool bWritten)
+                                            {
+                                                if (bWritten)
+                                                    Pending->WrittenPaths.Add(LocalPath);
+                                                if (--Pending->Remaining > 0)
+                                                    return;
+
+                                                TSharedPtr<SComfyUIPanel> Panel = CapturedWeakThis.Pin();
+                                                if (Panel.IsValid() && Pending->WrittenPaths.Num() > 0)
+                                                    Panel->ImportImagesToProject(Pending->WrittenPaths, Prefix);
+                                            });
+                                    }
                                 }
 
-                                Panel->UpdateStatus(Params.CompleteStatus);
+                                Panel->FinishJob(PromptId, Params.CompleteStatus);
                             });
                     });
-                HistoryRequest->ProcessRequest();
             },
             0.5f,
             false
@@ -919,6 +1034,7 @@ void SComfyUIPanel::StartGeneration()
         QwenParams.PositivePrompt = PromptText;
         QwenParams.Width = Width;
         QwenParams.Height = Height;
+        QwenParams.BatchSize = BatchSize;
         QwenParams.FilenamePrefix = CurrentFilenamePrefix;
         QwenParams.Seed = FMath::Abs((int32)(FDateTime::Now().GetTicks() % MAX_int32));
         QwenParams.Steps = QwenSettings.Steps;
@@ -935,6 +1051,7 @@ void SComfyUIPanel::StartGeneration()
         FluxParams.NegativePrompt = NegativePromptText;
         FluxParams.Width = Width;
         FluxParams.Height = Height;
+        FluxParams.BatchSize = BatchSize;
         FluxParams.FilenamePrefix = CurrentFilenamePrefix;
         FluxParams.Seed = FMath::Abs((int32)(FDateTime::Now().GetTicks() % MAX_int32));
         FluxParams.Steps = FluxSettings.Steps;
@@ -956,14 +1073,11 @@ void SComfyUIPanel::StartImg2Img()
     WorkflowParams.bUpdatePreview = true;
     WorkflowParams.bAutoImport = false;
     WorkflowParams.bTargetPreviewB = true;
+    WorkflowParams.bUsesServerInputs = true;
 
     if (SelectedModelFamily == EComfyUIModelFamily::Qwen)
     {
-        FString Filename = FPaths::GetCleanFilename(PreviewImagePathA);
-        bool bIsDownloadedOutput = PreviewImagePathA.StartsWith(GetLocalTempFolder());
-        FString NodeImageValue = bIsDownloadedOutput
-            ? Filename + TEXT(" [output]")
-            : Filename;
+        const FString NodeImageValue = GetNodeImageValue(PreviewImagePathA);
 
         FComfyUIQwenEditParams QwenParams;
         QwenParams.Instruction = Img2ImgPromptText;
@@ -980,32 +1094,27 @@ void SComfyUIPanel::StartImg2Img()
     }
     else
     {
-        TSharedPtr<FJsonObject> WorkflowObj;
-        if (!LoadWorkflowFromFile(TEXT("workflows/img2img-API.json"), WorkflowObj))
+        enum { Slot_Image, Slot_Prompt, Slot_Seed };
+        static const TArray<FComfyTemplateSlot> Slots = {
+            { TEXT("32"), TEXT("image") },
+            { TEXT("2"), TEXT("text") },
+            { TEXT("16"), TEXT("seed") }
+        };
+
+        TSharedPtr<const FComfyWorkflowTemplate> Template = GetWorkflowTemplate(TEXT("workflows/img2img-API.json"), Slots);
+        if (!Template.IsValid())
         {
             UpdateStatus(TEXT("Error: img2img workflow file not found"));
             return;
         }
 
-        FString Filename = FPaths::GetCleanFilename(PreviewImagePathA);
-        bool bIsDownloadedOutput = PreviewImagePathA.StartsWith(GetLocalTempFolder());
-        FString NodeImageValue = bIsDownloadedOutput
-            ? Filename + TEXT(" [output]")
-            : Filename;
+        const FString NodeImageValue = GetNodeImageValue(PreviewImagePathA);
 
-        if (TSharedPtr<FJsonObject> ImageNode = WorkflowObj->GetObjectField(TEXT("32")))
-            ImageNode->GetObjectField(TEXT("inputs"))->SetStringField(TEXT("image"), NodeImageValue);
-
-        if (TSharedPtr<FJsonObject> PromptNode = WorkflowObj->GetObjectField(TEXT("2")))
-            PromptNode->GetObjectField(TEXT("inputs"))->SetStringField(TEXT("text"), Img2ImgPromptText);
-
-        if (TSharedPtr<FJsonObject> SeedNode = WorkflowObj->GetObjectField(TEXT("16")))
-        {
-            int32 NewSeed = FMath::Abs((int32)(FDateTime::Now().GetTicks() % MAX_int32));
-            SeedNode->GetObjectField(TEXT("inputs"))->SetNumberField(TEXT("seed"), NewSeed);
-        }
-
-        WorkflowParams.WorkflowJson = SerializeWorkflow(WorkflowObj);
+        FComfyTemplateValue Values[3];
+        Values[Slot_Image] = NodeImageValue;
+        Values[Slot_Prompt] = Img2ImgPromptText;
+        Values[Slot_Seed] = FMath::Abs((int32)(FDateTime::Now().GetTicks() % MAX_int32));
+        WorkflowParams.WorkflowJson = Template->Render(Values);
     }
 
     SubmitWorkflow(WorkflowParams);
@@ -1013,38 +1122,36 @@ void SComfyUIPanel::StartImg2Img()
 
 void SComfyUIPanel::Start360Generation(const FString& SourcePath)
 {
-    TSharedPtr<FJsonObject> WorkflowObj;
-    if (!LoadWorkflowFromFile(TEXT("workflows/qwen_image_edit_2511_360_API.json"), WorkflowObj))
+    enum { Slot_Image, Slot_Seed };
+    static const TArray<FComfyTemplateSlot> Slots = {
+        { TEXT("41"), TEXT("image") },
+        { TEXT("183"), TEXT("seed") }
+    };
+
+    TSharedPtr<const FComfyWorkflowTemplate> Template = GetWorkflowTemplate(TEXT("workflows/qwen_image_edit_2511_360_API.json"), Slots);
+    if (!Template.IsValid())
     {
         UpdateStatus(TEXT("Error: 360 workflow file not found"));
         return;
     }
 
-    FString Filename = FPaths::GetCleanFilename(SourcePath);
-    bool bIsDownloadedOutput = SourcePath.StartsWith(GetLocalTempFolder());
-    FString NodeImageValue = bIsDownloadedOutput
-        ? Filename + TEXT(" [output]")
-        : Filename;
+    const FString NodeImageValue = GetNodeImageValue(SourcePath);
 
-    // Patch source image
-    if (TSharedPtr<FJsonObject> Node41 = WorkflowObj->GetObjectField(TEXT("41")))
-        Node41->GetObjectField(TEXT("inputs"))->SetStringField(TEXT("image"), NodeImageValue);
-
-    // Patch seed
-    if (TSharedPtr<FJsonObject> Node183 = WorkflowObj->GetObjectField(TEXT("183")))
-    {
-        int32 NewSeed = FMath::Abs((int32)(FDateTime::Now().GetTicks() % MAX_int32));
-        Node183->GetObjectField(TEXT("inputs"))->SetNumberField(TEXT("seed"), NewSeed);
-    }
+    // Patch source image and seed
+    FComfyTemplateValue Values[2];
+    Values[Slot_Image] = NodeImageValue;
+    Values[Slot_Seed] = FMath::Abs((int32)(FDateTime::Now().GetTicks() % MAX_int32));
 
     FComfyWorkflowParams WorkflowParams;
-    WorkflowParams.WorkflowJson = SerializeWorkflow(WorkflowObj);
+    WorkflowParams.WorkflowJson = Template->Render(Values);
     WorkflowParams.OutputPrefix = TEXT("360_Qwen");
     WorkflowParams.RunningStatus = TEXT("Generating 360\u00b0 panorama...");
     WorkflowParams.CompleteStatus = TEXT("360\u00b0 HDRI generated and imported to project!");
     WorkflowParams.bUpdatePreview = false;
     WorkflowParams.bAutoImport = false;
     WorkflowParams.bConvertToHDRI = true;
+    WorkflowParams.bStreamDownload = true;
+    WorkflowParams.bUsesServerInputs = true;
 
     SubmitWorkflow(WorkflowParams);
 }
@@ -1106,6 +1213,27 @@ FReply SComfyUIPanel::OnImg2ImgClicked()
         UpdateStatus(TEXT("Error: No input image. Generate or browse an image first."));
         return FReply::Handled();
     }
+
+    // A result from another backend isn't on the Base URL server yet
+    if (!IsDefaultServerOutput(PreviewImagePathA) && !UploadedNames.Contains(PreviewImagePathA))
+    {
+        UpdateStatus(TEXT("Uploading image to ComfyUI..."));
+        UploadImageToComfyUI(PreviewImagePathA,
+            [this](bool bSuccess, const FString& Filename)
+            {
+                if (bSuccess)
+                {
+                    UpdateStatus(TEXT("Submitting img2img workflow..."));
+                    StartImg2Img();
+                }
+                else
+                {
+                    UpdateStatus(TEXT("Error: Failed to upload image"));
+                }
+            });
+        return FReply::Handled();
+    }
+
     UpdateStatus(TEXT("Submitting img2img workflow..."));
     StartImg2Img();
     return FReply::Handled();
@@ -1119,9 +1247,8 @@ FReply SComfyUIPanel::OnGenerate360Clicked(FString SourcePath)
         return FReply::Handled();
     }
 
-    // If source is a browsed (non-downloaded) image, upload it first
-    bool bIsDownloadedOutput = SourcePath.StartsWith(GetLocalTempFolder());
-    if (!bIsDownloadedOutput)
+    // If source is a browsed image or another server's result, upload it first
+    if (!IsDefaultServerOutput(SourcePath))
     {
         UpdateStatus(TEXT("Uploading image to ComfyUI..."));
         UploadImageToComfyUI(SourcePath,
@@ -1152,7 +1279,13 @@ FReply SComfyUIPanel::OnImportClicked(FString SourcePath)
         UpdateStatus(TEXT("Error: No preview image to import"));
         return FReply::Handled();
     }
-    ImportImageToProject(SourcePath, TEXT("T_Generated"));
+    WhenFileWritten(SourcePath, [this, SourcePath](bool bWritten)
+    {
+        if (bWritten)
+            ImportImageToProject(SourcePath, TEXT("T_Generated"));
+        else
+            UpdateStatus(TEXT("Error: Preview image was not saved to disk"));
+    });
     return FReply::Handled();
 }
 
@@ -1164,6 +1297,17 @@ FReply SComfyUIPanel::OnApplyToComposureClicked(FString SourcePath)
         return FReply::Handled();
     }
 
+    // Freshly downloaded results may still be on their way to disk
+    if (PendingWrites.Contains(SourcePath))
+    {
+        WhenFileWritten(SourcePath, [this, SourcePath](bool bWritten)
+        {
+            if (bWritten)
+                OnApplyToComposureClicked(SourcePath);
+        });
+        return FReply::Handled();
+    }
+
     UTexture2D* TextureToApply = nullptr;
     if (LastImportedImagePath == SourcePath && LastImportedTexture.IsValid())
     {
@@ -1213,124 +1357,167 @@ void SComfyUIPanel::ImportImageToProject(const FString& ImagePath, const FString
     }
 }
 
+void SComfyUIPanel::ImportImagesToProject(const TArray<FString>& ImagePaths, const FString& AssetNamePrefix)
+{
+    // No package exists until the batch completes, so GenerateUniqueAssetName can't tell
+    // these apart; index them instead
+    const FString Timestamp = FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S"));
+    TArray<FString> AssetPaths;
+    for (int32 Index = 0; Index < ImagePaths.Num(); ++Index)
+    {
+        const FString TextureName = ImagePaths.Num() == 1
+            ? FString::Printf(TEXT("%s_%s"), *AssetNamePrefix, *Timestamp)
+            : FString::Printf(TEXT("%s_%s_%02d"), *AssetNamePrefix, *Timestamp, Index);
+        AssetPaths.Add(UComfyUIBlueprintLibrary::GenerateUniqueAssetName(TEXT("/Game/GeneratedTextures"), TextureName));
+    }
+
+    UpdateStatus(FString::Printf(TEXT("Importing %d image(s)..."), ImagePaths.Num()));
+
+    TWeakPtr<SComfyUIPanel> WeakThis = SharedThis(this);
+    UComfyUIBlueprintLibrary::ImportImagesAsAssets(ImagePaths, AssetPaths,
+        [WeakThis, AssetPaths](const TArray<UTexture2D*>& Textures)
+        {
+            TSharedPtr<SComfyUIPanel> Panel = WeakThis.Pin();
+            if (!Panel.IsValid())
+                return;
+
+            int32 NumImported = 0;
+            for (int32 Index = 0; Index < Textures.Num(); ++Index)
+            {
+                if (Textures[Index])
+                {
+                    ++NumImported;
+                    UE_LOG(LogTemp, Warning, TEXT("ComfyUI: Imported texture to %s"), *AssetPaths[Index]);
+                }
+            }
+
+            if (NumImported == Textures.Num())
+                Panel->UpdateStatus(NumImported == 1
+                    ? FString::Printf(TEXT("Imported: %s"), *AssetPaths[0])
+                    : FString::Printf(TEXT("Imported %d textures to /Game/GeneratedTextures"), NumImported));
+            else
+                Panel->UpdateStatus(FString::Printf(TEXT("Error: Imported %d of %d textures"), NumImported, Textures.Num()));
+        });
+}
+
 // ============================================================================
 // HDR Conversion
 // ============================================================================
 
-FString SComfyUIPanel::ConvertImageToHDR(const FString& SourceImagePath)
+void SComfyUIPanel::ConvertAndImportHDRAsync(const FString& SourceImagePath, const FString& AssetName)
 {
-    // Load image bytes
-    TArray<uint8> RawFileData;
-    if (!FFileHelper::LoadFileToArray(RawFileData, *SourceImagePath))
-    {
-        UE_LOG(LogTemp, Error, TEXT("ComfyUI HDR: Failed to read source: %s"), *SourceImagePath);
-        return FString();
-    }
+    // Settings are read here; the worker only touches pixels
+    const UComfyUISettings* Settings = GetDefault<UComfyUISettings>();
+    const FComfyUIHDRParams HDRParams = Settings->GetHDRParams();
+    const FString OperatorName = UEnum::GetValueAsString(Settings->HDROperator);
+    const bool bHalfFloat = Settings->bHDRIHalfFloatSource;
+    const bool bBakeFaces = Settings->bBakeHDRICubeFaces;
+    const int32 FaceSize = Settings->HDRICubeFaceSize;
+    const bool bWriteExr = Settings->bWriteHDRIExr;
+
+    ComfyUIImage::PreloadImageWrapperModule();
+    TWeakPtr<SComfyUIPanel> CapturedWeakThis = WeakThis;
 
-    // Decode via ImageWrapper
-    IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+    // Reading and decoding an 8K panorama, the expansion and the bake all stay off the
+    // game thread; it only creates the asset and copies the prepared mips into it
+    Async(EAsyncExecution::ThreadPool,
+        [CapturedWeakThis, SourceImagePath, AssetName, HDRParams, OperatorName, bHalfFloat, bBakeFaces, FaceSize, bWriteExr]()
+        {
+            TArray64<uint8> RawFileData;
+            if (!FFileHelper::LoadFileToArray(RawFileData, *SourceImagePath))
+            {
+                UE_LOG(LogTemp, Error, TEXT("ComfyUI HDR: Failed to read source: %s"), *SourceImagePath);
+                return;
+            }
 
-    EImageFormat DetectedFormat = EImageFormat::PNG;
-    if (SourceImagePath.EndsWith(TEXT(".jpg")) || SourceImagePath.EndsWith(TEXT(".jpeg")))
-        DetectedFormat = EImageFormat::JPEG;
+            FComfyUIDecodedImage Decoded;
+            if (!ComfyUIImage::DecodeToBGRA(RawFileData.GetData(), RawFileData.Num(), Decoded))
+            {
+                UE_LOG(LogTemp, Error, TEXT("ComfyUI HDR: Failed to decode image"));
+                return;
+            }
+            RawFileData.Empty();
 
-    TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(DetectedFormat);
-    if (!ImageWrapper.IsValid() || !ImageWrapper->SetCompressed(RawFileData.GetData(), RawFileData.Num()))
-    {
-        UE_LOG(LogTemp, Error, TEXT("ComfyUI HDR: Failed to decode image"));
-        return FString();
-    }
+            TSharedRef<FComfyUIHDRImage, ESPMode::ThreadSafe> HDRImage = MakeShared<FComfyUIHDRImage, ESPMode::ThreadSafe>();
+            const double ConvertStart = FPlatformTime::Seconds();
+            ComfyUIHDR::ConvertLDRToHDR(Decoded, *HDRImage, HDRParams);
+            UE_LOG(LogTemp, Log, TEXT("ComfyUI HDR: Converted %dx%d with %s in %.1f ms"),
+                HDRImage->Width, HDRImage->Height, *OperatorName, (FPlatformTime::Seconds() - ConvertStart) * 1000.0);
+            Decoded = FComfyUIDecodedImage();
 
-    TArray<uint8> RawRGBA;
-    if (!ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, RawRGBA))
-    {
-        UE_LOG(LogTemp, Error, TEXT("ComfyUI HDR: Failed to get raw pixel data"));
-        return FString();
-    }
+            TSharedRef<FComfyUIHDRTextureSource, ESPMode::ThreadSafe> TextureSource =
+                MakeShared<FComfyUIHDRTextureSource, ESPMode::ThreadSafe>(BuildHDRTextureSource(HDRImage, bHalfFloat, bBakeFaces, FaceSize));
 
-    const int32 Width = ImageWrapper->GetWidth();
-    const int32 Height = ImageWrapper->GetHeight();
-    const int32 NumPixels = Width * Height;
+            AsyncTask(ENamedThreads::GameThread,
+                [CapturedWeakThis, SourceImagePath, AssetName, bWriteExr, HDRImage, TextureSource]()
+                {
+                    TSharedPtr<SComfyUIPanel> Panel = CapturedWeakThis.Pin();
+                    if (!Panel.IsValid())
+                        return;
 
-    // Convert to float HDR with highlight boost
-    // - Gamma decode (2.2) to linearize
-    // - Boost highlights based on luminance to simulate HDR headroom
-    TArray<FLinearColor> HDRPixels;
-    HDRPixels.SetNum(NumPixels);
+                    if (bWriteExr)
+                        Panel->WriteHDRExrAsync(HDRImage, SourceImagePath);
 
-    for (int32 i = 0; i < NumPixels; i++)
-    {
-        // BGRA byte order
-        const int32 Idx = i * 4;
-        float B = RawRGBA[Idx + 0] / 255.0f;
-        float G = RawRGBA[Idx + 1] / 255.0f;
-        float R = RawRGBA[Idx + 2] / 255.0f;
-
-        // Gamma decode to linear
-        R = FMath::Pow(R, 2.2f);
-        G = FMath::Pow(G, 2.2f);
-        B = FMath::Pow(B, 2.2f);
-
-        // Luminance-based highlight boost
-        // Bright areas (sky, light sources) get pushed significantly higher
-        // to give the HDRI Backdrop meaningful light intensity variation
-        float Luminance = 0.2126f * R + 0.7152f * G + 0.0722f * B;
-        float Boost = 1.0f + FMath::Pow(FMath::Clamp(Luminance, 0.0f, 1.0f), 2.0f) * 8.0f;
-
-        HDRPixels[i] = FLinearColor(R * Boost, G * Boost, B * Boost, 1.0f);
-    }
+                    UTextureCube* HdrTexture = Panel->ImportHDRToProject(*TextureSource, AssetName);
+                    if (HdrTexture)
+                    {
+                        Panel->ApplyTextureToHDRIBackdrop(HdrTexture);
+                    }
+                });
+        });
+}
 
-    
-    // Write as 32-bit float EXR — UE imports this perfectly as HDR, no dialog
+void SComfyUIPanel::WriteHDRExrAsync(const TSharedRef<FComfyUIHDRImage, ESPMode::ThreadSafe>& Image, const FString& SourceImagePath)
+{
+    // Write as 32-bit float EXR next to the source, for use outside the project
     FString Timestamp = FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S"));
     FString HdrPath = FPaths::Combine(
         FPaths::GetPath(SourceImagePath),
         FPaths::GetBaseFilename(SourceImagePath) + TEXT("_") + Timestamp + TEXT(".exr")
     );
 
-    TSharedPtr<IImageWrapper> ExrWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::EXR);
-    if (!ExrWrapper.IsValid())
+    // Encoding an 8K float EXR takes seconds; the import doesn't wait for it
+    FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+    Async(EAsyncExecution::ThreadPool, [Image, HdrPath]()
     {
-        UE_LOG(LogTemp, Error, TEXT("ComfyUI HDR: Failed to create EXR wrapper"));
-        return FString();
-    }
-
-    // Pack HDRPixels into raw RGBA float array
-    TArray<uint8> FloatData;
-    FloatData.SetNumUninitialized(NumPixels * 4 * sizeof(float));
-    float* FloatPtr = reinterpret_cast<float*>(FloatData.GetData());
-
-    for (int32 i = 0; i < NumPixels; i++)
-    {
-        FloatPtr[i * 4 + 0] = HDRPixels[i].R;
-        FloatPtr[i * 4 + 1] = HDRPixels[i].G;
-        FloatPtr[i * 4 + 2] = HDRPixels[i].B;
-        FloatPtr[i * 4 + 3] = 1.0f;
-    }
+        IImageWrapperModule& ImageWrapperModule = FModuleManager::GetModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+        TSharedPtr<IImageWrapper> ExrWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::EXR);
+        if (!ExrWrapper.IsValid())
+        {
+            UE_LOG(LogTemp, Error, TEXT("ComfyUI HDR: Failed to create EXR wrapper"));
+            return;
+        }
 
-    ExrWrapper->SetRaw(FloatPtr, FloatData.Num(), Width, Height, ERGBFormat::RGBAF, 32);
+        ExrWrapper->SetRaw(Image->Pixels.GetData(), Image->Pixels.Num() * sizeof(FLinearColor),
+            Image->Width, Image->Height, ERGBFormat::RGBAF, 32);
 
-    const TArray64<uint8>& CompressedEXR = ExrWrapper->GetCompressed();
-    if (CompressedEXR.Num() == 0)
-    {
-        UE_LOG(LogTemp, Error, TEXT("ComfyUI HDR: Failed to compress EXR"));
-        return FString();
-    }
+        const TArray64<uint8>& CompressedEXR = ExrWrapper->GetCompressed();
+        if (CompressedEXR.Num() == 0)
+        {
+            UE_LOG(LogTemp, Error, TEXT("ComfyUI HDR: Failed to compress EXR"));
+            return;
+        }
 
-    if (!FFileHelper::SaveArrayToFile(CompressedEXR, *HdrPath))
-    {
-        UE_LOG(LogTemp, Error, TEXT("ComfyUI HDR: Failed to save EXR to: %s"), *HdrPath);
-        return FString();
-    }
+        if (!FFileHelper::SaveArrayToFile(CompressedEXR, *HdrPath))
+        {
+            UE_LOG(LogTemp, Error, TEXT("ComfyUI HDR: Failed to save EXR to: %s"), *HdrPath);
+            return;
+        }
 
-    UE_LOG(LogTemp, Warning, TEXT("ComfyUI HDR: Written EXR to: %s"), *HdrPath);
-    return HdrPath;
+        UE_LOG(LogTemp, Warning, TEXT("ComfyUI HDR: Written EXR to: %s"), *HdrPath);
+    });
 }
 
-
-UTextureCube* SComfyUIPanel::ImportHDRToProject(const FString& HdrFilePath, const FString& AssetName)
+UTextureCube* SComfyUIPanel::ImportHDRToProject(const FComfyUIHDRTextureSource& Source, const FString& AssetName)
 {
 #if WITH_EDITOR
+    const uint8* SourceData = Source.GetData();
+    if (!SourceData)
+    {
+        UE_LOG(LogTemp, Error, TEXT("ComfyUI HDR: No HDR pixels to import"));
+        return nullptr;
+    }
+
     FString Timestamp = FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S"));
     FString AssetPath = UComfyUIBlueprintLibrary::GenerateUniqueAssetName(
         TEXT("/Game/GeneratedTextures/HDRI"), AssetName + TEXT("_") + Timestamp);
@@ -1345,33 +1532,6 @@ UTextureCube* SComfyUIPanel::ImportHDRToProject(const FString& HdrFilePath, cons
         return nullptr;
     }
 
-    // Read the EXR file
-    TArray<uint8> HdrData;
-    if (!FFileHelper::LoadFileToArray(HdrData, *HdrFilePath))
-    {
-        UE_LOG(LogTemp, Error, TEXT("ComfyUI HDR: Failed to read EXR: %s"), *HdrFilePath);
-        return nullptr;
-    }
-
-    // Decode EXR to raw float pixels
-    IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
-    TSharedPtr<IImageWrapper> ExrWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::EXR);
-    if (!ExrWrapper.IsValid() || !ExrWrapper->SetCompressed(HdrData.GetData(), HdrData.Num()))
-    {
-        UE_LOG(LogTemp, Error, TEXT("ComfyUI HDR: Failed to decode EXR"));
-        return nullptr;
-    }
-
-    TArray64<uint8> RawData;
-    if (!ExrWrapper->GetRaw(ERGBFormat::RGBAF, 32, RawData))
-    {
-        UE_LOG(LogTemp, Error, TEXT("ComfyUI HDR: Failed to get raw float data from EXR"));
-        return nullptr;
-    }
-
-    const int32 W = ExrWrapper->GetWidth();
-    const int32 H = ExrWrapper->GetHeight();
-
     // Create UTextureCube asset
     UTextureCube* Texture = NewObject<UTextureCube>(Package, *AssetNameClean, RF_Public | RF_Standalone);
     if (!Texture)
@@ -1380,11 +1540,11 @@ UTextureCube* SComfyUIPanel::ImportHDRToProject(const FString& HdrFilePath, cons
         return nullptr;
     }
 
-    // Initialize source as equirectangular longlat — UE will treat it as a cubemap
-    Texture->Source.Init(W, H, 1, 1, TSF_RGBA32F, RawData.GetData());
+    // The pixels were converted, packed and baked on a worker; this is the one copy left
+    Texture->Source.Init(Source.SizeX, Source.SizeY, Source.NumSlices, Source.NumMips, Source.Format, SourceData);
+    Texture->MipGenSettings = Source.MipGenSettings;
     Texture->CompressionSettings = TC_HDR;
     Texture->SRGB = false;
-    Texture->MipGenSettings = TMGS_NoMipmaps;
     Texture->LODGroup = TEXTUREGROUP_Skybox;
 
     Texture->UpdateResource();
@@ -1512,18 +1672,13 @@ void SComfyUIPanel::ApplyTextureToComposurePlates(UTexture2D* Texture)
 
 void SComfyUIPanel::PollComfyConnection()
 {
-    const UComfyUISettings* Settings = GetDefault<UComfyUISettings>();
-    FString BaseUrl = Settings ? Settings->BaseUrl : TEXT("http://127.0.0.1:8188");
-
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-    Request->SetURL(BaseUrl + TEXT("/system_stats"));
-    Request->SetVerb(TEXT("GET"));
-    Request->SetTimeout(5.0f);
+    TSharedPtr<FComfyUIClient> Client = GetComfyClient();
+    if (!Client.IsValid()) return;
 
-    Request->OnProcessRequestComplete().BindLambda(
-        [this](FHttpRequestPtr, FHttpResponsePtr Response, bool bSucceeded)
+    Client->GetSystemStats(
+        [this](bool bSucceeded, const FString&)
         {
-            if (bSucceeded && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+            if (bSucceeded)
             {
                 bIsComfyReady = true;
                 UpdateStatus(TEXT("Connected: ComfyUI is Ready"));
@@ -1541,9 +1696,8 @@ void SComfyUIPanel::PollComfyConnection()
                     FTimerDelegate::CreateRaw(this, &SComfyUIPanel::PollComfyConnection),
                     5.0f, false);
             }
-        });
-
-    Request->ProcessRequest();
+        },
+        5.0f);
 }
 
 // ============================================================================
@@ -1552,111 +1706,221 @@ void SComfyUIPanel::PollComfyConnection()
 
 void SComfyUIPanel::UploadImageToComfyUI(const FString& LocalFilePath, TFunction<void(bool, const FString&)> OnComplete)
 {
-    TArray<uint8> FileData;
-    if (!FFileHelper::LoadFileToArray(FileData, *LocalFilePath))
+    TSharedPtr<FComfyUIClient> Client = GetComfyClient();
+    if (!Client.IsValid())
     {
-        UE_LOG(LogTemp, Error, TEXT("ComfyUI: Failed to read file for upload: %s"), *LocalFilePath);
         OnComplete(false, TEXT(""));
         return;
     }
 
-    const UComfyUISettings* Settings = GetDefault<UComfyUISettings>();
-    FString BaseUrl = Settings ? Settings->BaseUrl : TEXT("http://127.0.0.1:8188");
-    FString Filename = FPaths::GetCleanFilename(LocalFilePath);
+    TWeakPtr<SComfyUIPanel> CapturedWeakThis = WeakThis;
+    Client->UploadImage(LocalFilePath,
+        [CapturedWeakThis, LocalFilePath, OnComplete](bool bSucceeded, const FString& StoredFilename)
+        {
+            if (bSucceeded)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("ComfyUI: Uploaded image as: %s"), *StoredFilename);
+                if (TSharedPtr<SComfyUIPanel> Panel = CapturedWeakThis.Pin())
+                    Panel->UploadedNames.Add(LocalFilePath, StoredFilename);
+            }
+            OnComplete(bSucceeded, StoredFilename);
+        });
+}
+
+bool SComfyUIPanel::IsDefaultServerOutput(const FString& Path) const
+{
+    return FPaths::IsSamePath(FPaths::GetPath(Path), GetLocalTempFolder());
+}
+
+FString SComfyUIPanel::GetNodeImageValue(const FString& SourcePath) const
+{
+    if (IsDefaultServerOutput(SourcePath))
+        return FPaths::GetCleanFilename(SourcePath) + TEXT(" [output]");
+
+    // Content the server already had may be stored under an earlier upload's name
+    if (const FString* StoredFilename = UploadedNames.Find(SourcePath))
+        return *StoredFilename;
+    return FPaths::GetCleanFilename(SourcePath);
+}
+
+void SComfyUIPanel::DownloadOutputImages(const TSharedRef<FComfyUIClient>& Client, const TArray<FComfyUIOutputImage>& Images, bool bStreamToDisk,
+    TFunction<void(int64, int64)> OnProgress,
+    TFunction<void(const TArray<FString>&, TArray<FComfyUIDecodedImage>&)> OnComplete)
+{
+    if (Images.Num() == 0)
+    {
+        TArray<FComfyUIDecodedImage> NoImages;
+        OnComplete(TArray<FString>(), NoImages);
+        return;
+    }
+
+    // Workers decode through ImageWrapper, which must be loaded on the game thread
+    ComfyUIImage::PreloadImageWrapperModule();
+
+    // Every server numbers its outputs from the same prefixes, so other backends' results
+    // get their own subfolder instead of overwriting the Base URL server's
+    FString TempFolder = GetLocalTempFolder();
+    if (&Client.Get() != GetComfyClient().Get())
+        TempFolder = FPaths::Combine(TempFolder, FPaths::MakeValidFileName(Client->GetBaseUrl(), TEXT('_')));
 
-    // Build multipart/form-data body
-    FString Boundary = TEXT("----ComfyUIBoundary");
-    FString ContentType = FString::Printf(TEXT("multipart/form-data; boundary=%s"), *Boundary);
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    if (!PlatformFile.DirectoryExists(*TempFolder))
+        PlatformFile.CreateDirectoryTree(*TempFolder);
 
-    TArray<uint8> Body;
-    auto AppendStr = [&Body](const FString& Str)
+    struct FDownloadState
     {
-        FTCHARToUTF8 Converted(*Str);
-        Body.Append((const uint8*)Converted.Get(), Converted.Length());
+        TArray<FString> LocalPaths;
+        TArray<FComfyUIDecodedImage> Images;
+        TArray<int64> BytesReceived;
+        TArray<int64> TotalBytes;
+        int32 Remaining = 0;
+        TFunction<void(int64, int64)> OnProgress;
+        TFunction<void(const TArray<FString>&, TArray<FComfyUIDecodedImage>&)> OnComplete;
     };
+    TSharedRef<FDownloadState> State = MakeShared<FDownloadState>();
+    State->LocalPaths.SetNum(Images.Num());
+    State->Images.SetNum(Images.Num());
+    State->BytesReceived.SetNumZeroed(Images.Num());
+    State->TotalBytes.SetNumZeroed(Images.Num());
+    State->OnProgress = MoveTemp(OnProgress);
+    State->Remaining = Images.Num();
+    State->OnComplete = MoveTemp(OnComplete);
+
+    // Runs on the game thread once per image; compacts out failures when the last one lands
+    auto FinishOne = [State]()
+    {
+        if (--State->Remaining > 0)
+            return;
 
-    AppendStr(FString::Printf(TEXT("--%s\r\n"), *Boundary));
-    AppendStr(FString::Printf(TEXT("Content-Disposition: form-data; name=\"image\"; filename=\"%s\"\r\n"), *Filename));
-    AppendStr(TEXT("Content-Type: image/png\r\n\r\n"));
-    Body.Append(FileData);
-    AppendStr(FString::Printf(TEXT("\r\n--%s--\r\n"), *Boundary));
+        TArray<FString> Paths;
+        TArray<FComfyUIDecodedImage> Decoded;
+        for (int32 Index = 0; Index < State->LocalPaths.Num(); ++Index)
+        {
+            if (State->LocalPaths[Index].IsEmpty())
+                continue;
 
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-    Request->SetURL(BaseUrl + TEXT("/upload/image"));
-    Request->SetVerb(TEXT("POST"));
-    Request->SetHeader(TEXT("Content-Type"), ContentType);
-    Request->SetContent(Body);
+            Paths.Add(State->LocalPaths[Index]);
+            if (State->Images[Index].IsValid())
+                Decoded.Add(MoveTemp(State->Images[Index]));
+        }
+        State->OnComplete(Paths, Decoded);
+    };
 
-    Request->OnProcessRequestComplete().BindLambda(
-        [OnComplete, Filename](FHttpRequestPtr, FHttpResponsePtr Response, bool bSucceeded)
+    if (bStreamToDisk)
+    {
+        for (int32 Index = 0; Index < Images.Num(); ++Index)
         {
-            if (!bSucceeded || !Response.IsValid() || !EHttpResponseCodes::IsOk(Response->GetResponseCode()))
-            {
-                UE_LOG(LogTemp, Error, TEXT("ComfyUI: Upload failed"));
-                OnComplete(false, TEXT(""));
-                return;
-            }
+            const FComfyUIOutputImage& Image = Images[Index];
+            const FString LocalPath = FPaths::Combine(TempFolder, Image.Filename);
 
-            // Response contains the filename ComfyUI stored it as
-            TSharedPtr<FJsonObject> JsonResponse;
-            const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
-            FString StoredFilename = Filename;
-            if (FJsonSerializer::Deserialize(Reader, JsonResponse) && JsonResponse.IsValid())
-            {
-                FString Name;
-                if (JsonResponse->TryGetStringField(TEXT("name"), Name))
-                    StoredFilename = Name;
-            }
+            Client->DownloadView(Image.Filename, Image.Subfolder, Image.Type, LocalPath,
+                [State, FinishOne, Index](bool bSucceeded, const FString& FilePath)
+                {
+                    if (bSucceeded)
+                    {
+                        UE_LOG(LogTemp, Warning, TEXT("ComfyUI: Downloaded image to: %s"), *FilePath);
+                        State->LocalPaths[Index] = FilePath;
+                    }
+                    FinishOne();
+                },
+                [State, Index](int64 BytesReceived, int64 TotalBytes)
+                {
+                    State->BytesReceived[Index] = BytesReceived;
+                    State->TotalBytes[Index] = TotalBytes;
+                    if (State->OnProgress)
+                    {
+                        int64 Received = 0, Total = 0;
+                        for (int32 Other = 0; Other < State->BytesReceived.Num(); ++Other)
+                        {
+                            Received += State->BytesReceived[Other];
+                            Total += State->TotalBytes[Other];
+                        }
+                        State->OnProgress(Received, Total);
+                    }
+                });
+        }
+        return;
+    }
 
-            UE_LOG(LogTemp, Warning, TEXT("ComfyUI: Uploaded image as: %s"), *StoredFilename);
-            OnComplete(true, StoredFilename);
-        });
+    TWeakPtr<SComfyUIPanel> CapturedWeakThis = WeakThis;
+    for (int32 Index = 0; Index < Images.Num(); ++Index)
+    {
+        const FComfyUIOutputImage& Image = Images[Index];
+        const FString Filename = Image.Filename;
+        const FString LocalPath = FPaths::Combine(TempFolder, Filename);
 
-    Request->ProcessRequest();
-}
+        Client->GetView(Filename, Image.Subfolder, Image.Type,
+            [CapturedWeakThis, State, FinishOne, Index, Filename, LocalPath](bool bSucceeded, const TArray<uint8>& Content)
+            {
+                if (!bSucceeded)
+                {
+                    UE_LOG(LogTemp, Error, TEXT("ComfyUI: Download failed for: %s"), *Filename);
+                    FinishOne();
+                    return;
+                }
 
-void SComfyUIPanel::DownloadImageFromComfyUI(const FString& Filename, TFunction<void(bool, const FString&)> OnComplete)
-{
-    const UComfyUISettings* Settings = GetDefault<UComfyUISettings>();
-    FString BaseUrl = Settings ? Settings->BaseUrl : TEXT("http://127.0.0.1:8188");
+                // Preview straight from the response bytes; the temp file is only needed
+                // for import and HDRI conversion, so it is written on the side
+                TSharedRef<const TArray<uint8>, ESPMode::ThreadSafe> Bytes = MakeShared<const TArray<uint8>, ESPMode::ThreadSafe>(Content);
 
-    FString Url = BaseUrl + TEXT("/view?filename=") + Filename + TEXT("&type=output");
+                if (TSharedPtr<SComfyUIPanel> Panel = CapturedWeakThis.Pin())
+                    Panel->PendingWrites.FindOrAdd(LocalPath);
 
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-    Request->SetURL(Url);
-    Request->SetVerb(TEXT("GET"));
+                Async(EAsyncExecution::ThreadPool,
+                    [CapturedWeakThis, LocalPath, Bytes]()
+                    {
+                        const bool bSaved = FFileHelper::SaveArrayToFile(*Bytes, *LocalPath);
 
-    Request->OnProcessRequestComplete().BindLambda(
-        [OnComplete, Filename](FHttpRequestPtr, FHttpResponsePtr Response, bool bSucceeded)
-        {
-            if (!bSucceeded || !Response.IsValid() || !EHttpResponseCodes::IsOk(Response->GetResponseCode()))
-            {
-                UE_LOG(LogTemp, Error, TEXT("ComfyUI: Download failed for: %s"), *Filename);
-                OnComplete(false, TEXT(""));
-                return;
-            }
+                        AsyncTask(ENamedThreads::GameThread,
+                            [CapturedWeakThis, LocalPath, bSaved]()
+                            {
+                                if (!bSaved)
+                                    UE_LOG(LogTemp, Error, TEXT("ComfyUI: Failed to save downloaded image to: %s"), *LocalPath);
 
-            // Save to local temp folder
-            FString TempFolder = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ComfyUITemp"));
-            IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-            if (!PlatformFile.DirectoryExists(*TempFolder))
-                PlatformFile.CreateDirectoryTree(*TempFolder);
+                                TSharedPtr<SComfyUIPanel> Panel = CapturedWeakThis.Pin();
+                                TArray<TFunction<void(bool)>> Waiters;
+                                if (!Panel.IsValid() || !Panel->PendingWrites.RemoveAndCopyValue(LocalPath, Waiters))
+                                    return;
 
-            FString LocalPath = FPaths::Combine(TempFolder, Filename);
-            const TArray<uint8>& Content = Response->GetContent();
+                                for (TFunction<void(bool)>& Waiter : Waiters)
+                                    Waiter(bSaved);
+                            });
+                    });
 
-            if (!FFileHelper::SaveArrayToFile(Content, *LocalPath))
-            {
-                UE_LOG(LogTemp, Error, TEXT("ComfyUI: Failed to save downloaded image to: %s"), *LocalPath);
-                OnComplete(false, TEXT(""));
-                return;
-            }
+                Async(EAsyncExecution::ThreadPool,
+                    [State, FinishOne, Index, LocalPath, Bytes]()
+                    {
+                        FComfyUIDecodedImage Decoded;
+                        const bool bDecoded = ComfyUIImage::DecodeToBGRA(Bytes->GetData(), Bytes->Num(), Decoded);
 
-            UE_LOG(LogTemp, Warning, TEXT("ComfyUI: Downloaded image to: %s"), *LocalPath);
-            OnComplete(true, LocalPath);
-        });
+                        AsyncTask(ENamedThreads::GameThread,
+                            [State, FinishOne, Index, LocalPath, bDecoded, Decoded = MoveTemp(Decoded)]() mutable
+                            {
+                                if (!bDecoded)
+                                {
+                                    UE_LOG(LogTemp, Error, TEXT("ComfyUI: Failed to decode downloaded image: %s"), *LocalPath);
+                                }
+                                else
+                                {
+                                    UE_LOG(LogTemp, Warning, TEXT("ComfyUI: Downloaded image to: %s"), *LocalPath);
+                                    State->LocalPaths[Index] = LocalPath;
+                                    State->Images[Index] = MoveTemp(Decoded);
+                                }
+                                FinishOne();
+                            });
+                    });
+            });
+    }
+}
 
-    Request->ProcessRequest();
+void SComfyUIPanel::WhenFileWritten(const FString& FilePath, TFunction<void(bool)> OnWritten)
+{
+    if (TArray<TFunction<void(bool)>>* Waiters = PendingWrites.Find(FilePath))
+    {
+        Waiters->Add(MoveTemp(OnWritten));
+        return;
+    }
+    OnWritten(FPaths::FileExists(FilePath));
 }
 
 FString SComfyUIPanel::GetLocalTempFolder() const
@@ -1671,139 +1935,167 @@ FString SComfyUIPanel::GetLocalTempFolder() const
 
 
 
-void SComfyUIPanel::StartHistoryPoller(const FString& PromptId, const FComfyWorkflowParams& Params)
+void SComfyUIPanel::StartHistoryPoller(const FString& PromptId)
 {
-    PollingPromptId = PromptId;
+    FComfyJob* Job = Jobs.Find(PromptId);
+    if (!Job || Job->bPolling) return;
 
-    if (!GEditor) return;
+    Job->bPolling = true;
+    UE_LOG(LogTemp, Warning, TEXT("ComfyUI Poller: Started for prompt %s"), *PromptId);
 
-    FComfyWorkflowParams CapturedParams = Params;
-    TWeakPtr<SComfyUIPanel> CapturedWeakThis = WeakThis;
+    // One timer serves every job that needs the fallback
+    if (!GEditor || HistoryPollTimerHandle.IsValid()) return;
 
+    TWeakPtr<SComfyUIPanel> CapturedWeakThis = WeakThis;
     GEditor->GetTimerManager()->SetTimer(
-        PollingTimerHandle,
-        [CapturedWeakThis, PromptId, CapturedParams]()
+        HistoryPollTimerHandle,
+        [CapturedWeakThis]()
         {
-            TSharedPtr<SComfyUIPanel> Panel = CapturedWeakThis.Pin();
-            if (!Panel.IsValid()) return;
+            if (TSharedPtr<SComfyUIPanel> Panel = CapturedWeakThis.Pin())
+                Panel->PollHistoryForJobs();
+        },
+        5.0f,  // poll every 5 seconds
+        true   // looping
+    );
+}
 
-            // If WS already handled this, stop polling
-            if (Panel->PollingPromptId != PromptId)
-            {
-                Panel->StopHistoryPoller();
-                return;
-            }
+void SComfyUIPanel::StopHistoryPoller(const FString& PromptId)
+{
+    if (FComfyJob* Job = Jobs.Find(PromptId))
+    {
+        if (Job->bPolling)
+            UE_LOG(LogTemp, Warning, TEXT("ComfyUI Poller: Stopped for prompt %s"), *PromptId);
+        Job->bPolling = false;
+    }
 
-            const UComfyUISettings* Settings = GetDefault<UComfyUISettings>();
-            FString BaseUrl = Settings ? Settings->BaseUrl : TEXT("http://127.0.0.1:8188");
+    for (const TPair<FString, FComfyJob>& Pair : Jobs)
+    {
+        if (Pair.Value.bPolling)
+            return;
+    }
 
-            TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-            Request->SetURL(BaseUrl + TEXT("/history/") + PromptId);
-            Request->SetVerb(TEXT("GET"));
+    if (GEditor && HistoryPollTimerHandle.IsValid())
+        GEditor->GetTimerManager()->ClearTimer(HistoryPollTimerHandle);
+    HistoryPollTimerHandle.Invalidate();
+}
 
-            Request->OnProcessRequestComplete().BindLambda(
-                [CapturedWeakThis, PromptId, CapturedParams](FHttpRequestPtr, FHttpResponsePtr Response, bool bSucceeded)
-                {
-                    TSharedPtr<SComfyUIPanel> Panel = CapturedWeakThis.Pin();
-                    if (!Panel.IsValid()) return;
+void SComfyUIPanel::PollHistoryForJobs()
+{
+    // Each prompt's history only exists on the server it was queued on
+    TArray<TPair<FString, TSharedPtr<FComfyUIBackend>>> PollingJobs;
+    for (const TPair<FString, FComfyJob>& Pair : Jobs)
+    {
+        if (Pair.Value.bPolling && Pair.Value.Backend.IsValid())
+            PollingJobs.Emplace(Pair.Key, Pair.Value.Backend);
+    }
 
-                    // If WS already handled this prompt, bail
-                    if (Panel->PollingPromptId != PromptId) return;
+    TWeakPtr<SComfyUIPanel> CapturedWeakThis = WeakThis;
+    for (const TPair<FString, TSharedPtr<FComfyUIBackend>>& PollingJob : PollingJobs)
+    {
+        const FString& PromptId = PollingJob.Key;
+        TWeakPtr<FComfyUIWebSocketHandler> WeakSocket = PollingJob.Value->WebSocket;
+        PollingJob.Value->Client->GetHistory(PromptId,
+            [CapturedWeakThis, PromptId, WeakSocket](bool bSucceeded, const TSharedPtr<FJsonObject>& History)
+            {
+                TSharedPtr<SComfyUIPanel> Panel = CapturedWeakThis.Pin();
+                if (!Panel.IsValid()) return;
 
-                    if (!bSucceeded || !Response.IsValid()) return;
+                // If WS already handled this prompt, bail
+                const FComfyJob* Job = Panel->Jobs.Find(PromptId);
+                if (!Job || !Job->bPolling) return;
 
-                    TSharedPtr<FJsonObject> History;
-                    const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
-                    if (!FJsonSerializer::Deserialize(Reader, History) || !History.IsValid()) return;
+                // Not finished yet. Once the socket tracks the prompt again (it
+                // reconnected, or the watcher was registered late) it will report
+                // completion, so this check was the last one needed
+                auto KeepWaiting = [&Panel, &PromptId, &WeakSocket]()
+                    {
+                        TSharedPtr<FComfyUIWebSocketHandler> WSHandler = WeakSocket.Pin();
+                        if (WSHandler.IsValid() && WSHandler->IsTrackingPrompt(PromptId))
+                            Panel->StopHistoryPoller(PromptId);
+                    };
 
-                    // Check if our prompt has a completed entry
-                    const TSharedPtr<FJsonObject>* PromptHistory;
-                    if (!History->TryGetObjectField(PromptId, PromptHistory)) return;
+                if (!bSucceeded) { KeepWaiting(); return; }
 
-                    // Check for execution error
-                    const TSharedPtr<FJsonObject>* StatusObj;
-                    if ((*PromptHistory)->TryGetObjectField(TEXT("status"), StatusObj))
+                // Check if our prompt has a completed entry
+                const TSharedPtr<FJsonObject>* PromptHistory;
+                if (!History->TryGetObjectField(PromptId, PromptHistory)) { KeepWaiting(); return; }
+
+                // Check for execution error
+                const TSharedPtr<FJsonObject>* StatusObj;
+                if ((*PromptHistory)->TryGetObjectField(TEXT("status"), StatusObj))
+                {
+                    FString StatusStr;
+                    if ((*StatusObj)->TryGetStringField(TEXT("status_str"), StatusStr))
                     {
-                        FString StatusStr;
-                        if ((*StatusObj)->TryGetStringField(TEXT("status_str"), StatusStr))
+                        if (StatusStr == TEXT("error"))
                         {
-                            if (StatusStr == TEXT("error"))
-                            {
-                                UE_LOG(LogTemp, Error, TEXT("ComfyUI Poller: Prompt %s errored"), *PromptId);
-                                Panel->StopHistoryPoller();
-                                Panel->OnWorkflowComplete(false, PromptId, CapturedParams);
-                                return;
-                            }
-                            // Not finished yet
-                            if (StatusStr != TEXT("success"))
-                                return;
+                            UE_LOG(LogTemp, Error, TEXT("ComfyUI Poller: Prompt %s errored"), *PromptId);
+                            Panel->OnWorkflowComplete(false, PromptId);
+                            return;
                         }
+                        // Not finished yet
+                        if (StatusStr != TEXT("success")) { KeepWaiting(); return; }
                     }
+                }
 
-                    // Check outputs exist
-                    const TSharedPtr<FJsonObject>* Outputs;
-                    if (!(*PromptHistory)->TryGetObjectField(TEXT("outputs"), Outputs)) return;
-                    if ((*Outputs)->Values.Num() == 0) return;
-
-                    // Looks complete — hand off to OnWorkflowComplete
-                    UE_LOG(LogTemp, Warning, TEXT("ComfyUI Poller: Detected completion for prompt %s (WS fallback)"), *PromptId);
-                    Panel->StopHistoryPoller();
-                    Panel->OnWorkflowComplete(true, PromptId, CapturedParams);
-                });
-
-            Request->ProcessRequest();
-        },
-        5.0f,  // poll every 5 seconds
-        true   // looping
-    );
+                // Check outputs exist
+                const TSharedPtr<FJsonObject>* Outputs;
+                if (!(*PromptHistory)->TryGetObjectField(TEXT("outputs"), Outputs)) { KeepWaiting(); return; }
+                if ((*Outputs)->Values.Num() == 0) { KeepWaiting(); return; }
 
-    UE_LOG(LogTemp, Warning, TEXT("ComfyUI Poller: Started for prompt %s"), *PromptId);
+                // Looks complete — hand off to OnWorkflowComplete
+                UE_LOG(LogTemp, Warning, TEXT("ComfyUI Poller: Detected completion for prompt %s (WS fallback)"), *PromptId);
+                Panel->OnWorkflowComplete(true, PromptId);
+            });
+    }
 }
 
-void SComfyUIPanel::StopHistoryPoller()
+// ============================================================================
+// Job table
+// ============================================================================
+
+void SComfyUIPanel::SetJobStatus(FComfyJob& Job, const FString& Status)
 {
-    if (GEditor && PollingTimerHandle.IsValid())
-    {
-        GEditor->GetTimerManager()->ClearTimer(PollingTimerHandle);
-        UE_LOG(LogTemp, Warning, TEXT("ComfyUI Poller: Stopped"));
-    }
-    PollingPromptId = TEXT("");
+    Job.Status = Status;
+    UE_LOG(LogTemp, Warning, TEXT("ComfyUI Panel: [%s] %s"), *Job.PromptId, *Status);
+    RefreshStatusFromJobs();
 }
-bool SComfyUIPanel::LoadWorkflowFromFile(const FString& RelativePath, TSharedPtr<FJsonObject>& OutWorkflow)
+
+void SComfyUIPanel::RefreshStatusFromJobs()
 {
-    FString WorkflowPath;
-    if (const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("ComfyUI")))
-        WorkflowPath = FPaths::Combine(Plugin->GetBaseDir(), RelativePath);
+    if (Jobs.Num() == 0)
+        return;
 
-    if (!FPaths::FileExists(WorkflowPath))
+    // Show the job the server is working on, otherwise the oldest one
+    const FComfyJob* Shown = nullptr;
+    for (const TPair<FString, FComfyJob>& Pair : Jobs)
     {
-        UE_LOG(LogTemp, Error, TEXT("ComfyUI: Workflow not found at: %s"), *WorkflowPath);
-        return false;
+        if (!Shown || Pair.Value.State > Shown->State)
+            Shown = &Pair.Value;
     }
 
-    FString WorkflowJson;
-    if (!FFileHelper::LoadFileToString(WorkflowJson, *WorkflowPath))
-    {
-        UE_LOG(LogTemp, Error, TEXT("ComfyUI: Failed to read workflow: %s"), *WorkflowPath);
-        return false;
-    }
+    StatusText = Jobs.Num() > 1
+        ? FString::Printf(TEXT("%s [+%d more queued]"), *Shown->Status, Jobs.Num() - 1)
+        : Shown->Status;
+}
 
-    const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(WorkflowJson);
-    if (!FJsonSerializer::Deserialize(Reader, OutWorkflow) || !OutWorkflow.IsValid())
-    {
-        UE_LOG(LogTemp, Error, TEXT("ComfyUI: Failed to parse workflow: %s"), *WorkflowPath);
-        return false;
-    }
+void SComfyUIPanel::FinishJob(const FString& PromptId, const FString& FinalStatus)
+{
+    StopHistoryPoller(PromptId);
+    Jobs.Remove(PromptId);
 
-    return true;
+    // The final message stays up until another job has something to report
+    UpdateStatus(Jobs.Num() > 0
+        ? FString::Printf(TEXT("%s [+%d more queued]"), *FinalStatus, Jobs.Num())
+        : FinalStatus);
 }
 
-FString SComfyUIPanel::SerializeWorkflow(const TSharedPtr<FJsonObject>& WorkflowObj)
+TSharedPtr<const FComfyWorkflowTemplate> SComfyUIPanel::GetWorkflowTemplate(const FString& RelativePath, const TArray<FComfyTemplateSlot>& Slots)
 {
-    FString OutputString;
-    const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutputString);
-    FJsonSerializer::Serialize(WorkflowObj.ToSharedRef(), Writer);
-    return OutputString;
+    // Parsed and compiled once per file; the cache reloads it when the JSON is edited
+    FComfyUIEditorModule* EditorModule = FModuleManager::GetModulePtr<FComfyUIEditorModule>(TEXT("ComfyUIEditor"));
+    TSharedPtr<FComfyUIWorkflowCache> Cache = EditorModule ? EditorModule->GetWorkflowCache() : nullptr;
+    return Cache.IsValid() ? Cache->GetTemplate(RelativePath, Slots) : nullptr;
 }
 
 void SComfyUIPanel::UpdateStatus(const FString& Status)
@@ -1814,26 +2106,260 @@ void SComfyUIPanel::UpdateStatus(const FString& Status)
 
 void SComfyUIPanel::LoadAndDisplayImage(const FString& FilePath, bool bPreviewB)
 {
-    UTexture2D* Texture = UComfyUIBlueprintLibrary::LoadImageFromFile(FilePath);
-    if (!Texture) return;
+    LoadAndDisplayImages({ FilePath }, bPreviewB);
+}
+
+void SComfyUIPanel::LoadAndDisplayImages(const TArray<FString>& FilePaths, bool bPreviewB)
+{
+    if (FilePaths.Num() == 0)
+        return;
 
-    Texture->AddToRoot();
+    // Decoding runs on workers; a newer load or result for the slot supersedes this one
+    const uint32 Serial = ++(bPreviewB ? PreviewSerialB : PreviewSerialA);
+    TWeakPtr<SComfyUIPanel> CapturedWeakThis = WeakThis;
+
+    // Only touched on the game thread
+    struct FPendingDecodes
+    {
+        TArray<FComfyUIDecodedImage> Images;
+        int32 Remaining = 0;
+    };
+    TSharedRef<FPendingDecodes, ESPMode::ThreadSafe> Pending = MakeShared<FPendingDecodes, ESPMode::ThreadSafe>();
+    Pending->Images.SetNum(FilePaths.Num());
+    Pending->Remaining = FilePaths.Num();
+
+    for (int32 Index = 0; Index < FilePaths.Num(); ++Index)
+    {
+        ComfyUIImage::DecodeFileAsync(FilePaths[Index]).Then(
+            [CapturedWeakThis, FilePaths, bPreviewB, Serial, Pending, Index](TFuture<FComfyUIDecodedImage> Decoded)
+            {
+                AsyncTask(ENamedThreads::GameThread,
+                    [CapturedWeakThis, FilePaths, bPreviewB, Serial, Pending, Index, Image = Decoded.Consume()]() mutable
+                    {
+                        Pending->Images[Index] = MoveTemp(Image);
+                        if (--Pending->Remaining > 0)
+                            return;
+
+                        TSharedPtr<SComfyUIPanel> Panel = CapturedWeakThis.Pin();
+                        if (!Panel.IsValid() || Serial != (bPreviewB ? Panel->PreviewSerialB : Panel->PreviewSerialA))
+                            return;
+
+                        // Keep the files that decoded, in download order
+                        TArray<FString> Paths;
+                        TArray<FComfyUIDecodedImage> Images;
+                        for (int32 ImageIndex = 0; ImageIndex < FilePaths.Num(); ++ImageIndex)
+                        {
+                            if (!Pending->Images[ImageIndex].IsValid())
+                                continue;
+                            Paths.Add(FilePaths[ImageIndex]);
+                            Images.Add(MoveTemp(Pending->Images[ImageIndex]));
+                        }
+
+                        if (Images.Num() > 0)
+                            Panel->SetPreviewResults(bPreviewB, Paths, MoveTemp(Images));
+                    });
+            });
+    }
+}
+
+void SComfyUIPanel::SetPreviewResults(bool bPreviewB, const TArray<FString>& Paths, TArray<FComfyUIDecodedImage>&& Images)
+{
+    check(Paths.Num() == Images.Num());
+
+    // Release first so a same-sized result refills the texture already on screen
+    FComfyResultSet& Results = bPreviewB ? ResultsB : ResultsA;
+    ReleaseResults(Results);
+    ++(bPreviewB ? PreviewSerialB : PreviewSerialA);
+
+    for (int32 Index = 0; Index < Images.Num(); ++Index)
+    {
+        if (UTexture2D* Texture = TexturePool.Acquire(MoveTemp(Images[Index])))
+        {
+            Results.Paths.Add(Paths[Index]);
+            Results.Textures.Add(Texture);
+        }
+    }
+    ShowResult(bPreviewB, 0);
+}
+
+void SComfyUIPanel::ShowResult(bool bPreviewB, int32 Index)
+{
+    FComfyResultSet& Results = bPreviewB ? ResultsB : ResultsA;
+    if (Results.Textures.Num() == 0)
+        return;
+
+    Results.Shown = (Index % Results.Textures.Num() + Results.Textures.Num()) % Results.Textures.Num();
+    UTexture2D* Texture = Results.Textures[Results.Shown];
 
     TSharedPtr<FSlateBrush>& Brush = bPreviewB ? ImageBrushB : ImageBrushA;
     TSharedPtr<SImage>& Preview    = bPreviewB ? PreviewImageB : PreviewImageA;
+    (bPreviewB ? PreviewImagePathB : PreviewImagePathA) = Results.Paths[Results.Shown];
 
-    if (Brush.IsValid() && Brush->GetResourceObject())
-        if (UTexture2D* Old = Cast<UTexture2D>(Brush->GetResourceObject()))
-            Old->RemoveFromRoot();
-
-    Brush = MakeShared<FSlateBrush>();
+    if (!Brush.IsValid())
+    {
+        Brush = MakeShared<FSlateBrush>();
+        Brush->DrawAs = ESlateBrushDrawType::Image;
+        Brush->Tiling = ESlateBrushTileType::NoTile;
+    }
     Brush->SetResourceObject(Texture);
     Brush->ImageSize = FVector2D(Texture->GetSizeX(), Texture->GetSizeY());
-    Brush->DrawAs = ESlateBrushDrawType::Image;
-    Brush->Tiling = ESlateBrushTileType::NoTile;
 
     if (Preview.IsValid())
+    {
+        // The brush is reused, so SetImage alone may see no change
         Preview->SetImage(Brush.Get());
+        Preview->Invalidate(EInvalidateWidgetReason::Layout);
+    }
+}
+
+void SComfyUIPanel::ReleaseResults(FComfyResultSet& Results)
+{
+    for (UTexture2D* Texture : Results.Textures)
+    {
+        TexturePool.Release(Texture);
+    }
+    Results.Paths.Reset();
+    Results.Textures.Reset();
+    Results.Shown = 0;
+}
+
+TSharedRef<SWidget> SComfyUIPanel::BuildResultCycler(bool bPreviewB)
+{
+    const FComfyResultSet& Results = bPreviewB ? ResultsB : ResultsA;
+
+    return SNew(SHorizontalBox)
+        .Visibility_Lambda([&Results]() { return Results.Paths.Num() > 1 ? EVisibility::Visible : EVisibility::Collapsed; })
+        + SHorizontalBox::Slot().AutoWidth()
+        [
+            SNew(SButton)
+                .Text(LOCTEXT("PrevResultButton", "<"))
+                .OnClicked_Lambda([this, bPreviewB, &Results]() { ShowResult(bPreviewB, Results.Shown - 1); return FReply::Handled(); })
+        ]
+        + SHorizontalBox::Slot().AutoWidth().Padding(10, 0).VAlign(VAlign_Center)
+        [
+            SNew(STextBlock)
+                .Text_Lambda([&Results]() {
+                return FText::FromString(FString::Printf(TEXT("%d / %d"), Results.Shown + 1, Results.Paths.Num()));
+                    })
+        ]
+        + SHorizontalBox::Slot().AutoWidth()
+        [
+            SNew(SButton)
+                .Text(LOCTEXT("NextResultButton", ">"))
+                .OnClicked_Lambda([this, bPreviewB, &Results]() { ShowResult(bPreviewB, Results.Shown + 1); return FReply::Handled(); })
+        ];
+}
+
+void SComfyUIPanel::OnLivePreviewUpdated(const FString& PromptId, UTexture2D* Texture)
+{
+    // Frames without a prompt id come from the prompt the server is executing for our client
+    const FComfyJob* Job = nullptr;
+    if (PromptId.IsEmpty())
+    {
+        for (const TPair<FString, FComfyJob>& Pair : Jobs)
+        {
+            if (Pair.Value.State == EComfyJobState::Running)
+                Job = &Pair.Value;
+        }
+    }
+    else
+    {
+        Job = Jobs.Find(PromptId);
+    }
+
+    if (!Texture || !Job || !Job->Params.bUpdatePreview || Job->State == EComfyJobState::Fetching)
+        return;
+
+    if (!LivePreviewBrush.IsValid())
+    {
+        LivePreviewBrush = MakeShared<FSlateBrush>();
+        LivePreviewBrush->DrawAs = ESlateBrushDrawType::Image;
+        LivePreviewBrush->Tiling = ESlateBrushTileType::NoTile;
+    }
+
+    // The handler owns (and roots) the preview texture; the brush only points at it
+    LivePreviewBrush->SetResourceObject(Texture);
+    LivePreviewBrush->ImageSize = FVector2D(Texture->GetSizeX(), Texture->GetSizeY());
+    LivePreviewPromptId = Job->PromptId;
+
+    TSharedPtr<SImage>& Preview = Job->Params.bTargetPreviewB ? PreviewImageB : PreviewImageA;
+    if (Preview.IsValid())
+        Preview->SetImage(LivePreviewBrush.Get());
+}
+
+void SComfyUIPanel::OnPromptProgress(const FString& PromptId, const FString& NodeId, int32 Value, int32 Max)
+{
+    FComfyJob* Job = Jobs.Find(PromptId);
+    if (!Job || Job->State == EComfyJobState::Fetching || Max <= 0)
+        return;
+
+    Job->State = EComfyJobState::Running;
+
+    // Skip SetJobStatus: it logs, and progress arrives once per sampler step
+    Job->Status = FString::Printf(TEXT("%s (step %d/%d)"), *Job->Params.RunningStatus, Value, Max);
+    RefreshStatusFromJobs();
+}
+
+void SComfyUIPanel::OnPromptNodeExecuting(const FString& PromptId, const FString& NodeId)
+{
+    FComfyJob* Job = Jobs.Find(PromptId);
+    if (!Job || Job->State != EComfyJobState::Queued)
+        return;
+
+    Job->State = EComfyJobState::Running;
+    SetJobStatus(*Job, Job->Params.RunningStatus);
+}
+
+void SComfyUIPanel::SubscribeToSocket(const TSharedRef<FComfyUIWebSocketHandler>& Socket)
+{
+    for (const TWeakPtr<FComfyUIWebSocketHandler>& Subscribed : SubscribedSockets)
+    {
+        if (Subscribed.Pin() == Socket)
+            return;
+    }
+
+    // Preview, progress and node events carry the prompt id, so they need no routing.
+    // Queue length and disconnects are per server and only concern that server's jobs
+    TWeakPtr<FComfyUIWebSocketHandler> WeakSocket = Socket;
+    SubscribedSockets.Add(WeakSocket);
+    Socket->OnPreviewUpdated.AddSP(this, &SComfyUIPanel::OnLivePreviewUpdated);
+    Socket->OnProgress.AddSP(this, &SComfyUIPanel::OnPromptProgress);
+    Socket->OnNodeExecuting.AddSP(this, &SComfyUIPanel::OnPromptNodeExecuting);
+    Socket->OnQueueStatus.AddSP(this, &SComfyUIPanel::OnQueueStatus, WeakSocket);
+    Socket->OnDisconnectedEvent.AddSP(this, &SComfyUIPanel::OnWebSocketDisconnected, WeakSocket);
+}
+
+bool SComfyUIPanel::IsJobOnSocket(const FComfyJob& Job, const TWeakPtr<FComfyUIWebSocketHandler>& Socket)
+{
+    return Job.Backend.IsValid() && &Job.Backend->WebSocket.Get() == Socket.Pin().Get();
+}
+
+void SComfyUIPanel::OnQueueStatus(int32 QueueRemaining, TWeakPtr<FComfyUIWebSocketHandler> Socket)
+{
+    // Once a job runs its step counter is more useful than the queue length
+    for (TPair<FString, FComfyJob>& Pair : Jobs)
+    {
+        if (Pair.Value.State == EComfyJobState::Queued && QueueRemaining > 1 && IsJobOnSocket(Pair.Value, Socket))
+            Pair.Value.Status = FString::Printf(TEXT("Waiting in queue (%d jobs on server)"), QueueRemaining);
+    }
+    RefreshStatusFromJobs();
+}
+
+void SComfyUIPanel::OnWebSocketDisconnected(TWeakPtr<FComfyUIWebSocketHandler> Socket)
+{
+    // Completion can no longer arrive over the socket, fall back to polling /history
+    TArray<FString> PendingIds;
+    for (const TPair<FString, FComfyJob>& Pair : Jobs)
+    {
+        if (Pair.Value.State != EComfyJobState::Fetching && !Pair.Value.bPolling && IsJobOnSocket(Pair.Value, Socket))
+            PendingIds.Add(Pair.Key);
+    }
+
+    for (const FString& PromptId : PendingIds)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ComfyUI: WebSocket dropped, polling /history for prompt %s"), *PromptId);
+        StartHistoryPoller(PromptId);
+    }
 }
 
 void SComfyUIPanel::OnModelFamilyChanged(TSharedPtr<FString> NewSelection, ESelectInfo::Type)
@@ -1860,16 +2386,21 @@ SComfyUIPanel::~SComfyUIPanel()
     if (GEditor && ConnectionTimerHandle.IsValid())
         GEditor->GetTimerManager()->ClearTimer(ConnectionTimerHandle);
 
-    if (GEditor && PollingTimerHandle.IsValid())         
-        GEditor->GetTimerManager()->ClearTimer(PollingTimerHandle);
+    if (GEditor && HistoryPollTimerHandle.IsValid())
+        GEditor->GetTimerManager()->ClearTimer(HistoryPollTimerHandle);
+
+    for (const TWeakPtr<FComfyUIWebSocketHandler>& Subscribed : SubscribedSockets)
+    {
+        if (TSharedPtr<FComfyUIWebSocketHandler> WSHandler = Subscribed.Pin())
+        {
+            WSHandler->OnPreviewUpdated.RemoveAll(this);
+            WSHandler->OnProgress.RemoveAll(this);
+            WSHandler->OnNodeExecuting.RemoveAll(this);
+            WSHandler->OnQueueStatus.RemoveAll(this);
+            WSHandler->OnDisconnectedEvent.RemoveAll(this);
+        }
+    }
 
-    auto CleanBrush = [](TSharedPtr<FSlateBrush>& Brush) {
-        if (Brush.IsValid() && Brush->GetResourceObject())
-            if (UTexture2D* T = Cast<UTexture2D>(Brush->GetResourceObject()))
-                T->RemoveFromRoot();
-    };
-    CleanBrush(ImageBrushA);
-    CleanBrush(ImageBrushB);
 }
 
 #undef LOCTEXT_NAMESPACE
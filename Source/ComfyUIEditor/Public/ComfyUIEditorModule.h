@@ -3,6 +3,8 @@
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
 
+class FComfyUIWorkflowCache;
+
 class FComfyUIEditorModule : public IModuleInterface
 {
 public:
@@ -11,7 +13,12 @@ public:
 
     static const FName ComfyUITabName;
 
+    /** Parsed workflows from the plugin's workflows/ directory, reloaded when the files change */
+    TSharedPtr<FComfyUIWorkflowCache> GetWorkflowCache() const { return WorkflowCache; }
+
 private:
     void RegisterMenus();
     TSharedRef<SDockTab> SpawnComfyUITab(const FSpawnTabArgs& Args);
+
+    TSharedPtr<FComfyUIWorkflowCache> WorkflowCache;
 };
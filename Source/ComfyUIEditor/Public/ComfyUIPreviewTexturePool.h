@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+#include "PixelFormat.h"
+
+class UTexture2D;
+struct FComfyUIDecodedImage;
+
+/**
+ * Transient preview textures keyed by size and pixel format.
+ *
+ * Acquire refills a released texture of matching size in place with
+ * UpdateTextureRegions, so iterating on one resolution keeps reusing the same
+ * GPU resource instead of creating a texture per result. The pool keeps its
+ * textures alive through FGCObject; callers don't root them. The textures keep
+ * no CPU copy of their pixels, so callers must never UpdateResource them.
+ * Game thread only.
+ */
+class FComfyUIPreviewTexturePool : public FGCObject
+{
+public:
+    /** Returns a texture showing Image, reusing a released one when the size matches. Null if Image is invalid. */
+    UTexture2D* Acquire(FComfyUIDecodedImage&& Image);
+
+    /** Hands Texture back for reuse. It may be refilled by the next Acquire of the same size. */
+    void Release(UTexture2D* Texture);
+
+    // FGCObject
+    virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+    virtual FString GetReferencerName() const override { return TEXT("FComfyUIPreviewTexturePool"); }
+
+private:
+    struct FPoolKey
+    {
+        int32 Width = 0;
+        int32 Height = 0;
+        EPixelFormat Format = PF_Unknown;
+
+        bool operator==(const FPoolKey& Other) const
+        {
+            return Width == Other.Width && Height == Other.Height && Format == Other.Format;
+        }
+    };
+
+    static FPoolKey MakeKey(const UTexture2D* Texture);
+
+    TArray<TObjectPtr<UTexture2D>> Acquired;
+
+    /** Released textures, oldest first, so the cap drops the least recently used */
+    TArray<TObjectPtr<UTexture2D>> Released;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+#include "ComfyUIWorkflowTemplate.h"
+
+struct FFileChangeData;
+
+/**
+ * Parsed workflows from the plugin's workflows/ directory, keyed by path.
+ *
+ * Each file is read and parsed once. An IDirectoryWatcher on the directory drops
+ * entries whose file changed, so edits to the JSON take effect on the next request
+ * without touching the disk on every click. Game thread only.
+ */
+class FComfyUIWorkflowCache
+{
+public:
+    FComfyUIWorkflowCache();
+    ~FComfyUIWorkflowCache();
+
+    /** Deep copy of the workflow at RelativePath (relative to the plugin dir), safe to patch */
+    bool GetWorkflowCopy(const FString& RelativePath, TSharedPtr<FJsonObject>& OutWorkflow);
+
+    /**
+     * Template compiled from the workflow with Slots. Shared and immutable; it is
+     * compiled on first use and recompiled after the file changes.
+     */
+    TSharedPtr<const FComfyWorkflowTemplate> GetTemplate(const FString& RelativePath, const TArray<FComfyTemplateSlot>& Slots);
+
+    void InvalidateAll();
+
+private:
+    struct FEntry
+    {
+        TSharedPtr<const FJsonObject> Workflow;
+        TArray<TPair<TArray<FComfyTemplateSlot>, TSharedPtr<const FComfyWorkflowTemplate>>> Templates;
+    };
+
+    FEntry* FindOrLoad(const FString& RelativePath);
+    FString MakeKey(const FString& Path) const;
+    void OnDirectoryChanged(const TArray<FFileChangeData>& Changes);
+
+    FString PluginDir;
+    FString WorkflowDir;
+    FDelegateHandle WatcherHandle;
+    TMap<FString, FEntry> Entries;
+};
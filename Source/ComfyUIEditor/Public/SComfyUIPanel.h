@@ -5,6 +5,13 @@
 #include "Widgets/DeclarativeSyntaxSupport.h"
 #include "Widgets/Layout/SWidgetSwitcher.h"
 #include "ComfyUIRequestTypes.h"
+#include "ComfyUIWorkflowTemplate.h"
+#include "ComfyUIImageUtils.h"
+#include "ComfyUIHDRUtils.h"
+#include "ComfyUIPreviewTexturePool.h"
+#include "ComfyUIBackendPool.h"
+
+struct FComfyUIHDRTextureSource;
 
 // ============================================================================
 // FComfyWorkflowParams
@@ -19,6 +26,38 @@ struct FComfyWorkflowParams
     bool bAutoImport = false;
     bool bConvertToHDRI = false;
     bool bTargetPreviewB = false;
+    bool bStreamDownload = false;   // stream results to disk instead of buffering them (large panoramas)
+    bool bUsesServerInputs = false; // reads uploads or earlier outputs, so it must run on the Base URL server
+};
+
+// ============================================================================
+// FComfyJob — one prompt the panel has submitted and not yet finished with
+// ============================================================================
+enum class EComfyJobState : uint8
+{
+    Queued,     // accepted by /prompt, waiting in the server queue
+    Running,    // the server has started executing it
+    Fetching    // finished, result is being downloaded and imported
+};
+
+struct FComfyJob
+{
+    FString PromptId;
+    FComfyWorkflowParams Params;
+    EComfyJobState State = EComfyJobState::Queued;
+    FString Status;
+    bool bPolling = false;  // /history fallback active while the socket can't report it
+    TSharedPtr<FComfyUIBackend> Backend;    // server the prompt was queued on
+};
+
+// ============================================================================
+// FComfyResultSet — every image a job produced for one preview slot
+// ============================================================================
+struct FComfyResultSet
+{
+    TArray<FString> Paths;
+    TArray<UTexture2D*> Textures;   // from the panel's texture pool, parallel to Paths
+    int32 Shown = 0;
 };
 
 // ============================================================================
@@ -75,11 +114,32 @@ private:
     TSharedPtr<class SImage> PreviewImageA;
     TSharedPtr<FSlateBrush> ImageBrushA;
     FString PreviewImagePathA;
+    FComfyResultSet ResultsA;
 
     // Preview B
     TSharedPtr<class SImage> PreviewImageB;
     TSharedPtr<FSlateBrush> ImageBrushB;
     FString PreviewImagePathB;
+    FComfyResultSet ResultsB;
+
+    // Result textures for both slots; same-sized results reuse the texture in place
+    FComfyUIPreviewTexturePool TexturePool;
+
+    // Bumped whenever a slot's image changes, so stale async loads are dropped
+    uint32 PreviewSerialA = 0;
+    uint32 PreviewSerialB = 0;
+
+    // Downloaded results whose temp file is still being written, with callbacks waiting on it
+    TMap<FString, TArray<TFunction<void(bool)>>> PendingWrites;
+
+    // Local file -> name the server stored it under, for files uploaded from this panel
+    TMap<FString, FString> UploadedNames;
+
+    // Live sampler preview streamed over the WebSocket into the target slot
+    TSharedPtr<FSlateBrush> LivePreviewBrush;
+
+    // Sockets whose preview and execution events the panel listens to, one per server it has used
+    TArray<TWeakPtr<FComfyUIWebSocketHandler>> SubscribedSockets;
 
     TWeakPtr<SComfyUIPanel> WeakThis;
 
@@ -96,8 +156,12 @@ private:
     int32 CustomWidth = 1024;
     int32 CustomHeight = 1024;
 
-    // Generation state
-    FString CurrentPromptId;
+    // Images per generation, sampled together from one latent batch
+    int32 BatchSize = 1;
+
+    // Generation state: every in-flight prompt, keyed by prompt_id
+    TMap<FString, FComfyJob> Jobs;
+    FString LivePreviewPromptId;
     FString CurrentFilenamePrefix = TEXT("UE_Editor");
 
     // Img2Img
@@ -105,8 +169,7 @@ private:
 
     // Timers
     FTimerHandle ConnectionTimerHandle;
-    FTimerHandle PollingTimerHandle;
-    FString PollingPromptId;
+    FTimerHandle HistoryPollTimerHandle;
 
     // Composure
     FString LastImportedImagePath;
@@ -133,15 +196,23 @@ private:
     // -------------------------------------------------------------------------
     // HDR
     // -------------------------------------------------------------------------
-    FString ConvertImageToHDR(const FString& SourceImagePath);
-    UTextureCube* ImportHDRToProject(const FString& HdrFilePath, const FString& AssetName);
+    /**
+     * Reads, decodes and expands SourceImagePath to HDR and bakes its cube faces on the
+     * thread pool, then imports the cubemap and applies it to the HDRI Backdrop
+     */
+    void ConvertAndImportHDRAsync(const FString& SourceImagePath, const FString& AssetName);
+    void WriteHDRExrAsync(const TSharedRef<FComfyUIHDRImage, ESPMode::ThreadSafe>& Image, const FString& SourceImagePath);
+    UTextureCube* ImportHDRToProject(const FComfyUIHDRTextureSource& Source, const FString& AssetName);
     void ApplyTextureToHDRIBackdrop(UTextureCube* Texture);
 
     // -------------------------------------------------------------------------
     // Workflow system
     // -------------------------------------------------------------------------
     void SubmitWorkflow(const FComfyWorkflowParams& Params);
-    void OnWorkflowComplete(bool bSuccess, const FString& PromptId, FComfyWorkflowParams Params);
+    void OnWorkflowComplete(bool bSuccess, const FString& PromptId);
+    void SetJobStatus(FComfyJob& Job, const FString& Status);
+    void RefreshStatusFromJobs();
+    void FinishJob(const FString& PromptId, const FString& FinalStatus);
 
     void StartGeneration();
     void StartImg2Img();
@@ -169,15 +240,59 @@ private:
     // Helpers
     // -------------------------------------------------------------------------
     void PollComfyConnection();
-    void StartHistoryPoller(const FString& PromptId, const FComfyWorkflowParams& Params);
-    void StopHistoryPoller();
+    void StartHistoryPoller(const FString& PromptId);
+    void StopHistoryPoller(const FString& PromptId);
+    void PollHistoryForJobs();
     void UpdateStatus(const FString& Status);
     void LoadAndDisplayImage(const FString& FilePath, bool bPreviewB);
+
+    /** Decodes every file on workers and shows them together in the slot's result cycler */
+    void LoadAndDisplayImages(const TArray<FString>& FilePaths, bool bPreviewB);
+    void SetPreviewResults(bool bPreviewB, const TArray<FString>& Paths, TArray<FComfyUIDecodedImage>&& Images);
+    void ShowResult(bool bPreviewB, int32 Index);
+    void ReleaseResults(FComfyResultSet& Results);
+    TSharedRef<SWidget> BuildResultCycler(bool bPreviewB);
+    void OnLivePreviewUpdated(const FString& PromptId, UTexture2D* Texture);
+    void OnPromptProgress(const FString& PromptId, const FString& NodeId, int32 Value, int32 Max);
+    void OnPromptNodeExecuting(const FString& PromptId, const FString& NodeId);
+    void OnQueueStatus(int32 QueueRemaining, TWeakPtr<FComfyUIWebSocketHandler> Socket);
+    void OnWebSocketDisconnected(TWeakPtr<FComfyUIWebSocketHandler> Socket);
+    void SubscribeToSocket(const TSharedRef<FComfyUIWebSocketHandler>& Socket);
+
+    /** Whether Job runs on Socket's server */
+    static bool IsJobOnSocket(const FComfyJob& Job, const TWeakPtr<FComfyUIWebSocketHandler>& Socket);
+
     void ImportImageToProject(const FString& ImagePath, const FString& AssetNamePrefix);
+
+    /** Imports several images in one batch; decoding happens off the game thread */
+    void ImportImagesToProject(const TArray<FString>& ImagePaths, const FString& AssetNamePrefix);
     void ApplyTextureToComposurePlates(UTexture2D* Texture);
     void UploadImageToComfyUI(const FString& LocalFilePath, TFunction<void(bool, const FString&)> OnComplete);
-    void DownloadImageFromComfyUI(const FString& Filename, TFunction<void(bool, const FString&)> OnComplete);
+
+    /** Value for a LoadImage node's image input that refers to SourcePath on the server */
+    FString GetNodeImageValue(const FString& SourcePath) const;
+
+    /**
+     * Whether Path is a result downloaded from the Base URL server, which workflows can read
+     * back as "[output]". Results from other backends are kept in per-server subfolders.
+     */
+    bool IsDefaultServerOutput(const FString& Path) const;
+
+    /**
+     * Downloads every image concurrently from Client's server and decodes the response bytes on worker threads.
+     * OnComplete runs on the game thread with the images that made it, in order. The temp
+     * files are written alongside decoding and may still be pending; use WhenFileWritten
+     * before reading them back.
+     *
+     * With bStreamToDisk the responses go straight to the temp files instead and Images is
+     * left empty, keeping the working set bounded for large panoramas; decode from LocalPaths
+     * if a preview is needed. OnProgress then reports bytes received across all images.
+     */
+    void DownloadOutputImages(const TSharedRef<FComfyUIClient>& Client, const TArray<FComfyUIOutputImage>& Images, bool bStreamToDisk,
+        TFunction<void(int64 /*BytesReceived*/, int64 /*TotalBytes*/)> OnProgress,
+        TFunction<void(const TArray<FString>& /*LocalPaths*/, TArray<FComfyUIDecodedImage>& /*Images*/)> OnComplete);
+    /** Runs OnWritten on the game thread once FilePath is on disk; immediately if it is not a pending download */
+    void WhenFileWritten(const FString& FilePath, TFunction<void(bool /*bWritten*/)> OnWritten);
     FString GetLocalTempFolder() const;
-    bool LoadWorkflowFromFile(const FString& RelativePath, TSharedPtr<FJsonObject>& OutWorkflow);
-    FString SerializeWorkflow(const TSharedPtr<FJsonObject>& WorkflowObj);
+    TSharedPtr<const FComfyWorkflowTemplate> GetWorkflowTemplate(const FString& RelativePath, const TArray<FComfyTemplateSlot>& Slots);
 };
\ No newline at end of file